@@ -1,31 +1,148 @@
 #ifndef SYMTABLESTUB_H
 #define SYMTABLESTUB_H
 
-#include <map>
+#include <vector>
 #include <string>
 #include <iostream>
+#include <unordered_map>
 #include "value.h"
+#include "output.h"
 
-class FuncDefNode;
+class func_def_node;
+class class_def_node;
 
+//semnalul de terminare al instructiunilor, tinut separat de valoarea calculata
+enum Completion {
+    COMPLETION_NORMAL,
+    COMPLETION_RETURN,
+    COMPLETION_ABORT   //eroare la executie: programul se opreste, nimic nu se mai afiseaza
+};
+
+//cate apeluri de functii pot fi active simultan (recursivitate); la fel in toate modurile de executie
+const int MAX_CALL_DEPTH = 1000;
+
+inline void reportCallDepth(const std::string& function) {
+    runtimeError("maximum call depth (" + std::to_string(MAX_CALL_DEPTH) + ") exceeded in '" + function + "'");
+}
+
+//cadrele de executie ale interpretorului pe arbore. Variabilele sunt rezolvate la parsare
+//in (depth, slot), iar toate cadrele stau intr-un singur vector contiguu, folosit ca stiva:
+//un apel isi ia cadrul din varf si il elibereaza la intoarcere, fara alocari pe apel.
 class SymTableStub {
+    std::vector<Value> storage;
+    std::vector<size_t> frameBase;  //frameBase[depth] = indexul primului slot din cadru
+    std::vector<Value*> frames;     //frames[depth] = &storage[frameBase[depth]]
+    std::vector<func_def_node*> functions;                //functiile globale, dupa id-ul internat al numelui
+    std::unordered_map<long, func_def_node*> methods;     //(id clasa, id metoda)
+    std::vector<class_def_node*> classes;                 //dupa id-ul internat al numelui
+
+    static long methodKey(int classId, int methodId) { return (long)classId << 32 | (unsigned)methodId; }
+
+    void rebase() {
+        for (size_t d = 0; d < frames.size(); d++)
+            if (frameBase[d] != NO_FRAME) frames[d] = storage.data() + frameBase[d];
+    }
+
 public:
-    std::map<std::string, Value> vals;
-    bool hasValue(const std::string& name) const {
-        return vals.find(name) != vals.end();
+    Completion completion = COMPLETION_NORMAL;
+    OutputSink* out = &standardOutput(); //destinatia lui print; fiecare compilare poate avea propria iesire
+    int callDepth = 0; //apelurile active
+
+    static constexpr size_t NO_FRAME = (size_t)-1;
+
+    SymTableStub() { storage.reserve(4096); }
+
+    void enterFrame(int depth, int size) {
+        size_t base = storage.size();
+        bool moved = storage.capacity() < base + size;
+        storage.resize(base + size);
+        if ((int)frameBase.size() <= depth) {
+            frameBase.resize(depth + 1, NO_FRAME);
+            frames.resize(depth + 1, nullptr);
+        }
+        frameBase[depth] = base;
+        if (moved) rebase();
+        else frames[depth] = storage.data() + base;
+    }
+
+    void leaveFrame(int depth) {
+        storage.resize(frameBase[depth]);
+        frameBase.resize(depth);
+        frames.resize(depth);
+    }
+
+    Value& slot(int depth, int index) {
+        return frames[depth][index];
     }
 
-    Value getValue(const std::string& name) const {
-        auto it = vals.find(name);
-        if (it == vals.end()) {
-            std::cerr << "Error: variable '" << name << "' has no value\n";
-            return Value(); 
+    //un cadru nou in varful stivei, inca nelegat: argumentele se evalueaza in cadrul apelantului
+    size_t allocFrame(int size) {
+        size_t base = storage.size();
+        bool moved = storage.capacity() < base + size;
+        storage.resize(base + size);
+        if (moved) rebase();
+        return base;
+    }
+
+    Value& at(size_t index) { return storage[index]; }
+
+    //legatura unei adancimi: un cadru din stiva (base) sau campurile unui obiect (base == NO_FRAME)
+    struct FrameBinding {
+        size_t base;
+        Value* fields;
+    };
+
+    FrameBinding binding(int depth) {
+        if ((int)frameBase.size() <= depth) {
+            frameBase.resize(depth + 1, NO_FRAME);
+            frames.resize(depth + 1, nullptr);
         }
-        return it->second;
+        return { frameBase[depth], frames[depth] };
+    }
+
+    //cadrul de la base devine cel de la adancimea depth; intoarce legatura inlocuita
+    FrameBinding bindFrame(int depth, size_t base) {
+        FrameBinding saved = binding(depth);
+        frameBase[depth] = base;
+        frames[depth] = storage.data() + base;
+        return saved;
+    }
+
+    //campurile obiectului devin cadrul de la adancimea depth (inregistrarile din pool nu se muta)
+    FrameBinding bindFrame(int depth, Value* fields) {
+        FrameBinding saved = binding(depth);
+        frameBase[depth] = NO_FRAME;
+        frames[depth] = fields;
+        return saved;
     }
 
-    void setValue(const std::string& name, const Value& v) {
-        vals[name] = v;
+    void unbindFrame(int depth, FrameBinding saved) {
+        frameBase[depth] = saved.base;
+        frames[depth] = saved.base == NO_FRAME ? saved.fields : storage.data() + saved.base;
+    }
+
+    //elibereaza cadrele de la base in sus (ordinea inversa alocarii)
+    void freeFrames(size_t base) { storage.resize(base); }
+
+    //definitiile se inregistreaza cand programul le parcurge (program_node::eval), apelurile le cauta dupa nume
+    void defineFunction(int nameId, func_def_node* f) {
+        if ((int)functions.size() <= nameId) functions.resize(nameId + 1, nullptr);
+        functions[nameId] = f;
+    }
+    func_def_node* function(int nameId) const {
+        return nameId >= 0 && nameId < (int)functions.size() ? functions[nameId] : nullptr;
+    }
+    void defineMethod(int classId, int methodId, func_def_node* f) { methods[methodKey(classId, methodId)] = f; }
+    func_def_node* method(int classId, int methodId) const {
+        auto it = methods.find(methodKey(classId, methodId));
+        return it == methods.end() ? nullptr : it->second;
+    }
+    void defineClass(int classId, class_def_node* c) {
+        if ((int)classes.size() <= classId) classes.resize(classId + 1, nullptr);
+        classes[classId] = c;
+    }
+    class_def_node* classDef(int classId) const {
+        return classId >= 0 && classId < (int)classes.size() ? classes[classId] : nullptr;
     }
 };
 
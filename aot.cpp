@@ -0,0 +1,1299 @@
+#include "aot.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+//runtime-ul inclus in fiecare sursa generata: valoarea dinamica si print cu acelasi format ca OutputSink
+const char* PRELUDE = R"RT(#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rt {
+
+enum Type { INT, FLOAT, BOOL, STRING, VOID, OBJECT, ARRAY };
+enum Op { ADD, SUB, MUL, DIV, LT, GT, LE, GE, EQ, NE };
+enum Fn { LENGTH, SUM, MIN, MAX, DOT };
+
+//copia lui Array din array.h: elementele de tipul elem, contigue, in vectorul corespunzator
+struct Array {
+    Type elem;
+    int length;
+    std::vector<int> ints;
+    std::vector<float> floats;
+    std::vector<char> bools;
+};
+
+//copia lui Value, folosita doar unde expresia poate fi void la executie
+struct Val {
+    Type type;
+    union { int i; float f; bool b; uint64_t bits; };
+    std::string s;
+    std::shared_ptr<void> obj;
+
+    Val() : type(VOID), bits(0) {}
+    Val(int v) : type(INT), bits(0) { i = v; }
+    Val(float v) : type(FLOAT), bits(0) { f = v; }
+    Val(bool v) : type(BOOL), bits(0) { b = v; }
+    Val(const std::string& v) : type(STRING), bits(0), s(v) {}
+    Val(std::string&& v) : type(STRING), bits(0), s(std::move(v)) {}
+    explicit Val(std::shared_ptr<void> o) : type(OBJECT), bits(0), obj(std::move(o)) {}
+    explicit Val(std::shared_ptr<Array> a) : type(ARRAY), bits(0), obj(std::move(a)) {}
+};
+
+//alocatorul obiectelor: blocurile eliberate se refolosesc (cate o lista pentru fiecare tip de bloc)
+template <typename T>
+struct Pool {
+    typedef T value_type;
+    Pool() {}
+    template <typename U> Pool(const Pool<U>&) {}
+
+    static std::vector<void*>& freeList() {
+        static std::vector<void*>* list = new std::vector<void*>; //traieste si dupa destructorii statici
+        return *list;
+    }
+    T* allocate(size_t n) {
+        if (n == 1 && !freeList().empty()) {
+            void* p = freeList().back();
+            freeList().pop_back();
+            return static_cast<T*>(p);
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        if (n == 1) freeList().push_back(p);
+        else ::operator delete(p);
+    }
+};
+template <typename T, typename U> bool operator==(const Pool<T>&, const Pool<U>&) { return true; }
+template <typename T, typename U> bool operator!=(const Pool<T>&, const Pool<U>&) { return false; }
+
+//un obiect nou, cu campurile initializate de init (declaratiile lor, in ordine)
+template <typename C>
+inline Val make(void (*init)(C*)) {
+    std::shared_ptr<C> p = std::allocate_shared<C>(Pool<C>());
+    init(p.get());
+    return Val(std::shared_ptr<void>(std::move(p)));
+}
+
+template <typename C>
+inline C* object(const Val& v) { return static_cast<C*>(v.obj.get()); }
+
+template <typename T> struct Same { typedef T type; };
+
+//a.x si a.x = v cand a poate fi void
+template <typename C, typename T>
+inline Val get(const Val& o, T C::*member) { return o.type == OBJECT ? Val(object<C>(o)->*member) : Val(); }
+
+template <typename C, typename T>
+inline T set(const Val& o, T C::*member, typename Same<T>::type v) {
+    if (o.type == OBJECT) object<C>(o)->*member = v;
+    return v;
+}
+
+inline const std::string& text(const Val& v) {
+    static const std::string empty;
+    return v.type == STRING ? v.s : empty;
+}
+
+inline bool truthy(const Val& v) { return v.type == BOOL && v.b; }
+inline Val notOp(const Val& v) { return v.type == BOOL ? Val(!v.b) : Val(); }
+inline Val divInt(int a, int b) { return b == 0 ? Val() : Val(a / b); }
+inline Val divFloat(float a, float b) { return b == 0.0f ? Val() : Val(a / b); }
+
+inline float floatBits(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof f);
+    return f;
+}
+
+template <typename F>
+inline Val logicalAnd(const Val& l, F right) {
+    if (l.type != BOOL) return Val();
+    if (!l.b) return l;
+    return Val(right());
+}
+
+template <typename F>
+inline Val logicalOr(const Val& l, F right) {
+    if (l.type != BOOL) return Val();
+    if (l.b) return l;
+    return Val(right());
+}
+
+//binary_expr_node::eval: operatia se alege dupa tipul operandului stang
+inline Val binary(Op op, const Val& l, const Val& r) {
+    switch (l.type) {
+        case INT:
+            switch (op) {
+                case ADD: return Val(l.i + r.i);
+                case SUB: return Val(l.i - r.i);
+                case MUL: return Val(l.i * r.i);
+                case DIV: return divInt(l.i, r.i);
+                case LT: return Val(l.i < r.i);
+                case GT: return Val(l.i > r.i);
+                case LE: return Val(l.i <= r.i);
+                case GE: return Val(l.i >= r.i);
+                case EQ: return Val(l.i == r.i);
+                case NE: return Val(l.i != r.i);
+            }
+            break;
+        case FLOAT:
+            switch (op) {
+                case ADD: return Val(l.f + r.f);
+                case SUB: return Val(l.f - r.f);
+                case MUL: return Val(l.f * r.f);
+                case DIV: return divFloat(l.f, r.f);
+                case LT: return Val(l.f < r.f);
+                case GT: return Val(l.f > r.f);
+                case LE: return Val(l.f <= r.f);
+                case GE: return Val(l.f >= r.f);
+                case EQ: return Val(l.f == r.f);
+                case NE: return Val(l.f != r.f);
+            }
+            break;
+        case BOOL:
+            if (op == EQ) return Val(l.b == r.b);
+            if (op == NE) return Val(l.b != r.b);
+            break;
+        case STRING:
+            if (op == ADD) return Val(l.s + text(r));
+            if (op == EQ) return Val(l.s == text(r));
+            if (op == NE) return Val(l.s != text(r));
+            break;
+        default:
+            break;
+    }
+    return Val();
+}
+
+//nodurile tipizate (int_binary_node ...): operanzii de alt tip decat cel static dau void; un drept void e 0
+inline Val typedBinary(Op op, Type type, const Val& l, const Val& r) {
+    if (l.type != type || (r.type != type && r.type != VOID)) return Val();
+    return binary(op, l, r);
+}
+
+//o eroare a unui tablou opreste programul, cu acelasi mesaj ca interpretorul
+[[noreturn]] inline void fail(const std::string& message) {
+    std::fflush(stdout);
+    std::fprintf(stderr, "Error: %s\n", message.c_str());
+    std::exit(1);
+}
+
+inline Array* array(const Val& v) { return static_cast<Array*>(v.obj.get()); }
+
+//elementele zero
+inline std::shared_ptr<Array> allocate(Type elem, int n) {
+    std::shared_ptr<Array> a = std::make_shared<Array>();
+    a->elem = elem;
+    a->length = n;
+    if (elem == INT) a->ints.resize(n);
+    else if (elem == FLOAT) a->floats.resize(n);
+    else a->bools.resize(n);
+    return a;
+}
+
+inline Val element(const Array* a, int k) {
+    if (a->elem == INT) return Val(a->ints[k]);
+    if (a->elem == FLOAT) return Val(a->floats[k]);
+    return Val((bool)a->bools[k]);
+}
+
+//o valoare de alt tip decat elementele scrie elementul zero
+inline void setElement(Array* a, int k, const Val& v) {
+    bool same = v.type == a->elem;
+    if (a->elem == INT) a->ints[k] = same ? v.i : 0;
+    else if (a->elem == FLOAT) a->floats[k] = same ? v.f : 0.0f;
+    else a->bools[k] = same && v.b;
+}
+
+inline Val newArray(Type elem, const Val& n) {
+    if (n.type != INT) return Val();
+    if (n.i < 0 || n.i > RT_MAX_ARRAY_LENGTH) fail("invalid array length " + std::to_string(n.i));
+    return Val(allocate(elem, n.i));
+}
+
+inline Val arrayLiteral(Type elem, std::initializer_list<Val> items) {
+    std::shared_ptr<Array> a = allocate(elem, (int)items.size());
+    int k = 0;
+    for (const Val& v : items) setElement(a.get(), k++, v);
+    return Val(std::move(a));
+}
+
+inline void checkIndex(const Array* a, int i) {
+    if ((unsigned)i >= (unsigned)a->length)
+        fail("array index " + std::to_string(i) + " out of bounds (length " + std::to_string(a->length) + ")");
+}
+
+inline Val index(const Val& a, const Val& i) {
+    if (a.type != ARRAY || i.type != INT) return Val();
+    checkIndex(array(a), i.i);
+    return element(array(a), i.i);
+}
+
+//a[i] = v; intr-un tablou void nu se scrie nimic
+template <typename T>
+inline T setIndex(const Val& a, const Val& i, T v) {
+    if (a.type == ARRAY && i.type == INT) {
+        checkIndex(array(a), i.i);
+        setElement(array(a), i.i, Val(v));
+    }
+    return v;
+}
+
+inline Val length(const Val& a) { return a.type == ARRAY ? Val(array(a)->length) : Val(); }
+
+//aceeasi ordine canonica ca array.cpp (8 acumulatori), deci aceleasi rotunjiri pe float
+template <typename T>
+inline T combine(Fn fn, T acc, T x) {
+    if (fn == MIN) return acc < x ? acc : x;
+    if (fn == MAX) return acc > x ? acc : x;
+    return acc + x;
+}
+
+template <typename T>
+T reduce(Fn fn, const T* a, const T* b, int n) {
+    bool extreme = fn == MIN || fn == MAX;
+    auto term = [&](int k) { return fn == DOT ? a[k] * b[k] : a[k]; };
+    int k = 0;
+    T r;
+    if (extreme && n < 8) {
+        r = a[0];
+        k = 1;
+    }
+    else {
+        T lane[8];
+        for (int j = 0; j < 8; j++) lane[j] = extreme ? a[j] : T();
+        if (extreme) k = 8;
+        for (int end = n - n % 8; k < end; k += 8)
+            for (int j = 0; j < 8; j++) lane[j] = combine(fn, lane[j], term(k + j));
+        r = combine(fn, combine(fn, combine(fn, lane[0], lane[4]), combine(fn, lane[2], lane[6])),
+                    combine(fn, combine(fn, lane[1], lane[5]), combine(fn, lane[3], lane[7])));
+    }
+    for (; k < n; k++) r = combine(fn, r, term(k));
+    return r;
+}
+
+inline Val reduce(Fn fn, const Val& a, const Val& b) {
+    if (a.type != ARRAY || array(a)->elem == BOOL) return Val();
+    const Array* x = array(a);
+    const Array* y = nullptr;
+    if (fn == DOT) {
+        if (b.type != ARRAY || array(b)->elem != x->elem) return Val();
+        y = array(b);
+        if (y->length != x->length)
+            fail("array length mismatch (" + std::to_string(x->length) + " and " + std::to_string(y->length) + ")");
+    }
+    if ((fn == MIN || fn == MAX) && x->length == 0) return Val();
+    if (x->elem == INT) return Val(reduce(fn, x->ints.data(), y ? y->ints.data() : nullptr, x->length));
+    return Val(reduce(fn, x->floats.data(), y ? y->floats.data() : nullptr, x->length));
+}
+
+template <typename T>
+inline T apply(Op op, T a, T b) { return op == ADD ? a + b : op == SUB ? a - b : a * b; }
+
+//l op r element cu element; un operand scalar se aplica fiecarui element
+inline Val arith(Op op, const Val& l, const Val& r) {
+    const Array* la = l.type == ARRAY ? array(l) : nullptr;
+    const Array* ra = r.type == ARRAY ? array(r) : nullptr;
+    if (!la && !ra) return Val();
+    Type elem = la ? la->elem : ra->elem;
+    if (elem == BOOL || (la ? la->elem : l.type) != elem || (ra ? ra->elem : r.type) != elem) return Val();
+    if (la && ra && la->length != ra->length)
+        fail("array length mismatch (" + std::to_string(la->length) + " and " + std::to_string(ra->length) + ")");
+
+    int n = la ? la->length : ra->length;
+    std::shared_ptr<Array> out = allocate(elem, n);
+    for (int k = 0; k < n; k++) {
+        if (elem == INT) out->ints[k] = apply(op, la ? la->ints[k] : l.i, ra ? ra->ints[k] : r.i);
+        else out->floats[k] = apply(op, la ? la->floats[k] : l.f, ra ? ra->floats[k] : r.f);
+    }
+    return Val(std::move(out));
+}
+
+inline void line(const char* data, size_t size) {
+    std::fwrite(data, 1, size, stdout);
+    std::fputc('\n', stdout);
+}
+
+inline void append(std::string& s, int v) {
+    char buf[48];
+    s.append(buf, std::to_chars(buf, buf + sizeof buf, v).ptr - buf);
+}
+
+inline void append(std::string& s, float v) {
+    char buf[48];
+    s.append(buf, std::to_chars(buf, buf + sizeof buf, v, std::chars_format::general, 6).ptr - buf);
+}
+
+inline void print(int v) {
+    char buf[48];
+    line(buf, std::to_chars(buf, buf + sizeof buf, v).ptr - buf);
+}
+
+inline void print(float v) {
+    char buf[48];
+    line(buf, std::to_chars(buf, buf + sizeof buf, v, std::chars_format::general, 6).ptr - buf);
+}
+
+inline void print(bool v) { v ? line("true", 4) : line("false", 5); }
+inline void print(const std::string& v) { line(v.data(), v.size()); }
+
+//[e0, e1, ...]
+inline void print(const Array* a) {
+    std::string s = "[";
+    for (int k = 0; k < a->length; k++) {
+        if (k) s += ", ";
+        if (a->elem == INT) append(s, a->ints[k]);
+        else if (a->elem == FLOAT) append(s, a->floats[k]);
+        else s += a->bools[k] ? "true" : "false";
+    }
+    s += "]";
+    print(s);
+}
+
+inline void print(const Val& v) {
+    switch (v.type) {
+        case INT: print(v.i); break;
+        case FLOAT: print(v.f); break;
+        case BOOL: print(v.b); break;
+        case STRING: print(v.s); break;
+        case OBJECT: line("object", 6); break;
+        case ARRAY: print(array(v)); break;
+        default: line("void", 4); break;
+    }
+}
+
+inline int callDepth = 0;
+
+//un apel activ; peste limita programul se opreste, cu acelasi mesaj ca interpretorul
+struct Frame {
+    explicit Frame(const char* name) {
+        if (callDepth >= RT_MAX_CALL_DEPTH) {
+            std::fflush(stdout);
+            std::fprintf(stderr, "Error: maximum call depth (%d) exceeded in '%s'\n", RT_MAX_CALL_DEPTH, name);
+            std::exit(1);
+        }
+        callDepth++;
+    }
+    ~Frame() { callDepth--; }
+};
+
+}
+
+)RT";
+
+const char* typeName(CppEmitter::Kind kind) {
+    static const char* names[] = { "int", "float", "bool", "std::string", "rt::Val" };
+    return names[kind];
+}
+
+const char* binOpName(BinOp op) {
+    static const char* names[] = { "ADD", "SUB", "MUL", "DIV", "LT", "GT", "LE", "GE", "EQ", "NE" };
+    return names[op];
+}
+
+const char* arrayFnConstant(ArrayFn fn) {
+    static const char* names[] = { "LENGTH", "SUM", "MIN", "MAX", "DOT" };
+    return names[fn];
+}
+
+//tipul elementelor, ca rt::Type
+const char* elementType(TipBaza element) {
+    return element == TYPE_FLOAT ? "rt::FLOAT" : element == TYPE_BOOL ? "rt::BOOL" : "rt::INT";
+}
+
+std::string intLiteral(int v) {
+    if (v == INT32_MIN) return "(-2147483647 - 1)";
+    if (v < 0) return "(" + std::to_string(v) + ")";
+    return std::to_string(v);
+}
+
+//cea mai scurta forma zecimala care se citeste inapoi exact; inf si nan prin biti
+std::string floatLiteral(float v) {
+    if (!std::isfinite(v)) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        return "rt::floatBits(" + std::to_string(bits) + "u)";
+    }
+    char buf[64];
+    std::string s(buf, std::to_chars(buf, buf + sizeof buf, v).ptr);
+    if (s.find_first_of(".e") == std::string::npos) s += ".0";
+    return "(" + s + "f)";
+}
+
+//nodurile evaluate la executie; corpurile functiilor si claselor nu se executa la definire
+void executedChildren(ast_node* node, std::vector<ast_node*>& out) {
+    switch (node->kind) {
+        case NODE_PROGRAM: {
+            program_node* p = static_cast<program_node*>(node);
+            for (auto g : p->globals) out.push_back(g);
+            out.push_back(p->main_block);
+            break;
+        }
+        case NODE_BLOCK:
+            for (auto s : static_cast<block_node*>(node)->statements) out.push_back(s);
+            break;
+        case NODE_MAIN: out.push_back(static_cast<main_node*>(node)->body); break;
+        case NODE_VAR_DECL: out.push_back(static_cast<var_decl_node*>(node)->init_val); break;
+        case NODE_IF:
+            out.push_back(static_cast<if_node*>(node)->condition);
+            out.push_back(static_cast<if_node*>(node)->then_block);
+            break;
+        case NODE_WHILE:
+            out.push_back(static_cast<while_node*>(node)->condition);
+            out.push_back(static_cast<while_node*>(node)->body);
+            break;
+        case NODE_RETURN: out.push_back(static_cast<return_node*>(node)->expr); break;
+        case NODE_PRINT: out.push_back(static_cast<print_node*>(node)->expr); break;
+        case NODE_ASSIGN: out.push_back(static_cast<assign_node*>(node)->val); break;
+        case NODE_MEMBER_ASSIGN:
+            out.push_back(static_cast<member_assign_node*>(node)->obj);
+            out.push_back(static_cast<member_assign_node*>(node)->val);
+            break;
+        case NODE_DOT: out.push_back(static_cast<dot_node*>(node)->obj); break;
+        case NODE_BINARY:
+            out.push_back(static_cast<binary_expr_node*>(node)->left);
+            out.push_back(static_cast<binary_expr_node*>(node)->right);
+            break;
+        case NODE_CALL:
+            for (auto a : static_cast<call_node*>(node)->args) out.push_back(a);
+            break;
+        case NODE_METHOD_CALL:
+            out.push_back(static_cast<method_call_node*>(node)->obj);
+            for (auto a : static_cast<method_call_node*>(node)->args) out.push_back(a);
+            break;
+        case NODE_ARRAY_NEW: out.push_back(static_cast<array_new_node*>(node)->size); break;
+        case NODE_ARRAY_LITERAL:
+            for (auto i : static_cast<array_literal_node*>(node)->items) out.push_back(i);
+            break;
+        case NODE_INDEX:
+            out.push_back(static_cast<index_node*>(node)->arr);
+            out.push_back(static_cast<index_node*>(node)->index);
+            break;
+        case NODE_INDEX_ASSIGN:
+            out.push_back(static_cast<index_assign_node*>(node)->arr);
+            out.push_back(static_cast<index_assign_node*>(node)->index);
+            out.push_back(static_cast<index_assign_node*>(node)->val);
+            break;
+        case NODE_ARRAY_CALL:
+            out.push_back(static_cast<array_call_node*>(node)->arr);
+            if (static_cast<array_call_node*>(node)->arg) out.push_back(static_cast<array_call_node*>(node)->arg);
+            break;
+        default:
+            break;
+    }
+}
+
+std::string shellQuote(const std::string& s) {
+    std::string q = "'";
+    for (char c : s) {
+        if (c == '\'') q += "'\\''";
+        else q += c;
+    }
+    return q + "'";
+}
+
+}
+
+//in metode si la initializarea campurilor, depth 1 sunt campurile clasei; globalele sunt comune tuturor cadrelor
+int CppEmitter::frameOf(int depth) {
+    if (depth == 0) return 0;
+    if (owner && depth == 1) return fieldFrame(owner);
+    return frame;
+}
+
+int CppEmitter::fieldFrame(class_def_node* c) {
+    auto it = fieldFrames.find(c);
+    if (it != fieldFrames.end()) return it->second;
+    int f = 1 + table.size() + (int)fieldFrames.size();
+    fieldFrames[c] = f;
+    return f;
+}
+
+//index -1 = main
+void CppEmitter::enter(int index) {
+    function = index < 0 ? nullptr : table.at(index);
+    owner = function ? function->owner : nullptr;
+    frame = index + 1;
+}
+
+//declaratiile campurilor, compilate in init_<clasa>
+void CppEmitter::enterClass(class_def_node* c) {
+    function = nullptr;
+    owner = c;
+    frame = 0;
+}
+
+CppEmitter::Variable& CppEmitter::bind(int depth, int slot, const std::string& name) {
+    int f = frameOf(depth);
+    Variable& v = variables[key(f, depth, slot)];
+    if (v.name.empty()) {
+        v.name = "v" + std::to_string(depth) + "_" + std::to_string(slot) + "_" + name;
+        v.frame = f;
+        v.depth = depth;
+        v.field = f > table.size();
+    }
+    return v;
+}
+
+CppEmitter::Variable* CppEmitter::variable(int depth, int slot) {
+    if (slot < 0) return nullptr;
+    auto it = variables.find(key(frameOf(depth), depth, slot));
+    return it == variables.end() ? nullptr : &it->second;
+}
+
+CppEmitter::Variable* CppEmitter::parameter(int index, int param) {
+    auto it = variables.find(key(index + 1, table.at(index)->depth, param));
+    return it == variables.end() ? nullptr : &it->second;
+}
+
+class_def_node* CppEmitter::classOf(int classId) const {
+    int i = table.findClass(classId);
+    return i < 0 ? nullptr : table.classAt(i);
+}
+
+CppEmitter::Variable* CppEmitter::field(int classId, int slot) {
+    class_def_node* c = classOf(classId);
+    if (!c || slot < 0) return nullptr;
+    auto it = variables.find(key(fieldFrame(c), 1, slot));
+    return it == variables.end() ? nullptr : &it->second;
+}
+
+//expresia e sigur un obiect (o locala marcata object), deci campurile si metodele se acceseaza direct
+bool CppEmitter::isObject(ast_node* node) {
+    if (!node || node->kind != NODE_ID) return false;
+    Variable* v = variable(static_cast<id_node*>(node)->depth, static_cast<id_node*>(node)->slot);
+    return v && v->object;
+}
+
+std::string CppEmitter::functionName(int index) const {
+    func_def_node* f = table.at(index);
+    return (f->owner ? "m" : "f") + std::to_string(index) + "_" + f->name;
+}
+
+CppEmitter::Kind CppEmitter::kindOf(const TypeInfo* type) {
+    if (!type) return K_VAL;
+    switch (type->type) {
+        case TYPE_INT: return K_INT;
+        case TYPE_FLOAT: return K_FLOAT;
+        case TYPE_BOOL: return K_BOOL;
+        case TYPE_STRING: return K_STR;
+        default: return K_VAL;
+    }
+}
+
+std::string CppEmitter::defaultFor(Kind kind) {
+    static const char* defaults[] = { "0", "0.0f", "false", "std::string()", "rt::Val()" };
+    return defaults[kind];
+}
+
+//o locala (nu globala, nu camp) de tipul unei clase ramane candidat object daca fiecare declaratie a slotului
+//creeaza obiectul sau are initializare (verificata apoi de refine); globalele si campurile pot fi citite inainte
+//de declaratie (dintr-o functie, respectiv dintr-o metoda apelata de initializarea altui camp)
+void CppEmitter::declare(var_decl_node* decl) {
+    if (decl->slot < 0) return;
+    Variable& v = bind(decl->depth, decl->slot, decl->name);
+    Kind k = kindOf(decl->type);
+    bool object = decl->depth > 0 && !v.field && decl->type && decl->type->type == TYPE_CLASS &&
+                  (decl->init_val || classOf(decl->class_id));
+    if (!v.declared) {
+        v.kind = k;
+        v.object = object;
+        v.declared = true;
+    }
+    else {
+        if (v.kind != k) v.kind = K_VAL; //slot refolosit cu alt tip
+        v.object &= object;
+    }
+}
+
+//prima trecere: sloturile folosite si tipul declarat al fiecaruia
+void CppEmitter::collect(ast_node* node) {
+    if (!node) return;
+    if (node->kind == NODE_VAR_DECL) declare(static_cast<var_decl_node*>(node));
+    else if (node->kind == NODE_ID) {
+        id_node* id = static_cast<id_node*>(node);
+        if (id->slot >= 0) bind(id->depth, id->slot, id->name);
+    }
+    else if (node->kind == NODE_ASSIGN) {
+        assign_node* a = static_cast<assign_node*>(node);
+        if (a->slot >= 0) bind(a->depth, a->slot, a->name);
+    }
+
+    std::vector<ast_node*> children;
+    executedChildren(node, children);
+    for (auto c : children) collect(c);
+}
+
+//o variabila ramane nativa doar daca orice valoare scrisa in ea are acelasi tip nativ; altfel devine rt::Val.
+//Intoarce true daca a schimbat ceva (se repeta pana la punct fix, citirile depind de tipul variabilelor).
+bool CppEmitter::refine(ast_node* node) {
+    if (!node) return false;
+    bool changed = false;
+
+    ast_node* stored = nullptr;
+    Variable* target = nullptr;
+    if (node->kind == NODE_VAR_DECL) {
+        var_decl_node* d = static_cast<var_decl_node*>(node);
+        stored = d->init_val;
+        target = variable(d->depth, d->slot);
+    }
+    else if (node->kind == NODE_ASSIGN) {
+        assign_node* a = static_cast<assign_node*>(node);
+        stored = a->val;
+        target = variable(a->depth, a->slot);
+    }
+    else if (node->kind == NODE_MEMBER_ASSIGN) {
+        member_assign_node* m = static_cast<member_assign_node*>(node);
+        stored = m->val;
+        target = field(m->class_id, m->slot);
+    }
+    if (stored && target && target->kind != K_VAL && expr(stored).kind != target->kind) {
+        target->kind = K_VAL;
+        changed = true;
+    }
+    if (stored && target && target->object && !isObject(stored)) {
+        target->object = false;
+        changed = true;
+    }
+
+    //argumentele se scriu in parametrii functiei apelate; lipsa unuia il face void
+    int callee = -1;
+    const node_list* args = nullptr;
+    if (node->kind == NODE_CALL) {
+        call_node* c = static_cast<call_node*>(node);
+        callee = table.find(c->class_id, c->func_id);
+        args = &c->args;
+    }
+    else if (node->kind == NODE_METHOD_CALL) {
+        method_call_node* m = static_cast<method_call_node*>(node);
+        callee = m->class_id < 0 ? -1 : table.find(m->class_id, m->method_id);
+        args = &m->args;
+    }
+    if (callee >= 0) {
+        for (size_t i = 0; i < table.at(callee)->param_names.size(); i++) {
+            Variable* p = parameter(callee, (int)i);
+            if (!p || p->kind == K_VAL) continue;
+            if (i >= args->size() || expr((*args)[i]).kind != p->kind) {
+                p->kind = K_VAL;
+                changed = true;
+            }
+        }
+    }
+
+    //un return fara valoare sau cu alt tip decat cel declarat face rezultatul functiei rt::Val
+    if (node->kind == NODE_RETURN && function) {
+        ast_node* e = static_cast<return_node*>(node)->expr;
+        Kind& r = returns[frame - 1];
+        if (r != K_VAL && (!e || expr(e).kind != r)) {
+            r = K_VAL;
+            changed = true;
+        }
+    }
+
+    std::vector<ast_node*> children;
+    executedChildren(node, children);
+    for (auto c : children) changed |= refine(c);
+    return changed;
+}
+
+//main si globalele, fiecare functie, apoi initializarea campurilor fiecarei clase
+bool CppEmitter::refineAll(program_node* program) {
+    enter(-1);
+    bool changed = refine(program);
+    for (int i = 0; i < table.size(); i++) {
+        enter(i);
+        changed |= refine(table.at(i)->body);
+    }
+    for (int i = 0; i < table.classCount(); i++) {
+        enterClass(table.classAt(i));
+        for (auto m : table.classAt(i)->members)
+            if (m && m->kind == NODE_VAR_DECL) changed |= refine(m);
+    }
+    enter(-1);
+    return changed;
+}
+
+//operatiile pe tablouri pot opri programul (sau scriu elemente), deci si ele se evalueaza in ordine
+bool CppEmitter::hasEffects(ast_node* node) {
+    if (!node) return false;
+    if (node->kind == NODE_ASSIGN || node->kind == NODE_MEMBER_ASSIGN) return true;
+    if (node->kind == NODE_CALL || node->kind == NODE_METHOD_CALL) return true;
+    if (node->kind == NODE_ARRAY_NEW || node->kind == NODE_INDEX || node->kind == NODE_INDEX_ASSIGN) return true;
+    if (node->kind == NODE_ARRAY_CALL && static_cast<array_call_node*>(node)->fn != ARRAY_LENGTH) return true;
+    if (node->kind == NODE_BINARY && static_cast<binary_expr_node*>(node)->operand == VAL_ARRAY) return true;
+    std::vector<ast_node*> children;
+    executedChildren(node, children);
+    for (auto c : children)
+        if (hasEffects(c)) return true;
+    return false;
+}
+
+bool CppEmitter::readsSlot(ast_node* node, int depth, int slot) {
+    if (!node) return false;
+    if (node->kind == NODE_ID) {
+        id_node* id = static_cast<id_node*>(node);
+        if (id->depth == depth && id->slot == slot) return true;
+    }
+    std::vector<ast_node*> children;
+    executedChildren(node, children);
+    for (auto c : children)
+        if (readsSlot(c, depth, slot)) return true;
+    return false;
+}
+
+std::string CppEmitter::stringLiteral(const std::string& text) {
+    auto it = strings.find(text);
+    int index = it != strings.end() ? it->second : (strings[text] = (int)strings.size());
+    return "str" + std::to_string(index);
+}
+
+//conversia intre reprezentari urmeaza citirile din interpretor: .i/.f/.b din union, s() gol pentru non-sir
+std::string CppEmitter::as(const Expr& e, Kind kind) {
+    if (e.kind == kind) return e.code;
+    if (kind == K_VAL) return "rt::Val(" + e.code + ")";
+    if (e.kind != K_VAL) return as(Expr{ "rt::Val(" + e.code + ")", K_VAL }, kind);
+    switch (kind) {
+        case K_INT: return "(" + e.code + ").i";
+        case K_FLOAT: return "(" + e.code + ").f";
+        case K_BOOL: return "(" + e.code + ").b";
+        default: return "rt::text(" + e.code + ")";
+    }
+}
+
+//conditia din if/while: adevarata doar pentru un bool true
+std::string CppEmitter::condition(ast_node* node) {
+    Expr e = expr(node);
+    if (e.kind == K_BOOL) return e.code;
+    if (e.kind == K_VAL) return "rt::truthy(" + e.code + ")";
+    return "((void)" + e.code + ", false)";
+}
+
+CppEmitter::Expr CppEmitter::expr(ast_node* node) {
+    if (!node) return { "rt::Val()", K_VAL };
+
+    switch (node->kind) {
+        case NODE_LITERAL: {
+            const Value& v = static_cast<literal_node*>(node)->val;
+            switch (v.type) {
+                case VAL_INT: return { intLiteral(v.i), K_INT };
+                case VAL_FLOAT: return { floatLiteral(v.f), K_FLOAT };
+                case VAL_BOOL: return { v.b ? "true" : "false", K_BOOL };
+                case VAL_STRING: return { stringLiteral(std::string(v.s())), K_STR };
+                default: return { "rt::Val()", K_VAL };
+            }
+        }
+
+        case NODE_ID: {
+            id_node* id = static_cast<id_node*>(node);
+            Variable* v = variable(id->depth, id->slot);
+            if (!v) return { "rt::Val()", K_VAL };
+            return { ref(*v), v->kind };
+        }
+
+        case NODE_ASSIGN:
+            return assign(static_cast<assign_node*>(node));
+
+        case NODE_MEMBER_ASSIGN:
+            return memberAssign(static_cast<member_assign_node*>(node));
+
+        case NODE_DOT:
+            return dot(static_cast<dot_node*>(node));
+
+        case NODE_BINARY:
+            return binary(static_cast<binary_expr_node*>(node));
+
+        case NODE_CALL: {
+            call_node* c = static_cast<call_node*>(node);
+            return call(table.find(c->class_id, c->func_id), nullptr, c->args);
+        }
+
+        case NODE_METHOD_CALL: {
+            method_call_node* m = static_cast<method_call_node*>(node);
+            return call(m->class_id < 0 ? -1 : table.find(m->class_id, m->method_id), m->obj, m->args);
+        }
+
+        case NODE_ARRAY_NEW: {
+            array_new_node* a = static_cast<array_new_node*>(node);
+            return { std::string("rt::newArray(") + elementType(a->element) + ", " + as(expr(a->size), K_VAL) + ")", K_VAL };
+        }
+
+        //elementele unei liste intre acolade se evalueaza in ordine
+        case NODE_ARRAY_LITERAL: {
+            array_literal_node* a = static_cast<array_literal_node*>(node);
+            std::string code = std::string("rt::arrayLiteral(") + elementType(a->element) + ", {";
+            for (size_t i = 0; i < a->items.size(); i++) code += (i ? ", " : " ") + as(expr(a->items[i]), K_VAL);
+            return { code + " })", K_VAL };
+        }
+
+        case NODE_INDEX: {
+            index_node* ix = static_cast<index_node*>(node);
+            return { runtime("rt::index", { ix->arr, ix->index }), K_VAL };
+        }
+
+        //rezultatul e valoarea scrisa, cu tipul ei
+        case NODE_INDEX_ASSIGN: {
+            index_assign_node* ia = static_cast<index_assign_node*>(node);
+            return { runtime("rt::setIndex", { ia->arr, ia->index, ia->val }, true), expr(ia->val).kind };
+        }
+
+        case NODE_ARRAY_CALL: {
+            array_call_node* ac = static_cast<array_call_node*>(node);
+            if (ac->fn == ARRAY_LENGTH) return { "rt::length(" + expr(ac->arr).code + ")", K_VAL };
+            std::string fn = std::string("rt::") + arrayFnConstant(ac->fn);
+            if (!ac->arg) return { "rt::reduce(" + fn + ", " + as(expr(ac->arr), K_VAL) + ", rt::Val())", K_VAL };
+            return { runtime("rt::reduce(" + fn + ", ", { ac->arr, ac->arg }), K_VAL };
+        }
+
+        default:
+            return { "rt::Val()", K_VAL };
+    }
+}
+
+//o functie din prelude pe argumentele args (ca rt::Val; ultimul cu tipul lui daca native e true), evaluate in ordine.
+//function se termina cu "(" sau cu ", " daca are deja primele argumente
+std::string CppEmitter::runtime(const std::string& function, const std::vector<ast_node*>& args, bool native) {
+    std::string open = function.back() == ' ' ? function : function + "(";
+    bool sequenced = false;
+    for (auto a : args) sequenced |= hasEffects(a);
+    std::string prefix, list;
+    for (size_t i = 0; i < args.size(); i++) {
+        Expr e = expr(args[i]);
+        std::string value = native && i + 1 == args.size() ? e.code : as(e, K_VAL);
+        if (sequenced) {
+            prefix += "auto a" + std::to_string(i) + "_ = " + value + "; ";
+            value = "a" + std::to_string(i) + "_";
+        }
+        list += (i ? ", " : "") + value;
+    }
+    if (!sequenced) return open + list + ")";
+    return "([&]() { " + prefix + "return " + open + list + "); }())";
+}
+
+//fara tinta: void, fara evaluarea argumentelor (ca call_node::eval). Argumentele cu efecte se evalueaza
+//in ordine, in variabile temporare; cele in plus se evalueaza si se arunca. Obiectul metodei se evalueaza
+//primul si ramane in viata pe durata apelului; daca nu e sigur un obiect, pe void rezultatul e void.
+//O metoda apelata fara obiect (din alta metoda a clasei) primeste acelasi self_
+CppEmitter::Expr CppEmitter::call(int index, ast_node* receiver, const node_list& args) {
+    if (index < 0) return { "rt::Val()", K_VAL };
+    func_def_node* f = table.at(index);
+    size_t params = f->param_names.size();
+    bool checked = receiver && !isObject(receiver);
+
+    bool sequenced = checked;
+    for (auto a : args) sequenced |= hasEffects(a);
+    sequenced |= args.size() > params;
+
+    std::string prefix, self = "self_";
+    if (receiver) {
+        std::string type = "F_" + f->owner->name;
+        std::string r = expr(receiver).code;
+        if (sequenced) {
+            prefix = "rt::Val r_ = " + r + "; ";
+            r = "r_";
+        }
+        self = "rt::object<" + type + ">(" + r + ")";
+    }
+
+    std::vector<std::string> values;
+    for (size_t i = 0; i < args.size(); i++) {
+        Expr e = expr(args[i]);
+        if (i >= params) {
+            prefix += "(void)" + e.code + "; ";
+            continue;
+        }
+        Variable* p = parameter(index, (int)i);
+        std::string value = as(e, p ? p->kind : K_VAL);
+        if (!sequenced) values.push_back(value);
+        else {
+            prefix += "auto a" + std::to_string(i) + "_ = " + value + "; ";
+            values.push_back("a" + std::to_string(i) + "_");
+        }
+    }
+    for (size_t i = args.size(); i < params; i++) values.push_back("rt::Val()");
+
+    std::string code = functionName(index) + "(";
+    if (f->owner) code += self;
+    for (size_t i = 0; i < values.size(); i++) code += (i || f->owner ? ", " : "") + values[i];
+    code += ")";
+    if (checked) {
+        code = "r_.type == rt::OBJECT ? " + as(Expr{ code, returns[index] }, K_VAL) + " : rt::Val()";
+        return { "([&]() { " + prefix + "return " + code + "; }())", K_VAL };
+    }
+    if (sequenced) code = "([&]() { " + prefix + "return " + code + "; }())";
+    return { code, returns[index] };
+}
+
+//a.x: pe o locala sigur obiect, direct membrul din F_<clasa>; altfel prin rt::get (void pe void)
+CppEmitter::Expr CppEmitter::dot(dot_node* d) {
+    Variable* f = field(d->class_id, d->slot);
+    if (!f) return { "rt::Val()", K_VAL };
+    std::string type = "F_" + classOf(d->class_id)->name;
+    std::string o = expr(d->obj).code;
+    if (isObject(d->obj)) return { "rt::object<" + type + ">(" + o + ")->" + f->name, f->kind };
+    return { "rt::get(" + o + ", &" + type + "::" + f->name + ")", K_VAL };
+}
+
+//obiectul se citeste inaintea valorii (valoarea poate reatribui variabila obiectului)
+CppEmitter::Expr CppEmitter::memberAssign(member_assign_node* m) {
+    Variable* f = field(m->class_id, m->slot);
+    if (!f) return expr(m->val);
+    std::string type = "F_" + classOf(m->class_id)->name;
+    std::string o = expr(m->obj).code;
+    std::string v = as(expr(m->val), f->kind);
+    if (hasEffects(m->val))
+        return { "([&]() { rt::Val o_ = " + o + "; auto v_ = " + v + "; return rt::set(o_, &" + type + "::" + f->name + ", v_); }())", f->kind };
+    if (isObject(m->obj)) return { "(rt::object<" + type + ">(" + o + ")->" + f->name + " = " + v + ")", f->kind };
+    return { "rt::set(" + o + ", &" + type + "::" + f->name + ", " + v + ")", f->kind };
+}
+
+CppEmitter::Expr CppEmitter::binary(binary_expr_node* bin) {
+    if (bin->op == BIN_AND || bin->op == BIN_OR) {
+        Expr l = expr(bin->left);
+        std::string r = condition(bin->right);
+        bool isAnd = bin->op == BIN_AND;
+        if (l.kind == K_BOOL) return { "(" + l.code + (isAnd ? " && " : " || ") + r + ")", K_BOOL };
+        return { std::string(isAnd ? "rt::logicalAnd(" : "rt::logicalOr(") + as(l, K_VAL) + ", [&]() { return " + r + "; })", K_VAL };
+    }
+
+    if (bin->op == BIN_NOT || !bin->right) {
+        Expr l = expr(bin->left);
+        if (l.kind == K_BOOL) return { "(!" + l.code + ")", K_BOOL };
+        return { "rt::notOp(" + as(l, K_VAL) + ")", K_VAL };
+    }
+
+    Kind operand;
+    switch (bin->operand) {
+        case VAL_INT: operand = K_INT; break;
+        case VAL_FLOAT: operand = K_FLOAT; break;
+        case VAL_STRING: operand = K_STR; break;
+        case VAL_BOOL: operand = K_BOOL; break;
+        default: operand = K_VAL; break;
+    }
+
+    //un operand care la executie poate avea alt tip decat cel static (void dupa o impartire la zero, sau
+    //rezultatul unei functii, al carei return nu e verificat) trece prin rt::typedBinary, ca nodurile tipizate
+    Expr left = expr(bin->left);
+    Expr right = expr(bin->right);
+    const char* staticType = nullptr;
+    if ((operand == K_INT || operand == K_FLOAT || operand == K_BOOL) && (left.kind == K_VAL || right.kind == K_VAL)) {
+        staticType = operand == K_INT ? "rt::INT, " : operand == K_FLOAT ? "rt::FLOAT, " : "rt::BOOL, ";
+        operand = K_VAL;
+    }
+    std::string l = as(left, operand);
+    std::string r = as(right, operand);
+    //C++ nu fixeaza ordinea operanzilor; daca unul are efecte, ii evaluam explicit de la stanga la dreapta
+    bool sequenced = hasEffects(bin->left) || hasEffects(bin->right);
+    auto combine = [&](const std::string& prefix, const std::string& infix, const std::string& suffix) {
+        if (!sequenced) return prefix + l + infix + r + suffix;
+        return "([&]() { auto l_ = " + l + "; auto r_ = " + r + "; return " + prefix + "l_" + infix + "r_" + suffix + "; }())";
+    };
+
+    if (bin->operand == VAL_ARRAY) return { combine(std::string("rt::arith(rt::") + binOpName(bin->op) + ", ", ", ", ")"), K_VAL };
+    if (staticType)
+        return { combine(std::string("rt::typedBinary(rt::") + binOpName(bin->op) + ", " + staticType, ", ", ")"), K_VAL };
+    if (operand == K_VAL) return { combine(std::string("rt::binary(rt::") + binOpName(bin->op) + ", ", ", ", ")"), K_VAL };
+
+    std::string symbol = std::string(" ") + binOpSymbol(bin->op) + " ";
+    if (isBoolResultOp(bin->op)) return { combine("(", symbol, ")"), K_BOOL };
+
+    if (bin->op == BIN_DIV) {
+        //impartirea la zero da void; un divizor literal nenul ramane nativ
+        literal_node* d = bin->right->kind == NODE_LITERAL ? static_cast<literal_node*>(bin->right) : nullptr;
+        bool nonzero = d && ((operand == K_INT && d->val.type == VAL_INT && d->val.i != 0) ||
+                             (operand == K_FLOAT && d->val.type == VAL_FLOAT && d->val.f != 0.0f));
+        if (nonzero) return { combine("(", symbol, ")"), operand };
+        return { combine(operand == K_INT ? "rt::divInt(" : "rt::divFloat(", ", ", ")"), K_VAL };
+    }
+    return { combine("(", symbol, ")"), operand };
+}
+
+CppEmitter::Expr CppEmitter::assign(assign_node* a, bool statement) {
+    Variable* v = variable(a->depth, a->slot);
+    if (!v) return expr(a->val);
+
+    //s = s + x + y devine (s += x) += y: sirul creste pe loc, fara copierea lui s la fiecare pas
+    if (v->kind == K_STR) {
+        std::vector<ast_node*> parts;
+        ast_node* n = a->val;
+        while (n && n->kind == NODE_BINARY) {
+            binary_expr_node* bin = static_cast<binary_expr_node*>(n);
+            if (bin->operand != VAL_STRING || bin->op != BIN_ADD || !bin->right) break;
+            parts.push_back(bin->right);
+            n = bin->left;
+        }
+        bool inPlace = !parts.empty() && n && n->kind == NODE_ID &&
+                       static_cast<id_node*>(n)->depth == a->depth && static_cast<id_node*>(n)->slot == a->slot;
+        for (auto p : parts)
+            if (hasEffects(p) || readsSlot(p, a->depth, a->slot)) inPlace = false;
+
+        if (inPlace) {
+            std::string code = ref(*v);
+            for (size_t i = parts.size(); i-- > 0;) {
+                if (i + 1 < parts.size()) code = "(" + code + ")";
+                code += " += " + as(expr(parts[i]), K_STR);
+            }
+            return { statement ? code : "(" + code + ")", K_STR };
+        }
+    }
+
+    std::string code = ref(*v) + " = " + as(expr(a->val), v->kind);
+    return { statement ? code : "(" + code + ")", v->kind };
+}
+
+void CppEmitter::line(const std::string& text) {
+    body.append(indent * 4, ' ');
+    body += text;
+    body += '\n';
+}
+
+void CppEmitter::stmt(ast_node* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NODE_BLOCK:
+            for (auto s : static_cast<block_node*>(node)->statements) stmt(s);
+            return;
+
+        case NODE_MAIN:
+            stmt(static_cast<main_node*>(node)->body);
+            return;
+
+        case NODE_VAR_DECL: {
+            var_decl_node* d = static_cast<var_decl_node*>(node);
+            Variable* v = variable(d->depth, d->slot);
+            class_def_node* c = d->init_val ? nullptr : classOf(d->class_id);
+            Expr value = d->init_val ? expr(d->init_val)
+                       : c ? Expr{ "rt::make<F_" + c->name + ">(init_" + c->name + ")", K_VAL }
+                       : Expr{ defaultFor(kindOf(d->type)), kindOf(d->type) };
+            if (v) line(ref(*v) + " = " + as(value, v->kind) + ";");
+            else if (d->init_val) line("(void)" + value.code + ";");
+            return;
+        }
+
+        //functiile si clasele nu se executa la definire
+        case NODE_FUNC_DEF:
+        case NODE_CLASS_DEF:
+            return;
+
+        case NODE_IF: {
+            if_node* i = static_cast<if_node*>(node);
+            line("if (" + condition(i->condition) + ") {");
+            indent++;
+            stmt(i->then_block);
+            indent--;
+            line("}");
+            return;
+        }
+
+        case NODE_WHILE: {
+            while_node* w = static_cast<while_node*>(node);
+            line("while (" + condition(w->condition) + ") {");
+            indent++;
+            stmt(w->body);
+            indent--;
+            line("}");
+            return;
+        }
+
+        //in main, return opreste programul
+        case NODE_RETURN: {
+            return_node* r = static_cast<return_node*>(node);
+            if (function) {
+                line("return " + as(r->expr ? expr(r->expr) : Expr{ "rt::Val()", K_VAL }, returns[frame - 1]) + ";");
+                return;
+            }
+            if (r->expr) line("(void)" + expr(r->expr).code + ";");
+            line("return;");
+            return;
+        }
+
+        case NODE_PRINT:
+            line("rt::print(" + expr(static_cast<print_node*>(node)->expr).code + ");");
+            return;
+
+        case NODE_ASSIGN:
+            line(assign(static_cast<assign_node*>(node), true).code + ";");
+            return;
+
+        default:
+            line("(void)" + expr(node).code + ";");
+            return;
+    }
+}
+
+//corpul functiei index: garda de adancime, apoi localele
+std::string CppEmitter::emitFunction(int index) {
+    func_def_node* f = table.at(index);
+    enter(index);
+    body.clear();
+    indent = 1;
+    std::string label = f->owner ? f->owner->name + "." + f->name : f->name;
+    line("rt::Frame frame_(\"" + label + "\");");
+    for (const auto& entry : variables) {
+        const Variable& v = entry.second;
+        if (v.frame == frame && (entry.first & 0xffffffff) >= f->param_names.size())
+            line(std::string(typeName(v.kind)) + " " + v.name + " = " + defaultFor(v.kind) + ";");
+    }
+    stmt(f->body);
+    Kind declared = kindOf(f->return_type);
+    line("return " + as(Expr{ defaultFor(declared), declared }, returns[index]) + ";");
+    std::string code = body;
+    enter(-1);
+    return code;
+}
+
+std::string CppEmitter::emit(program_node* program) {
+    variables.clear();
+    strings.clear();
+    body.clear();
+    indent = 1;
+    table = FunctionTable();
+    returns.clear();
+    fieldFrames.clear();
+    enter(-1);
+
+    std::vector<std::string> functions, inits;
+    std::string run;
+    if (program) {
+        table.collect(program);
+        collect(program);
+        for (int i = 0; i < table.size(); i++) {
+            func_def_node* f = table.at(i);
+            enter(i);
+            returns.push_back(kindOf(f->return_type));
+            for (size_t p = 0; p < f->param_names.size() && p < f->param_types.size(); p++) {
+                Variable& v = bind(f->depth, (int)p, f->param_names[p]);
+                v.kind = kindOf(&f->param_types[p]);
+                v.declared = true;
+            }
+            collect(f->body);
+        }
+        for (int i = 0; i < table.classCount(); i++) {
+            enterClass(table.classAt(i));
+            for (auto m : table.classAt(i)->members)
+                if (m && m->kind == NODE_VAR_DECL) collect(m);
+        }
+        enter(-1);
+        while (refineAll(program)) {}
+
+        for (auto g : program->globals) stmt(g);
+        stmt(program->main_block);
+        run = body;
+        for (int i = 0; i < table.size(); i++) functions.push_back(emitFunction(i));
+        for (int i = 0; i < table.classCount(); i++) {
+            enterClass(table.classAt(i));
+            body.clear();
+            indent = 1;
+            for (auto m : table.classAt(i)->members)
+                if (m && m->kind == NODE_VAR_DECL) stmt(m);
+            inits.push_back(body);
+        }
+        enter(-1);
+    }
+
+    std::string out = "// generat de comp --aot\n";
+    out += "#define RT_MAX_CALL_DEPTH " + std::to_string(MAX_CALL_DEPTH) + "\n";
+    out += "#define RT_MAX_ARRAY_LENGTH " + std::to_string(MAX_ARRAY_LENGTH) + "\n";
+    out += PRELUDE;
+
+    std::vector<const std::string*> texts(strings.size());
+    for (const auto& s : strings) texts[s.second] = &s.first;
+    for (size_t i = 0; i < texts.size(); i++) {
+        std::string lit;
+        for (unsigned char c : *texts[i]) {
+            //si '?' scapat, ca "??/" sau "??=" din sursa sa nu fie citite ca trigrafe
+            if (c == '"' || c == '\\' || c == '?') { lit += '\\'; lit += (char)c; }
+            else if (c >= 32 && c < 127) lit += (char)c;
+            else {
+                char esc[8];
+                std::snprintf(esc, sizeof esc, "\\%03o", c);
+                lit += esc;
+            }
+        }
+        out += "static const std::string str" + std::to_string(i) + "(\"" + lit + "\", " + std::to_string(texts[i]->size()) + ");\n";
+    }
+
+    //globalele (depth 0) sunt statice, localele lui main sunt locale in run(), campurile sunt membri in F_<clasa>
+    std::string locals;
+    std::map<int, std::string> members;
+    for (const auto& entry : variables) {
+        const Variable& v = entry.second;
+        std::string decl = std::string(typeName(v.kind)) + " " + v.name + " = " + defaultFor(v.kind) + ";\n";
+        if (v.depth == 0) out += "static " + decl;
+        else if (v.field) members[v.frame] += "    " + decl;
+        else if (v.frame == 0) locals += "    " + decl;
+    }
+
+    //fiecare clasa: structura campurilor si initializarea lor (in ordinea declararii, ca la interpretor)
+    for (int i = 0; i < table.classCount(); i++) {
+        class_def_node* c = table.classAt(i);
+        out += "\nstruct F_" + c->name + " {\n" + members[fieldFrame(c)] + "};\n";
+        out += "static void init_" + c->name + "(F_" + c->name + "* self_);\n";
+    }
+
+    std::vector<std::string> signatures;
+    for (int i = 0; i < table.size(); i++) {
+        func_def_node* f = table.at(i);
+        std::string sig = std::string("static ") + typeName(returns[i]) + " " + functionName(i) + "(";
+        if (f->owner) sig += "F_" + f->owner->name + "* self_";
+        for (size_t p = 0; p < f->param_names.size(); p++) {
+            Variable* v = parameter(i, (int)p);
+            sig += std::string(p || f->owner ? ", " : "") + typeName(v ? v->kind : K_VAL) + " " +
+                   (v ? v->name : "p" + std::to_string(p) + "_");
+        }
+        signatures.push_back(sig + ")");
+        out += signatures.back() + ";\n";
+    }
+
+    for (int i = 0; i < table.classCount(); i++) {
+        class_def_node* c = table.classAt(i);
+        out += "\nstatic void init_" + c->name + "(F_" + c->name + "* self_) {\n" + inits[i] + "}\n";
+    }
+
+    for (int i = 0; i < table.size(); i++) out += "\n" + signatures[i] + " {\n" + functions[i] + "}\n";
+
+    out += "\nstatic void run() {\n" + locals + run + "}\n\n";
+    out += "int main() {\n    run();\n    std::fflush(stdout);\n    return 0;\n}\n";
+    return out;
+}
+
+bool buildNative(const std::string& source, const std::string& exePath, std::string& error) {
+    std::string cppPath = exePath + ".cpp";
+    {
+        std::ofstream out(cppPath);
+        if (!out.is_open()) {
+            error = "cannot write '" + cppPath + "'";
+            return false;
+        }
+        out << source;
+        if (!out) {
+            error = "cannot write '" + cppPath + "'";
+            return false;
+        }
+    }
+
+    //-fwrapv: depasirea pe int se comporta ca in interpretor; -ffp-contract=off: fara FMA, aceleasi rotunjiri
+    const char* cxx = std::getenv("CXX");
+    std::string command = std::string(cxx && *cxx ? cxx : "g++") + " -std=c++17 -O2 -fwrapv -ffp-contract=off -o " +
+                          shellQuote(exePath) + " " + shellQuote(cppPath);
+    int status = std::system(command.c_str());
+    if (status != 0) {
+        error = "compilarea cu '" + command + "' a esuat";
+        return false;
+    }
+    return true;
+}
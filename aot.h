@@ -0,0 +1,95 @@
+#ifndef AOT_H
+#define AOT_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "bytecode.h"
+
+//compilare ahead-of-time: programul verificat devine o sursa C++ de sine statatoare, construita apoi cu g++.
+//Variabilele si expresiile al caror tip static e sigur (si care nu pot deveni void la executie) sunt
+//locale native int/float/bool/std::string; restul trec prin rt::Val, copia valorii dinamice din prelude.
+//Fiecare functie devine o functie C++ cu parametri si rezultat nativi cand toate apelurile o permit.
+//Un obiect e o structura F_<clasa> cu campurile native, tinuta intr-un rt::Val (shared_ptr, alocat din pool);
+//metodele il primesc ca self_. Tablourile sunt rt::Array (tot prin rt::Val), cu operatiile scalare din prelude.
+//Iesirea executabilului e identica cu cea a interpretorului.
+class CppEmitter {
+public:
+    //reprezentarea C++ a unei expresii
+    enum Kind { K_INT, K_FLOAT, K_BOOL, K_STR, K_VAL };
+
+    struct Expr {
+        std::string code;
+        Kind kind;
+    };
+
+    std::string emit(program_node* program);
+
+private:
+    struct Variable {
+        std::string name; //identificatorul C++
+        Kind kind = K_VAL;
+        bool declared = false;
+        int frame = 0, depth = 0;
+        bool field = false;  //membru in F_<clasa>, accesat prin self_
+        bool object = false; //locala care tine mereu un obiect (niciodata void): acces direct, fara verificare
+    };
+
+    //cadrele: 0 = globalele si main, 1 + i = functia i din table, apoi campurile fiecarei clase
+    std::map<long, Variable> variables; //cheie: (cadru, depth, slot)
+    std::map<std::string, int> strings; //literalii sir, emisi o singura data ca statice
+    std::string body;
+    int indent = 1;
+
+    FunctionTable table;
+    std::vector<Kind> returns;                //tipul rezultatului fiecarei functii
+    std::map<class_def_node*, int> fieldFrames;
+    int frame = 0;                            //cadrul functiei curente
+    func_def_node* function = nullptr;        //functia curenta (nullptr in main si la initializarea campurilor)
+    class_def_node* owner = nullptr;          //clasa ale carei campuri sunt la depth 1
+
+    static long key(int frame, int depth, int slot) { return (long)frame << 40 | (long)depth << 32 | (unsigned)slot; }
+    int frameOf(int depth);
+    int fieldFrame(class_def_node* c);
+    void enter(int index);
+    void enterClass(class_def_node* c);
+    Variable& bind(int depth, int slot, const std::string& name);
+    Variable* variable(int depth, int slot);
+    Variable* parameter(int index, int param);
+    Variable* field(int classId, int slot);
+    class_def_node* classOf(int classId) const;
+    bool isObject(ast_node* node);
+    static std::string ref(const Variable& v) { return v.field ? "self_->" + v.name : v.name; }
+    std::string functionName(int index) const;
+
+    void collect(ast_node* node);
+    void declare(var_decl_node* decl);
+    bool refine(ast_node* node);
+    bool refineAll(program_node* program);
+
+    static Kind kindOf(const TypeInfo* type);
+    static std::string defaultFor(Kind kind);
+    static bool hasEffects(ast_node* node);
+    static bool readsSlot(ast_node* node, int depth, int slot);
+
+    std::string stringLiteral(const std::string& text);
+    std::string as(const Expr& e, Kind kind);
+    std::string condition(ast_node* node);
+    Expr expr(ast_node* node);
+    Expr binary(binary_expr_node* bin);
+    Expr assign(assign_node* a, bool statement = false);
+    Expr call(int index, ast_node* receiver, const node_list& args);
+    Expr dot(dot_node* d);
+    Expr memberAssign(member_assign_node* m);
+    std::string runtime(const std::string& function, const std::vector<ast_node*>& args, bool native = false);
+
+    void line(const std::string& text);
+    void stmt(ast_node* node);
+    std::string emitFunction(int index);
+};
+
+//scrie sursa si o compileaza cu g++ (sau $CXX); false si mesajul de eroare daca nu reuseste
+bool buildNative(const std::string& source, const std::string& exePath, std::string& error);
+
+#endif
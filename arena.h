@@ -0,0 +1,141 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//alocator bump pentru tot ce produce o compilare (noduri AST, TypeInfo, siruri din lexer, liste).
+//Memoria se elibereaza intr-un singur pas cu release(); destructorii ne-triviali se ruleaza in ordine inversa.
+class Arena {
+    struct Block {
+        Block* next;
+        size_t size;
+        size_t used;
+        alignas(std::max_align_t) char data[1];
+    };
+
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* obj;
+        Finalizer* next;
+    };
+
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    Block* head = nullptr;
+    Finalizer* finalizers = nullptr;
+    size_t bytesAllocated = 0;
+
+    inline static thread_local Arena* active = nullptr;
+
+    Block* newBlock(size_t minSize) {
+        size_t size = minSize > BLOCK_SIZE ? minSize : BLOCK_SIZE;
+        Block* b = (Block*)std::malloc(offsetof(Block, data) + size);
+        if (!b) throw std::bad_alloc();
+        b->next = head;
+        b->size = size;
+        b->used = 0;
+        head = b;
+        return b;
+    }
+
+public:
+    Arena() {}
+    ~Arena() { release(); }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        Block* b = head;
+        size_t offset = 0;
+        if (b) offset = (b->used + align - 1) & ~(align - 1);
+        if (!b || offset + size > b->size) {
+            b = newBlock(size + align);
+            offset = 0;
+        }
+        b->used = offset + size;
+        bytesAllocated += size;
+        return b->data + offset;
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        void* mem = allocate(sizeof(T), alignof(T));
+        T* obj = new (mem) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            Finalizer* f = (Finalizer*)allocate(sizeof(Finalizer), alignof(Finalizer));
+            f->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+            f->obj = obj;
+            f->next = finalizers;
+            finalizers = f;
+        }
+        return obj;
+    }
+
+    //ruleaza destructorii si elibereaza toate blocurile
+    void release() {
+        for (Finalizer* f = finalizers; f; f = f->next) f->destroy(f->obj);
+        finalizers = nullptr;
+        while (head) {
+            Block* next = head->next;
+            std::free(head);
+            head = next;
+        }
+        bytesAllocated = 0;
+    }
+
+    size_t bytesUsed() const { return bytesAllocated; }
+
+    //arena in care aloca parserul si lexerul pe thread-ul curent
+    static Arena* current() { return active; }
+
+    //seteaza arena curenta pe durata unui bloc
+    class Scope {
+        Arena* previous;
+    public:
+        explicit Scope(Arena& a) : previous(active) { active = &a; }
+        ~Scope() { active = previous; }
+    };
+};
+
+//aloca in arena curenta; fara arena activa se foloseste heap-ul (obiectul nu mai e eliberat automat)
+template <typename T, typename... Args>
+inline T* arenaNew(Args&&... args) {
+    if (Arena* a = Arena::current()) return a->make<T>(std::forward<Args>(args)...);
+    return new T(std::forward<Args>(args)...);
+}
+
+//alocator STL peste arena curenta, pentru listele construite de parser
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    Arena* arena;
+
+    ArenaAllocator() : arena(Arena::current()) {}
+    explicit ArenaAllocator(Arena* a) : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        if (arena) return (T*)arena->allocate(n * sizeof(T), alignof(T));
+        return (T*)::operator new(n * sizeof(T));
+    }
+    void deallocate(T* p, size_t) {
+        if (!arena) ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& o) const { return arena == o.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& o) const { return arena != o.arena; }
+};
+
+template <typename T>
+using arena_vector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
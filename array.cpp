@@ -0,0 +1,323 @@
+#include "array.h"
+#include "output.h"
+#include <cstring>
+#include <string>
+#include <new>
+
+//nucleele SIMD: AVX2 sau SSE2 dupa flagurile de compilare (ex. CXXFLAGS="-O2 -mavx2"); -DARRAY_NO_SIMD pentru
+//varianta scalara. Pe int, inmultirea, min si max au nevoie de SSE4.1 (cu SSE2 simplu raman scalare).
+//Rezultatele sunt aceleasi in toate variantele: pe float, reducerile pastreaza ordinea canonica (vezi array.h)
+#if !defined(ARRAY_NO_SIMD) && defined(__AVX2__)
+#define ARRAY_LANES 8
+#include <immintrin.h>
+#elif !defined(ARRAY_NO_SIMD) && defined(__SSE2__)
+#define ARRAY_LANES 4
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#endif
+
+//fara FMA: a * b + c se rotunjeste de doua ori, ca in varianta scalara si in codul AOT
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+
+//pe int, operatiile se fac modulo 2^32 (ca adunarea pe registre), fara comportament nedefinit la depasire
+template <ArrayOp OP>
+inline int apply(int a, int b) {
+    unsigned x = (unsigned)a, y = (unsigned)b;
+    if constexpr (OP == ARRAY_ADD) return (int)(x + y);
+    else if constexpr (OP == ARRAY_SUB) return (int)(x - y);
+    else return (int)(x * y);
+}
+
+template <ArrayOp OP>
+inline float apply(float a, float b) {
+    if constexpr (OP == ARRAY_ADD) return a + b;
+    else if constexpr (OP == ARRAY_SUB) return a - b;
+    else return a * b;
+}
+
+//pasul unei reduceri: sum si dot aduna, min / max aleg ca minps / maxps
+template <ArrayFn FN, typename T>
+inline T combine(T acc, T x) {
+    if constexpr (FN == ARRAY_MIN) return acc < x ? acc : x;
+    else if constexpr (FN == ARRAY_MAX) return acc > x ? acc : x;
+    else return apply<ARRAY_ADD>(acc, x);
+}
+
+template <ArrayFn FN, typename T>
+inline T term(const T* a, const T* b, int k) {
+    if constexpr (FN == ARRAY_DOT) return apply<ARRAY_MUL>(a[k], b[k]);
+    else return a[k];
+}
+
+#ifdef ARRAY_LANES
+template <typename T> struct Simd;
+
+#if ARRAY_LANES == 8
+template <> struct Simd<float> {
+    typedef __m256 V;
+    static const bool MUL = true, MIN_MAX = true;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V splat(float x) { return _mm256_set1_ps(x); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+};
+
+template <> struct Simd<int> {
+    typedef __m256i V;
+    static const bool MUL = true, MIN_MAX = true;
+    static V load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V splat(int x) { return _mm256_set1_epi32(x); }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+    static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+};
+#else
+template <> struct Simd<float> {
+    typedef __m128 V;
+    static const bool MUL = true, MIN_MAX = true;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V splat(float x) { return _mm_set1_ps(x); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+};
+
+template <> struct Simd<int> {
+    typedef __m128i V;
+#ifdef __SSE4_1__
+    static const bool MUL = true, MIN_MAX = true;
+    static V mul(V a, V b) { return _mm_mullo_epi32(a, b); }
+    static V min(V a, V b) { return _mm_min_epi32(a, b); }
+    static V max(V a, V b) { return _mm_max_epi32(a, b); }
+#else
+    static const bool MUL = false, MIN_MAX = false;
+    static V mul(V a, V) { return a; }
+    static V min(V a, V) { return a; }
+    static V max(V a, V) { return a; }
+#endif
+    static V load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(int* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V splat(int x) { return _mm_set1_epi32(x); }
+    static V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+};
+#endif
+
+template <typename T, ArrayOp OP>
+inline typename Simd<T>::V applyLanes(typename Simd<T>::V a, typename Simd<T>::V b) {
+    if constexpr (OP == ARRAY_ADD) return Simd<T>::add(a, b);
+    else if constexpr (OP == ARRAY_SUB) return Simd<T>::sub(a, b);
+    else return Simd<T>::mul(a, b);
+}
+
+//acumulatorii canonici (8 valori, in 8 / ARRAY_LANES registre) pe blocurile [k, end); intoarce unde a ajuns
+template <ArrayFn FN, typename T>
+int reduceLanes(const T* a, const T* b, T* lane, int k, int end) {
+    typedef Simd<T> S;
+    if constexpr ((FN == ARRAY_DOT && !S::MUL) || ((FN == ARRAY_MIN || FN == ARRAY_MAX) && !S::MIN_MAX)) return k;
+    const int parts = 8 / ARRAY_LANES;
+    typename S::V acc[parts];
+    for (int p = 0; p < parts; p++) acc[p] = S::load(lane + p * ARRAY_LANES);
+    for (; k < end; k += 8) {
+        for (int p = 0; p < parts; p++) {
+            typename S::V x = S::load(a + k + p * ARRAY_LANES);
+            if constexpr (FN == ARRAY_DOT) x = S::mul(x, S::load(b + k + p * ARRAY_LANES));
+            if constexpr (FN == ARRAY_MIN) acc[p] = S::min(acc[p], x);
+            else if constexpr (FN == ARRAY_MAX) acc[p] = S::max(acc[p], x);
+            else acc[p] = S::add(acc[p], x);
+        }
+    }
+    for (int p = 0; p < parts; p++) S::store(lane + p * ARRAY_LANES, acc[p]);
+    return k;
+}
+#endif
+
+//ordinea canonica din array.h; pe int orice ordine da acelasi rezultat, dar o pastram si acolo
+template <ArrayFn FN, typename T>
+T reduce(const T* a, const T* b, int n) {
+    const bool extreme = FN == ARRAY_MIN || FN == ARRAY_MAX;
+    int k = 0;
+    T r;
+    if (extreme && n < 8) {
+        r = a[0];
+        k = 1;
+    }
+    else {
+        T lane[8];
+        for (int j = 0; j < 8; j++) lane[j] = extreme ? a[j] : T();
+        if (extreme) k = 8;
+        int end = n - n % 8;
+#ifdef ARRAY_LANES
+        k = reduceLanes<FN>(a, b, lane, k, end);
+#endif
+        for (; k < end; k += 8)
+            for (int j = 0; j < 8; j++) lane[j] = combine<FN>(lane[j], term<FN>(a, b, k + j));
+        r = combine<FN>(combine<FN>(combine<FN>(lane[0], lane[4]), combine<FN>(lane[2], lane[6])),
+                        combine<FN>(combine<FN>(lane[1], lane[5]), combine<FN>(lane[3], lane[7])));
+    }
+    for (; k < n; k++) r = combine<FN>(r, term<FN>(a, b, k));
+    return r;
+}
+
+template <typename T>
+Value reduce(ArrayFn fn, const T* a, const T* b, int n) {
+    switch (fn) {
+        case ARRAY_SUM: return Value(reduce<ARRAY_SUM>(a, b, n));
+        case ARRAY_MIN: return Value(reduce<ARRAY_MIN>(a, b, n));
+        case ARRAY_MAX: return Value(reduce<ARRAY_MAX>(a, b, n));
+        case ARRAY_DOT: return Value(reduce<ARRAY_DOT>(a, b, n));
+        default: return Value();
+    }
+}
+
+//out[k] = l[k] op r[k]; un operand scalar (L / R false) e l[0], respectiv r[0], pentru toate elementele
+template <typename T, ArrayOp OP, bool L, bool R>
+void elementwise(const T* l, const T* r, T* out, int n) {
+    int k = 0;
+#ifdef ARRAY_LANES
+    typedef Simd<T> S;
+    if constexpr (OP != ARRAY_MUL || S::MUL) {
+        typename S::V lv = S::splat(l[0]), rv = S::splat(r[0]);
+        for (; k + ARRAY_LANES <= n; k += ARRAY_LANES) {
+            if constexpr (L) lv = S::load(l + k);
+            if constexpr (R) rv = S::load(r + k);
+            S::store(out + k, applyLanes<T, OP>(lv, rv));
+        }
+    }
+#endif
+    for (; k < n; k++) out[k] = apply<OP>(L ? l[k] : l[0], R ? r[k] : r[0]);
+}
+
+template <typename T, ArrayOp OP>
+void elementwise(const T* l, bool leftArray, const T* r, bool rightArray, T* out, int n) {
+    if (leftArray && rightArray) elementwise<T, OP, true, true>(l, r, out, n);
+    else if (leftArray) elementwise<T, OP, true, false>(l, r, out, n);
+    else elementwise<T, OP, false, true>(l, r, out, n);
+}
+
+template <typename T>
+void elementwise(ArrayOp op, const T* l, bool leftArray, const T* r, bool rightArray, T* out, int n) {
+    switch (op) {
+        case ARRAY_ADD: elementwise<T, ARRAY_ADD>(l, leftArray, r, rightArray, out, n); return;
+        case ARRAY_SUB: elementwise<T, ARRAY_SUB>(l, leftArray, r, rightArray, out, n); return;
+        case ARRAY_MUL: elementwise<T, ARRAY_MUL>(l, leftArray, r, rightArray, out, n); return;
+    }
+}
+
+size_t elementSize(ValueType elem) {
+    return elem == VAL_BOOL ? sizeof(bool) : elem == VAL_INT ? sizeof(int) : sizeof(float);
+}
+
+//elementele raman neinitializate; cine creeaza tabloul le scrie pe toate
+Array* allocate(ValueType elem, int n) {
+    void* p = ::operator new(sizeof(Array) + n * elementSize(elem), std::align_val_t(alignof(Array)));
+    Array* a = static_cast<Array*>(p);
+    a->refs = 0;
+    a->elem = elem;
+    a->length = n;
+    return a;
+}
+
+}
+
+void releaseArray(Array* a) {
+    ::operator delete(a, std::align_val_t(alignof(Array)));
+}
+
+const char* arrayFnName(ArrayFn fn) {
+    static const char* names[] = { "length", "sum", "min", "max", "dot" };
+    return names[fn];
+}
+
+bool arrayIndexError(int index, int length) {
+    runtimeError("array index " + std::to_string(index) + " out of bounds (length " + std::to_string(length) + ")");
+    return false;
+}
+
+bool arrayLengthError(int left, int right) {
+    runtimeError("array length mismatch (" + std::to_string(left) + " and " + std::to_string(right) + ")");
+    return false;
+}
+
+bool newArray(ValueType elem, const Value& n, Value& out) {
+    out = Value();
+    if (n.type != VAL_INT) return true;
+    if (n.i < 0 || n.i > MAX_ARRAY_LENGTH) {
+        runtimeError("invalid array length " + std::to_string(n.i));
+        return false;
+    }
+    Array* a = allocate(elem, n.i);
+    std::memset(a + 1, 0, n.i * elementSize(elem));
+    out = Value(a);
+    return true;
+}
+
+Value arrayLiteral(ValueType elem, const Value* items, int count) {
+    Array* a = allocate(elem, count);
+    for (int k = 0; k < count; k++) setArrayElement(a, k, items[k]);
+    return Value(a);
+}
+
+bool arrayReduce(ArrayFn fn, const Value& a, const Value& b, Value& out) {
+    out = Value();
+    if (a.type != VAL_ARRAY) return true;
+    Array* x = a.arr;
+    if (fn == ARRAY_LENGTH) {
+        out = Value(x->length);
+        return true;
+    }
+    if (x->elem == VAL_BOOL) return true;
+
+    Array* y = nullptr;
+    if (fn == ARRAY_DOT) {
+        if (b.type != VAL_ARRAY || b.arr->elem != x->elem) return true;
+        y = b.arr;
+        if (y->length != x->length) return arrayLengthError(x->length, y->length);
+    }
+    if ((fn == ARRAY_MIN || fn == ARRAY_MAX) && x->length == 0) return true;
+
+    if (x->elem == VAL_INT) out = reduce<int>(fn, x->ints(), y ? y->ints() : nullptr, x->length);
+    else out = reduce<float>(fn, x->floats(), y ? y->floats() : nullptr, x->length);
+    return true;
+}
+
+bool arrayArith(ArrayOp op, const Value& l, const Value& r, Value& out) {
+    out = Value();
+    Array* la = l.type == VAL_ARRAY ? l.arr : nullptr;
+    Array* ra = r.type == VAL_ARRAY ? r.arr : nullptr;
+    if (!la && !ra) return true;
+
+    //celalalt operand: tablou cu acelasi tip de elemente sau scalar de tipul elementelor; altfel (void) void
+    ValueType elem = la ? la->elem : ra->elem;
+    if (elem == VAL_BOOL) return true;
+    if (la ? la->elem != elem : l.type != elem) return true;
+    if (ra ? ra->elem != elem : r.type != elem) return true;
+    if (la && ra && la->length != ra->length) return arrayLengthError(la->length, ra->length);
+
+    int n = la ? la->length : ra->length;
+    Array* res = allocate(elem, n);
+    if (elem == VAL_INT)
+        elementwise<int>(op, la ? la->ints() : &l.i, la, ra ? ra->ints() : &r.i, ra, res->ints(), n);
+    else
+        elementwise<float>(op, la ? la->floats() : &l.f, la, ra ? ra->floats() : &r.f, ra, res->floats(), n);
+    out = Value(res);
+    return true;
+}
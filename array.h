@@ -0,0 +1,78 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include "value.h"
+
+//operatiile pe tablouri, comune interpretorului pe arbore si VM-ului (codul AOT are o copie scalara, cu aceeasi
+//ordine a operatiilor). O eroare (indice in afara limitelor, lungimi diferite, lungime invalida) se afiseaza la
+//stderr, iar functia intoarce false: programul se opreste, ca la depasirea adancimii de apeluri.
+//Un tablou void (declarat fara initializare) sau un operand void dau void, fara eroare.
+
+//cel mult atatea elemente; i + pas ramane in int in buclele fara verificari de limite (vezi ir_passes.cpp)
+const int MAX_ARRAY_LENGTH = 1 << 28;
+
+//metodele predefinite: a.length(), a.sum(), a.min(), a.max(), a.dot(b)
+enum ArrayFn { ARRAY_LENGTH, ARRAY_SUM, ARRAY_MIN, ARRAY_MAX, ARRAY_DOT };
+
+//operatiile element cu element, in ordinea din BinOp
+enum ArrayOp { ARRAY_ADD, ARRAY_SUB, ARRAY_MUL };
+
+const char* arrayFnName(ArrayFn fn);
+
+//mesajele de eroare; intorc false
+bool arrayIndexError(int index, int length);
+bool arrayLengthError(int left, int right);
+
+//elem[n] cu elementele zero; n void da un tablou void
+bool newArray(ValueType elem, const Value& n, Value& out);
+//[v0, v1, ...]; o valoare de alt tip decat elem (de ex. void) da elementul zero
+Value arrayLiteral(ValueType elem, const Value* items, int count);
+
+//elementul k, fara verificari
+inline Value arrayElement(Array* a, int k) {
+    if (a->elem == VAL_INT) return Value(a->ints()[k]);
+    if (a->elem == VAL_FLOAT) return Value(a->floats()[k]);
+    return Value(a->bools()[k]);
+}
+
+inline void setArrayElement(Array* a, int k, const Value& v) {
+    bool same = v.type == a->elem;
+    if (a->elem == VAL_INT) a->ints()[k] = same ? v.i : 0;
+    else if (a->elem == VAL_FLOAT) a->floats()[k] = same ? v.f : 0.0f;
+    else a->bools()[k] = same && v.b;
+}
+
+//a[i]
+inline bool arrayGet(const Value& a, const Value& i, Value& out) {
+    if (a.type != VAL_ARRAY || i.type != VAL_INT) {
+        out = Value();
+        return true;
+    }
+    if ((unsigned)i.i >= (unsigned)a.arr->length) return arrayIndexError(i.i, a.arr->length);
+    out = arrayElement(a.arr, i.i);
+    return true;
+}
+
+//a[i] = v; intr-un tablou void nu se scrie nimic
+inline bool arraySet(const Value& a, const Value& i, const Value& v) {
+    if (a.type != VAL_ARRAY || i.type != VAL_INT) return true;
+    if ((unsigned)i.i >= (unsigned)a.arr->length) return arrayIndexError(i.i, a.arr->length);
+    setArrayElement(a.arr, i.i, v);
+    return true;
+}
+
+inline Value arrayLength(const Value& a) {
+    return a.type == VAL_ARRAY ? Value(a.arr->length) : Value();
+}
+
+//fn pe a (b doar pentru dot). Pe float, suma, produsul scalar, min si max se calculeaza in ordinea canonica:
+//8 acumulatori, acumulatorul j ia elementele j, j + 8, ... (la min / max pornesc de la primele 8 elemente),
+//apoi ((l0 . l4) . (l2 . l6)) . ((l1 . l5) . (l3 . l7)) si restul elementelor pe rand; sub 8 elemente,
+//min / max merg pe rand de la primul. min e a < b ? a : b (ca minps), max e a > b ? a : b.
+//min / max pe un tablou gol dau void
+bool arrayReduce(ArrayFn fn, const Value& a, const Value& b, Value& out);
+
+//l op r, cu cel putin un operand tablou int[] / float[]; un scalar se aplica fiecarui element
+bool arrayArith(ArrayOp op, const Value& l, const Value& r, Value& out);
+
+#endif
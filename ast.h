@@ -8,37 +8,98 @@
 #include "value.h"
 #include "symbol_table.h"
 #include "SymTableStub.h"
+#include "arena.h"
+#include "stats.h"
+#include "profiler.h"
+#include "object.h"
+#include "array.h"
 
 using namespace std;
 
+class ast_node;
+
+//listele de noduri folosesc memoria arenei in care a fost construit arborele
+typedef arena_vector<ast_node*> node_list;
+
+//eticheta de tip a nodului, folosita in loc de lanturi de dynamic_cast
+enum NodeKind {
+    NODE_GENERIC,
+    NODE_PROGRAM, NODE_BLOCK, NODE_MAIN, NODE_VAR_DECL, NODE_FUNC_DEF, NODE_CLASS_DEF,
+    NODE_IF, NODE_WHILE, NODE_RETURN, NODE_PRINT,
+    NODE_ASSIGN, NODE_MEMBER_ASSIGN, NODE_BINARY, NODE_LITERAL, NODE_ID,
+    NODE_CALL, NODE_DOT, NODE_METHOD_CALL,
+    NODE_ARRAY_NEW, NODE_ARRAY_LITERAL, NODE_INDEX, NODE_INDEX_ASSIGN, NODE_ARRAY_CALL
+};
+
+inline const char* nodeKindName(NodeKind k) {
+    static const char* names[] = {
+        "node", "program", "block", "main", "var_decl", "func_def", "class_def",
+        "if", "while", "return", "print",
+        "assign", "member_assign", "binary", "literal", "id",
+        "call", "dot", "method_call",
+        "array_new", "array_literal", "index", "index_assign", "array_call"
+    };
+    return names[k];
+}
+
+//la inceputul fiecarui eval: contorul din --stats si cronometrul din --profile (inactive implicit)
+#define EVAL_ENTER() STAT_INC(evalVisits); ProfileScope profileScope_(this)
+
+class id_node;
+
 class ast_node {
 public:
+    NodeKind kind;
+    //tipul static, calculat o singura data cand se construieste nodul (vezi annotateType in inferType.h)
+    TypeInfo static_type;
+    bool typed;
+    //prima variabila nedeclarata din subarbore, raportata o singura data de inferType
+    id_node* unresolved;
+    int line; //linia din sursa a regulii care a construit nodul
+
+    //linia primita de nodurile noi; parserul o actualizeaza inaintea fiecarei actiuni (YYLLOC_DEFAULT)
+    inline static thread_local int constructionLine = 0;
+
+    ast_node(NodeKind k = NODE_GENERIC) : kind(k), typed(false), unresolved(nullptr), line(constructionLine) { STAT_INC(nodes); }
     virtual ~ast_node() {}
+
+    void setType(const TypeInfo& t) {
+        static_type = t;
+        typed = true;
+    }
     
-    virtual Value eval(void* scope) {
+    virtual Value eval(void*) {
         return Value();
     }
 };
 
 class program_node : public ast_node {
 public:
-    vector<ast_node*> globals;
+    node_list globals;
     ast_node* main_block;
+    int global_slots; //numarul de variabile globale
 
-    program_node() : main_block(nullptr) {}
+    program_node() : ast_node(NODE_PROGRAM), main_block(nullptr), global_slots(0) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        if (st) st->enterFrame(0, global_slots);
         for (auto g : globals) {
             if (g) g->eval(scope);
         }
-        if (main_block) return main_block->eval(scope);
-        return Value();
+        Value v;
+        if (main_block) v = main_block->eval(scope);
+        if (st) st->leaveFrame(0);
+        return v;
     }
 };
 
 class block_node : public ast_node {
 public:
-    vector<ast_node*> statements;
+    node_list statements;
+
+    block_node() : ast_node(NODE_BLOCK) {}
 
     void addStatement(ast_node* stmt) {
         if (stmt) {
@@ -47,12 +108,14 @@ public:
     }
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
         Value last;
         for (auto s : statements) {
             if (!s) continue;
             
             last = s->eval(scope);
-            if (last.hasReturn) {
+            if (st && st->completion != COMPLETION_NORMAL) {
                 return last;
             }
         }
@@ -63,14 +126,18 @@ public:
 class main_node : public ast_node {
 public:
     block_node* body;
+    int frame_slots; //numarul de variabile locale din main
 
-    main_node(block_node* b) : body(b) {}
+    main_node(block_node* b, int slots = 0) : ast_node(NODE_MAIN), body(b), frame_slots(slots) {}
 
     Value eval(void* scope) override {
-        if (body) {
-            return body->eval(scope);
-        }
-        return Value();
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        if (st) st->enterFrame(1, frame_slots);
+        Value v;
+        if (body) v = body->eval(scope);
+        if (st) st->leaveFrame(1);
+        return v;
     }
 };
 
@@ -79,60 +146,174 @@ public:
     TypeInfo* type;
     string name;
     ast_node* init_val;
+    int depth, slot; //rezolvate la parsare din SymbolInfo
+    int class_id;    //clasa instantiata de `A a;` (-1: fara obiect, ca un camp de tipul clasei care il contine)
 
     var_decl_node(TypeInfo* t, string n, ast_node* init = nullptr) 
-        : type(t), name(n), init_val(init) {}
-
-    Value eval(void* scope) override {
-        SymTableStub* st = (SymTableStub*)scope;
-        if (!st) return Value();
+        : ast_node(NODE_VAR_DECL), type(t), name(n), init_val(init), depth(-1), slot(-1), class_id(-1) {}
 
-        Value v;
-        if (init_val) {
-            v = init_val->eval(scope);
-        } else {
-            if (type && type->type == TYPE_INT) v = Value(0);
-            else if (type && type->type == TYPE_FLOAT) v = Value(0.0f);
-            else if (type && type->type == TYPE_BOOL) v = Value(false);
-            else if (type && type->type == TYPE_STRING) v = Value(std::string(""));
-            else v = Value();
-        }
-        st->setValue(name, v);
-        return v;
-    }
+    Value eval(void* scope) override;
 };
 
+class class_def_node;
+
 class func_def_node : public ast_node {
 public:
     TypeInfo* return_type;
     string name;
     std::vector<std::string> param_names; 
     block_node* body;
+    int name_id;
+    std::vector<TypeInfo> param_types;
+    int depth, frame_slots;   //adancimea scope-ului functiei si cate sloturi are cadrul (parametrii primii)
+    class_def_node* owner;    //clasa, pentru metode
 
     func_def_node(TypeInfo* type, std::string n, std::vector<std::string> params, block_node* b)
-        : return_type(type), name(n), param_names(params), body(b) {}
+        : ast_node(NODE_FUNC_DEF), return_type(type), name(n), param_names(params), body(b),
+          name_id(-1), depth(1), frame_slots((int)params.size()), owner(nullptr) {}
+
+    //metodele le inregistreaza clasa
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        if (st && !owner) st->defineFunction(name_id, this);
+        return Value();
+    }
 
-    Value eval(void* scope) override { return Value(); }
+    Value defaultResult() const {
+        if (!return_type) return Value();
+        if (return_type->type == TYPE_INT) return Value(0);
+        if (return_type->type == TYPE_FLOAT) return Value(0.0f);
+        if (return_type->type == TYPE_BOOL) return Value(false);
+        if (return_type->type == TYPE_STRING) return Value(std::string(""));
+        return Value();
+    }
+
+    //executa corpul intr-un cadru nou; argumentele se evalueaza in cadrul apelantului.
+    //receiver: obiectul pe care e apelata metoda (nullptr: functie, sau metoda pe obiectul curent)
+    Value invoke(SymTableStub* st, const node_list& args, const Value* receiver);
 };
 
 class class_def_node : public ast_node {
 public:
     string name;
-    vector<ast_node*> members;
+    node_list members;
+    int class_id;
+    int field_slots;
+    //campurile initializate doar cu constante se copiaza dintr-un obiect model, fara sa se mai evalueze
+    bool constant_fields;
+    std::vector<Value> defaults;
+
+    class_def_node(string n)
+        : ast_node(NODE_CLASS_DEF), name(n), class_id(-1), field_slots(0), constant_fields(false) {}
+
+    //dupa fold: fiecare camp porneste de la valoarea implicita sau de la un literal, fara obiecte incuibate
+    bool hasConstantFields() const {
+        for (auto m : members) {
+            if (!m || m->kind != NODE_VAR_DECL) continue;
+            var_decl_node* d = static_cast<var_decl_node*>(m);
+            if (d->class_id >= 0 || (d->init_val && d->init_val->kind != NODE_LITERAL)) return false;
+        }
+        return true;
+    }
 
-    class_def_node(string n) : name(n) {}
-    
-    Value eval(void* scope) override { return Value(); }
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        if (!st) return Value();
+        for (auto m : members)
+            if (m && m->kind == NODE_FUNC_DEF) {
+                func_def_node* f = static_cast<func_def_node*>(m);
+                st->defineMethod(class_id, f->name_id, f);
+            }
+        st->defineClass(class_id, this);
+        constant_fields = hasConstantFields();
+        defaults.clear();
+        return Value();
+    }
+
+    //un obiect nou: inregistrarea din pool, apoi initializarea campurilor (declaratiile lor, legate la adancimea 1)
+    Value instantiate(SymTableStub* st) {
+        Value o = newObject(field_slots);
+        Value* fields = o.obj->fields();
+        if (constant_fields && (int)defaults.size() == field_slots) {
+            for (int k = 0; k < field_slots; k++) fields[k] = defaults[k];
+            return o;
+        }
+        SymTableStub::FrameBinding saved = st->bindFrame(1, fields);
+        for (auto m : members)
+            if (m && m->kind == NODE_VAR_DECL) m->eval(st);
+        st->unbindFrame(1, saved);
+        if (constant_fields) defaults.assign(fields, fields + field_slots);
+        return o;
+    }
 };
 
+inline Value var_decl_node::eval(void* scope) {
+    EVAL_ENTER();
+    SymTableStub* st = (SymTableStub*)scope;
+    if (!st) return Value();
+
+    Value v;
+    if (init_val) {
+        v = init_val->eval(scope);
+    } else {
+        if (type && type->type == TYPE_INT) v = Value(0);
+        else if (type && type->type == TYPE_FLOAT) v = Value(0.0f);
+        else if (type && type->type == TYPE_BOOL) v = Value(false);
+        else if (type && type->type == TYPE_STRING) v = Value(std::string(""));
+        else if (class_def_node* c = st->classDef(class_id)) v = c->instantiate(st);
+        else v = Value();
+    }
+    if (slot >= 0) {
+        STAT_INC(stubWrites);
+        st->slot(depth, slot) = v;
+    }
+    return v;
+}
+
+inline Value func_def_node::invoke(SymTableStub* st, const node_list& args, const Value* receiver) {
+    if (st->completion == COMPLETION_ABORT) return Value();
+    size_t base = st->allocFrame(frame_slots);
+    for (size_t i = 0; i < args.size(); i++) {
+        Value v = args[i]->eval(st);
+        if ((int)i < (int)param_names.size()) st->at(base + i) = std::move(v);
+    }
+    //metoda pe void (camp neinitializat) nu se executa: rezultatul e void
+    bool noObject = receiver && (receiver->type != VAL_OBJECT || !owner);
+    if (st->completion == COMPLETION_ABORT || noObject || st->callDepth >= MAX_CALL_DEPTH) {
+        if (st->completion != COMPLETION_ABORT && !noObject) {
+            reportCallDepth(owner ? owner->name + "." + name : name);
+            st->completion = COMPLETION_ABORT;
+        }
+        st->freeFrames(base);
+        return Value();
+    }
+
+    SymTableStub::FrameBinding savedFields{};
+    if (receiver) savedFields = st->bindFrame(1, receiver->obj->fields());
+    SymTableStub::FrameBinding savedLocals = st->bindFrame(depth, base);
+    st->callDepth++;
+
+    Value result = body->eval(st);
+    if (st->completion == COMPLETION_RETURN) st->completion = COMPLETION_NORMAL;
+    else if (st->completion == COMPLETION_NORMAL) result = defaultResult();
+
+    st->callDepth--;
+    st->unbindFrame(depth, savedLocals);
+    if (receiver) st->unbindFrame(1, savedFields);
+    st->freeFrames(base);
+    return result;
+}
 class if_node : public ast_node {
 public:
     ast_node* condition;
     ast_node* then_block;
 
-    if_node(ast_node* c, ast_node* t) : condition(c), then_block(t) {}
+    if_node(ast_node* c, ast_node* t) : ast_node(NODE_IF), condition(c), then_block(t) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
         Value c = condition->eval(scope);
         if (c.type == VAL_BOOL && c.b) {
             return then_block ? then_block->eval(scope) : Value();
@@ -146,9 +327,11 @@ public:
     ast_node* condition;
     ast_node* body;
 
-    while_node(ast_node* c, ast_node* b) : condition(c), body(b) {}
+    while_node(ast_node* c, ast_node* b) : ast_node(NODE_WHILE), condition(c), body(b) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
         Value last;
         while (true) {
             Value c = condition->eval(scope);
@@ -156,7 +339,7 @@ public:
 
             if (body) {
                 last = body->eval(scope);
-                if (last.hasReturn) return last;
+                if (st && st->completion != COMPLETION_NORMAL) return last;
             }
         }
         return last;
@@ -167,14 +350,16 @@ class return_node : public ast_node {
 public:
     ast_node* expr;
 
-    return_node(ast_node* e = nullptr) : expr(e) {}
+    return_node(ast_node* e = nullptr) : ast_node(NODE_RETURN), expr(e) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
         Value v;
         if (expr) {
             v = expr->eval(scope);
         }
-        v.hasReturn = true;
+        if (st && st->completion != COMPLETION_ABORT) st->completion = COMPLETION_RETURN;
         return v;
     }
 };
@@ -182,15 +367,20 @@ public:
 class assign_node : public ast_node {
 public:
     string name;
+    int name_id;
     ast_node* val;
+    int depth, slot;
 
-    assign_node(string n, ast_node* v) : name(n), val(v) {}
+    assign_node(const InternedName* n, ast_node* v)
+        : ast_node(NODE_ASSIGN), name(n->text), name_id(n->id), val(v), depth(-1), slot(-1) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
         SymTableStub* st = (SymTableStub*)scope;
         Value rhs = val->eval(scope);
-        if (st) {
-            st->setValue(name, rhs);
+        if (st && slot >= 0) {
+            STAT_INC(stubWrites);
+            st->slot(depth, slot) = rhs;
         }
         return rhs;
     }
@@ -200,142 +390,364 @@ class member_assign_node : public ast_node {
 public:
     ast_node* obj;
     string member;
+    int member_id;
     ast_node* val;
 
-    member_assign_node(ast_node* o, string m, ast_node* v) : obj(o), member(m), val(v) {}
+    int class_id, slot; //clasa statica a obiectului si slotul campului, rezolvate la parsare.
+                        //Verificarea de tipuri garanteaza ca un obiect aflat aici e din class_id.
+
+    member_assign_node(ast_node* o, const InternedName* m, ast_node* v)
+        : ast_node(NODE_MEMBER_ASSIGN), obj(o), member(m->text), member_id(m->id), val(v), class_id(-1), slot(-1) {}
 
     Value eval(void* scope) override {
-        if (val) return val->eval(scope);
-        return Value();
+        EVAL_ENTER();
+        Value o = obj->eval(scope);
+        Value v = val->eval(scope);
+        if (slot >= 0 && o.type == VAL_OBJECT) {
+            STAT_INC(stubWrites);
+            o.obj->fields()[slot] = v;
+        }
+        return v;
     }
 };
 
+enum BinOp {
+    BIN_ADD, BIN_SUB, BIN_MUL, BIN_DIV,
+    BIN_LT, BIN_GT, BIN_LE, BIN_GE, BIN_EQ, BIN_NE,
+    BIN_AND, BIN_OR, BIN_NOT
+};
+
+inline const char* binOpSymbol(BinOp op) {
+    static const char* symbols[] = { "+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!=", "&&", "||", "!" };
+    return symbols[op];
+}
+
+//operatorii care produc bool indiferent de tipul operanzilor
+inline bool isBoolResultOp(BinOp op) {
+    return op >= BIN_LT;
+}
+
+//varianta generica: alege operatia dupa tipul valorii din stanga, la executie.
+//Se foloseste doar cand tipul operanzilor nu e cunoscut la parsare.
 class binary_expr_node : public ast_node {
 public:
-    string op;
+    BinOp op;
     ast_node* left;
     ast_node* right;
+    ValueType operand; //tipul operanzilor pentru nodurile specializate, VAL_VOID pentru cel generic
 
-    binary_expr_node(string o, ast_node* l, ast_node* r) : op(o), left(l), right(r) {}
+    binary_expr_node(BinOp o, ast_node* l, ast_node* r) : ast_node(NODE_BINARY), op(o), left(l), right(r), operand(VAL_VOID) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
         Value leftVal = left->eval(scope);
 
         if (right == nullptr) {
-            if (op == "!") {
-                if (leftVal.type == VAL_BOOL) return Value(!leftVal.b);
-            }
+            if (op == BIN_NOT && leftVal.type == VAL_BOOL) return Value(!leftVal.b);
             return Value();
         }
 
         Value rightVal = right->eval(scope);
 
-        if (op == "+") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i + rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f + rightVal.f);
-            if (leftVal.type == VAL_STRING) return Value(leftVal.s + rightVal.s);
-        }
-        if (op == "-") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i - rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f - rightVal.f);
-        }
-        if (op == "*") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i * rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f * rightVal.f);
-        }
-        if (op == "/") {
-            if (leftVal.type == VAL_INT) {
-                if (rightVal.i == 0) return Value();
-                return Value(leftVal.i / rightVal.i);
-            }
-            if (leftVal.type == VAL_FLOAT) {
-                if (rightVal.f == 0.0f) return Value();
-                return Value(leftVal.f / rightVal.f);
-            }
-        }
-        if (op == "<") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i < rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f < rightVal.f);
-        }
-        if (op == ">") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i > rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f > rightVal.f);
-        }
-        if (op == "<=") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i <= rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f <= rightVal.f);
-        }
-        if (op == ">=") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i >= rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f >= rightVal.f);
+        switch (op) {
+            case BIN_ADD:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i + rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f + rightVal.f);
+                if (leftVal.type == VAL_STRING) return Value::concat(leftVal, rightVal);
+                break;
+            case BIN_SUB:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i - rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f - rightVal.f);
+                break;
+            case BIN_MUL:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i * rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f * rightVal.f);
+                break;
+            case BIN_DIV:
+                if (leftVal.type == VAL_INT) {
+                    if (rightVal.i == 0) return Value();
+                    return Value(leftVal.i / rightVal.i);
+                }
+                if (leftVal.type == VAL_FLOAT) {
+                    if (rightVal.f == 0.0f) return Value();
+                    return Value(leftVal.f / rightVal.f);
+                }
+                break;
+            case BIN_LT:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i < rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f < rightVal.f);
+                break;
+            case BIN_GT:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i > rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f > rightVal.f);
+                break;
+            case BIN_LE:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i <= rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f <= rightVal.f);
+                break;
+            case BIN_GE:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i >= rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f >= rightVal.f);
+                break;
+            case BIN_EQ:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i == rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f == rightVal.f);
+                if (leftVal.type == VAL_BOOL) return Value(leftVal.b == rightVal.b);
+                if (leftVal.type == VAL_STRING) return Value(leftVal.s() == rightVal.s());
+                break;
+            case BIN_NE:
+                if (leftVal.type == VAL_INT) return Value(leftVal.i != rightVal.i);
+                if (leftVal.type == VAL_FLOAT) return Value(leftVal.f != rightVal.f);
+                if (leftVal.type == VAL_BOOL) return Value(leftVal.b != rightVal.b);
+                if (leftVal.type == VAL_STRING) return Value(leftVal.s() != rightVal.s());
+                break;
+            default:
+                break;
         }
-        if (op == "==") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i == rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f == rightVal.f);
-            if (leftVal.type == VAL_BOOL) return Value(leftVal.b == rightVal.b);
-            if (leftVal.type == VAL_STRING) return Value(leftVal.s == rightVal.s);
-        }
-        if (op == "!=") {
-            if (leftVal.type == VAL_INT) return Value(leftVal.i != rightVal.i);
-            if (leftVal.type == VAL_FLOAT) return Value(leftVal.f != rightVal.f);
-            if (leftVal.type == VAL_BOOL) return Value(leftVal.b != rightVal.b);
-            if (leftVal.type == VAL_STRING) return Value(leftVal.s != rightVal.s);
-        }
-        if (op == "&&" && leftVal.type == VAL_BOOL) return Value(leftVal.b && rightVal.b);
-        if (op == "||" && leftVal.type == VAL_BOOL) return Value(leftVal.b || rightVal.b);
-
         return Value();
     }
 };
 
-class literal_node : public ast_node {
+//noduri specializate pe tipul operanzilor, construite dupa ce verificarea de tipuri a trecut.
+//Tipul e cel static al nodului: un operand stang de alt tip (void dupa o impartire la zero, sau orice tip
+//intors de o functie, caci return-ul nu e verificat) da void, la fel un operand drept de alt tip decat void;
+//un drept void se citeste ca 0, ca in varianta generica
+template <BinOp OP>
+class int_binary_node : public binary_expr_node {
 public:
-    string val;
+    int_binary_node(ast_node* l, ast_node* r) : binary_expr_node(OP, l, r) { operand = VAL_INT; }
 
-    literal_node(string v) : val(v) {}
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        Value l = left->eval(scope);
+        Value r = right->eval(scope);
+        if (l.type != VAL_INT || (r.type != VAL_INT && r.type != VAL_VOID)) return Value();
+        int a = l.i, b = r.i;
+        if constexpr (OP == BIN_ADD) return Value(a + b);
+        else if constexpr (OP == BIN_SUB) return Value(a - b);
+        else if constexpr (OP == BIN_MUL) return Value(a * b);
+        else if constexpr (OP == BIN_DIV) return b == 0 ? Value() : Value(a / b);
+        else if constexpr (OP == BIN_LT) return Value(a < b);
+        else if constexpr (OP == BIN_GT) return Value(a > b);
+        else if constexpr (OP == BIN_LE) return Value(a <= b);
+        else if constexpr (OP == BIN_GE) return Value(a >= b);
+        else if constexpr (OP == BIN_EQ) return Value(a == b);
+        else return Value(a != b);
+    }
+};
+
+template <BinOp OP>
+class float_binary_node : public binary_expr_node {
+public:
+    float_binary_node(ast_node* l, ast_node* r) : binary_expr_node(OP, l, r) { operand = VAL_FLOAT; }
 
     Value eval(void* scope) override {
-        if (val == "true") return Value(true);
-        if (val == "false") return Value(false);
-        if (val.find("\"") != string::npos) {
-            string s = val;
-            if(s.size() >= 2) s = s.substr(1, s.size()-2);
-            return Value(s);
-        }
-        bool isFloat = (val.find('.') != string::npos);
-        if (isFloat) return Value(std::stof(val));
-        return Value(std::stoi(val));
+        EVAL_ENTER();
+        Value l = left->eval(scope);
+        Value r = right->eval(scope);
+        if (l.type != VAL_FLOAT || (r.type != VAL_FLOAT && r.type != VAL_VOID)) return Value();
+        float a = l.f, b = r.f;
+        if constexpr (OP == BIN_ADD) return Value(a + b);
+        else if constexpr (OP == BIN_SUB) return Value(a - b);
+        else if constexpr (OP == BIN_MUL) return Value(a * b);
+        else if constexpr (OP == BIN_DIV) return b == 0.0f ? Value() : Value(a / b);
+        else if constexpr (OP == BIN_LT) return Value(a < b);
+        else if constexpr (OP == BIN_GT) return Value(a > b);
+        else if constexpr (OP == BIN_LE) return Value(a <= b);
+        else if constexpr (OP == BIN_GE) return Value(a >= b);
+        else if constexpr (OP == BIN_EQ) return Value(a == b);
+        else return Value(a != b);
+    }
+};
+
+//BIN_ADD = concatenare, BIN_EQ / BIN_NE = comparatie
+template <BinOp OP>
+class string_binary_node : public binary_expr_node {
+public:
+    string_binary_node(ast_node* l, ast_node* r) : binary_expr_node(OP, l, r) { operand = VAL_STRING; }
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        Value a = left->eval(scope);
+        Value b = right->eval(scope);
+        if constexpr (OP == BIN_ADD) return Value::concat(a, b);
+        else if constexpr (OP == BIN_EQ) return Value(a.s() == b.s());
+        else return Value(a.s() != b.s());
+    }
+};
+
+template <BinOp OP>
+class bool_binary_node : public binary_expr_node {
+public:
+    bool_binary_node(ast_node* l, ast_node* r) : binary_expr_node(OP, l, r) { operand = VAL_BOOL; }
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        Value l = left->eval(scope);
+        Value r = right->eval(scope);
+        if (l.type != VAL_BOOL || (r.type != VAL_BOOL && r.type != VAL_VOID)) return Value();
+        bool a = l.b, b = r.b;
+        if constexpr (OP == BIN_EQ) return Value(a == b);
+        else return Value(a != b);
+    }
+};
+
+//&& si || cu scurtcircuitare: dreapta se evalueaza doar daca stanga nu decide rezultatul.
+//Un operand stang care nu e bool da void, ca in varianta generica.
+class logical_node : public binary_expr_node {
+public:
+    logical_node(BinOp o, ast_node* l, ast_node* r) : binary_expr_node(o, l, r) { operand = VAL_BOOL; }
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        Value l = left->eval(scope);
+        if (l.type != VAL_BOOL) return Value();
+        if (op == BIN_AND ? !l.b : l.b) return l;
+        Value r = right->eval(scope);
+        return Value(r.type == VAL_BOOL && r.b);
+    }
+};
+
+//o eroare a unui tablou (mesajul e deja afisat) opreste programul
+inline Value abortProgram(SymTableStub* st) {
+    if (st) st->completion = COMPLETION_ABORT;
+    return Value();
+}
+
+//dupa o oprire nu se mai raporteaza alte erori: VM-ul s-ar fi oprit la prima
+inline bool aborted(SymTableStub* st) {
+    return st && st->completion == COMPLETION_ABORT;
+}
+
+//+ - * pe int[] / float[], element cu element (nucleele din array.cpp); unul dintre operanzi poate fi un scalar
+//de tipul elementelor. Rezultatul e un tablou nou
+class array_binary_node : public binary_expr_node {
+public:
+    array_binary_node(BinOp o, ast_node* l, ast_node* r) : binary_expr_node(o, l, r) { operand = VAL_ARRAY; }
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        Value a = left->eval(scope);
+        Value b = right->eval(scope);
+        Value v;
+        if (aborted(st)) return Value();
+        if (!arrayArith((ArrayOp)op, a, b, v)) return abortProgram(st);
+        return v;
+    }
+};
+
+template <template <BinOp> class Node>
+inline ast_node* make_typed_binary(BinOp op, ast_node* l, ast_node* r) {
+    switch (op) {
+        case BIN_ADD: return arenaNew<Node<BIN_ADD>>(l, r);
+        case BIN_SUB: return arenaNew<Node<BIN_SUB>>(l, r);
+        case BIN_MUL: return arenaNew<Node<BIN_MUL>>(l, r);
+        case BIN_DIV: return arenaNew<Node<BIN_DIV>>(l, r);
+        case BIN_LT: return arenaNew<Node<BIN_LT>>(l, r);
+        case BIN_GT: return arenaNew<Node<BIN_GT>>(l, r);
+        case BIN_LE: return arenaNew<Node<BIN_LE>>(l, r);
+        case BIN_GE: return arenaNew<Node<BIN_GE>>(l, r);
+        case BIN_EQ: return arenaNew<Node<BIN_EQ>>(l, r);
+        case BIN_NE: return arenaNew<Node<BIN_NE>>(l, r);
+        default: return nullptr;
+    }
+}
+
+//alege nodul specializat pentru tipul (comun) al operanzilor; daca nu exista unul, nodul generic
+inline ast_node* make_binary_node(BinOp op, ast_node* l, ast_node* r, TipBaza operandType) {
+    if (op == BIN_AND || op == BIN_OR) return arenaNew<logical_node>(op, l, r);
+    if (op == BIN_NOT || !r) return arenaNew<binary_expr_node>(op, l, r);
+
+    switch (operandType) {
+        case TYPE_INT:
+            return make_typed_binary<int_binary_node>(op, l, r);
+        case TYPE_FLOAT:
+            return make_typed_binary<float_binary_node>(op, l, r);
+        case TYPE_STRING:
+            if (op == BIN_ADD) return arenaNew<string_binary_node<BIN_ADD>>(l, r);
+            if (op == BIN_EQ) return arenaNew<string_binary_node<BIN_EQ>>(l, r);
+            if (op == BIN_NE) return arenaNew<string_binary_node<BIN_NE>>(l, r);
+            break;
+        case TYPE_BOOL:
+            if (op == BIN_EQ) return arenaNew<bool_binary_node<BIN_EQ>>(l, r);
+            if (op == BIN_NE) return arenaNew<bool_binary_node<BIN_NE>>(l, r);
+            break;
+        default:
+            break;
+    }
+    return arenaNew<binary_expr_node>(op, l, r);
+}
+
+//literal deja decodat de lexer: valoarea si tipul sunt fixate la parsare
+class literal_node : public ast_node {
+public:
+    Value val;
+
+    literal_node(const Value& v, TipBaza t) : ast_node(NODE_LITERAL), val(v) { setType(TypeInfo(t)); }
+
+    Value eval(void*) override {
+        EVAL_ENTER();
+        return val;
     }
 };
 
 class id_node : public ast_node {
 public:
     string name;
+    int name_id;
+    int depth, slot;
+    bool reported; //eroarea "variabila nedeclarata" a fost deja afisata
 
-    id_node(string n) : name(n) {}
+    id_node(const InternedName* n)
+        : ast_node(NODE_ID), name(n->text), name_id(n->id), depth(-1), slot(-1), reported(false) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
         SymTableStub* st = (SymTableStub*)scope;
-        if (!st) return Value();
-        return st->getValue(name);
+        if (!st || slot < 0) return Value();
+        STAT_INC(stubReads);
+        return st->slot(depth, slot);
+    }
+};
+
+//tinta rezolvata a unui apel, pastrata in nod dupa prima cautare. Doar pentru tabela in care a fost gasita:
+//o functie inca nedefinita (apelata din initializarea unei globale) se cauta din nou la urmatorul apel
+class CallTarget {
+    const SymTableStub* table = nullptr;
+    func_def_node* function = nullptr;
+
+public:
+    func_def_node* get(const SymTableStub* st) const { return st == table ? function : nullptr; }
+    func_def_node* set(const SymTableStub* st, func_def_node* f) {
+        if (f) {
+            table = st;
+            function = f;
+        }
+        return f;
     }
 };
 
 class call_node : public ast_node {
 public:
     string func_name;
-    vector<ast_node*> args;
+    int func_id;
+    node_list args;
     TypeInfo ret_type;
+    int class_id; //-1: functie globala; altfel metoda clasei curente, apelata fara obiect
+    CallTarget target;
 
-    call_node(string n, vector<ast_node*> a, TypeInfo rt)
-        : func_name(n), args(a), ret_type(rt) {}
+    call_node(const InternedName* n, node_list a, const TypeInfo& rt, int cls = -1)
+        : ast_node(NODE_CALL), func_name(n->text), func_id(n->id), args(std::move(a)), ret_type(rt), class_id(cls) {}
 
     Value eval(void* scope) override {
-        if (ret_type.type == TYPE_INT) return Value(0);
-        if (ret_type.type == TYPE_FLOAT) return Value(0.0f);
-        if (ret_type.type == TYPE_BOOL) return Value(false);
-        if (ret_type.type == TYPE_STRING) return Value(std::string(""));
-        return Value();
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        if (!st) return Value();
+        func_def_node* f = target.get(st);
+        if (!f) f = target.set(st, class_id < 0 ? st->function(func_id) : st->method(class_id, func_id));
+        if (!f) return Value();
+        return f->invoke(st, args, nullptr);
     }
 };
 
@@ -343,11 +755,19 @@ class dot_node : public ast_node {
 public:
     ast_node* obj;
     string member;
+    int member_id;
 
-    dot_node(ast_node* o, string m) : obj(o), member(m) {}
+    int class_id, slot; //ca la member_assign_node
+
+    dot_node(ast_node* o, const InternedName* m)
+        : ast_node(NODE_DOT), obj(o), member(m->text), member_id(m->id), class_id(-1), slot(-1) {}
 
     Value eval(void* scope) override {
-        return Value();
+        EVAL_ENTER();
+        Value o = obj->eval(scope);
+        if (slot < 0 || o.type != VAL_OBJECT) return Value();
+        STAT_INC(stubReads);
+        return o.obj->fields()[slot];
     }
 };
 
@@ -355,13 +775,126 @@ class method_call_node : public ast_node {
 public:
     ast_node* obj;
     std::string method;
-    std::vector<ast_node*> args;
+    int method_id;
+    node_list args;
+    int class_id; //clasa statica a obiectului (-1 daca nu e cunoscuta)
+    CallTarget target;
 
-    method_call_node(ast_node* o, const std::string& m, std::vector<ast_node*> a)
-        : obj(o), method(m), args(std::move(a)) {}
+    method_call_node(ast_node* o, const InternedName* m, node_list a, int cls = -1)
+        : ast_node(NODE_METHOD_CALL), obj(o), method(m->text), method_id(m->id), args(std::move(a)), class_id(cls) {}
 
     Value eval(void* scope) override {
-        return Value();
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        if (!st) return Value();
+        func_def_node* f = target.get(st);
+        if (!f) f = target.set(st, st->method(class_id, method_id));
+        if (!f) return Value();
+        Value receiver = obj->eval(scope); //tinut in viata pe durata apelului
+        return f->invoke(st, args, &receiver);
+    }
+};
+
+//tipul valorilor de executie pentru elementele unui tablou (verificat la parsare: int, float sau bool)
+inline ValueType elementValueType(TipBaza t) {
+    return t == TYPE_FLOAT ? VAL_FLOAT : t == TYPE_BOOL ? VAL_BOOL : VAL_INT;
+}
+
+//int[n], float[n], bool[n]: tablou nou, cu elementele zero
+class array_new_node : public ast_node {
+public:
+    TipBaza element;
+    ast_node* size;
+
+    array_new_node(TipBaza e, ast_node* n) : ast_node(NODE_ARRAY_NEW), element(e), size(n) {}
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        Value n = size->eval(scope);
+        Value a;
+        if (aborted(st)) return Value();
+        if (!newArray(elementValueType(element), n, a)) return abortProgram(st);
+        return a;
+    }
+};
+
+//[e0, e1, ...]: un tablou nou la fiecare evaluare, cu tipul elementelor fixat la parsare
+class array_literal_node : public ast_node {
+public:
+    TipBaza element;
+    node_list items;
+
+    array_literal_node(TipBaza e, node_list i) : ast_node(NODE_ARRAY_LITERAL), element(e), items(std::move(i)) {}
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        std::vector<Value> values;
+        values.reserve(items.size());
+        for (auto i : items) values.push_back(i->eval(scope));
+        return arrayLiteral(elementValueType(element), values.data(), (int)values.size());
+    }
+};
+
+//a[i]: tabloul, apoi indicele
+class index_node : public ast_node {
+public:
+    ast_node* arr;
+    ast_node* index;
+
+    index_node(ast_node* a, ast_node* i) : ast_node(NODE_INDEX), arr(a), index(i) {}
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        Value a = arr->eval(scope);
+        Value i = index->eval(scope);
+        Value v;
+        if (aborted(st)) return Value();
+        if (!arrayGet(a, i, v)) return abortProgram(st);
+        return v;
+    }
+};
+
+//a[i] = v: tabloul, indicele, apoi valoarea; rezultatul e valoarea
+class index_assign_node : public ast_node {
+public:
+    ast_node* arr;
+    ast_node* index;
+    ast_node* val;
+
+    index_assign_node(ast_node* a, ast_node* i, ast_node* v) : ast_node(NODE_INDEX_ASSIGN), arr(a), index(i), val(v) {}
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        Value a = arr->eval(scope);
+        Value i = index->eval(scope);
+        Value v = val->eval(scope);
+        if (aborted(st)) return Value();
+        if (!arraySet(a, i, v)) return abortProgram(st);
+        return v;
+    }
+};
+
+//a.length(), a.sum(), a.min(), a.max(), a.dot(b)
+class array_call_node : public ast_node {
+public:
+    ast_node* arr;
+    ArrayFn fn;
+    ast_node* arg; //b pentru dot, altfel nullptr
+
+    array_call_node(ast_node* a, ArrayFn f, ast_node* b) : ast_node(NODE_ARRAY_CALL), arr(a), fn(f), arg(b) {}
+
+    Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = (SymTableStub*)scope;
+        Value a = arr->eval(scope);
+        Value b = arg ? arg->eval(scope) : Value();
+        Value v;
+        if (aborted(st)) return Value();
+        if (!arrayReduce(fn, a, b, v)) return abortProgram(st);
+        return v;
     }
 };
 
@@ -369,11 +902,13 @@ class print_node : public ast_node {
 public:
     ast_node* expr;
 
-    print_node(ast_node* e) : expr(e) {}
+    print_node(ast_node* e) : ast_node(NODE_PRINT), expr(e) {}
 
     Value eval(void* scope) override {
+        EVAL_ENTER();
+        SymTableStub* st = static_cast<SymTableStub*>(scope);
         Value v = expr->eval(scope);
-        cout << v.toString() << endl;
+        if (st->completion != COMPLETION_ABORT) st->out->printLine(v);
         return v;
     }
 };
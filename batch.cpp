@@ -0,0 +1,106 @@
+#include "batch.h"
+#include "compilation.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+//un director se expandeaza in fisierele lui (nerecursiv), in ordine alfabetica
+static std::vector<std::string> expandInputs(const std::vector<std::string>& inputs) {
+    std::vector<std::string> files;
+    for (const auto& in : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(in, ec)) {
+            std::vector<std::string> dir;
+            for (const auto& e : fs::directory_iterator(in, ec))
+                if (e.is_regular_file()) dir.push_back(e.path().string());
+            std::sort(dir.begin(), dir.end());
+            files.insert(files.end(), dir.begin(), dir.end());
+        }
+        else files.push_back(in);
+    }
+    return files;
+}
+
+//numele fisierelor de iesire: pozitia in lot (unica, completata cu zerouri ca sa se sorteze in ordinea intrarilor),
+//apoi calea cu '/' inlocuit, doar ca sa fie usor de recunoscut (a/b.txt si a_b.txt dau acelasi rest)
+static std::string outputStem(size_t index, size_t count, const std::string& path) {
+    std::string name = path;
+    for (char& c : name) if (c == '/' || c == '\\') c = '_';
+    while (!name.empty() && (name[0] == '.' || name[0] == '_')) name.erase(0, 1);
+    std::ostringstream stem;
+    stem << std::setfill('0') << std::setw((int)std::to_string(count).size()) << index << '_'
+         << (name.empty() ? "input" : name);
+    return stem.str();
+}
+
+static void compileOne(BatchResult& r, const std::string& stem) {
+    auto start = std::chrono::steady_clock::now();
+
+    MappedSource source;
+    if (source.open(r.path)) {
+        r.opened = true;
+        CompilationContext ctx;
+        r.parsed = ctx.parse(source);
+        source.close();
+        r.errors = ctx.semantic_errors;
+
+        std::ofstream diag(stem + ".diag");
+        ctx.printDiagnostics(diag);
+        if (r.parsed) {
+            std::ofstream tables(stem + ".tables.txt");
+            ctx.scopes.dumpAllScopes(tables);
+        }
+    }
+
+    r.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int runBatch(const std::vector<std::string>& inputs, const BatchOptions& options) {
+    std::vector<std::string> files = expandInputs(inputs);
+    std::vector<BatchResult> results(files.size());
+
+    std::error_code ec;
+    fs::create_directories(options.outDir, ec);
+    if (ec) {
+        std::cerr << "Nu pot crea directorul " << options.outDir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    unsigned jobs = options.jobs ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    WorkStealingPool pool(std::min<size_t>(jobs, std::max<size_t>(files.size(), 1)));
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < files.size(); i++) {
+        results[i].path = files[i];
+        BatchResult* r = &results[i];
+        std::string stem = (fs::path(options.outDir) / outputStem(i, files.size(), files[i])).string();
+        pool.submit([r, stem] { compileOne(*r, stem); });
+    }
+    pool.run();
+    double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    //rezumatul, in ordinea intrarilor
+    std::ostringstream summary;
+    int failed = 0;
+    double cpu = 0;
+    summary << std::fixed << std::setprecision(3);
+    for (const auto& r : results) {
+        const char* status = !r.opened ? "NEGASIT" : !r.parsed ? "SINTAXA" : r.errors ? "ERORI" : "OK";
+        if (!r.opened || !r.parsed || r.errors) failed++;
+        cpu += r.millis;
+        summary << status << "\t" << r.errors << "\t" << r.millis << " ms\t" << r.path << "\n";
+    }
+    summary << "Total: " << results.size() << " fisiere, " << failed << " cu erori, "
+            << pool.size() << " thread-uri, " << wall << " ms (suma timpilor " << cpu << " ms)\n";
+
+    std::ofstream(fs::path(options.outDir) / "summary.txt") << summary.str();
+    std::cout << summary.str();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+
+//optiunile modului --batch
+struct BatchOptions {
+    unsigned jobs = 0;            //0 = cate nuclee are masina
+    std::string outDir = "batch_out";
+};
+
+//rezultatul compilarii unui singur fisier din lot
+struct BatchResult {
+    std::string path;
+    bool opened = false;
+    bool parsed = false;
+    int errors = 0;
+    double millis = 0;
+};
+
+//compileaza si verifica fiecare fisier pe un pool de thread-uri. Pentru fiecare fisier scrie in
+//outDir diagnosticele (<pozitie>_<cale>.diag) si tabelele de simboluri (<pozitie>_<cale>.tables.txt),
+//apoi un rezumat cu timpii (summary.txt, tiparit si la stdout). Intoarce 0 daca toate sunt corecte.
+int runBatch(const std::vector<std::string>& inputs, const BatchOptions& options);
+
+#endif
@@ -0,0 +1,85 @@
+// Microbenchmark pentru tablouri: nucleele din array.cpp (elemente contigue, SSE2 / AVX2)
+// vs. aceleasi operatii pe un std::vector<Value> (elementele ca valori etichetate).
+//
+//   g++ -O2 -I. bench/array_bench.cpp array.cpp value.cpp -o array_bench && ./array_bench
+//   g++ -O2 -mavx2 -I. bench/array_bench.cpp array.cpp value.cpp -o array_bench && ./array_bench
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "array.h"
+
+template <typename F>
+static double timeIt(const char* name, long ops, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    std::printf("%-28s %8.3f ns/elem %10.1f Melem/s\n", name, ns / ops, ops * 1e3 / ns);
+    return ns;
+}
+
+static Value boxedAdd(const Value& l, const Value& r) {
+    if (l.type == VAL_INT) return Value(l.i + r.i);
+    if (l.type == VAL_FLOAT) return Value(l.f + r.f);
+    return Value();
+}
+
+static Value boxedMul(const Value& l, const Value& r) {
+    if (l.type == VAL_INT) return Value(l.i * r.i);
+    if (l.type == VAL_FLOAT) return Value(l.f * r.f);
+    return Value();
+}
+
+static void runSuite(const char* label, ValueType elem, const Value& seed) {
+    const int N = 4096;
+    const int ROUNDS = 2000;
+    std::string n = label;
+
+    Value a, b;
+    newArray(elem, Value(N), a);
+    newArray(elem, Value(N), b);
+    for (int k = 0; k < N; k++) {
+        setArrayElement(a.arr, k, seed);
+        setArrayElement(b.arr, k, seed);
+    }
+    std::vector<Value> va(N, seed), vb(N, seed), vd(N);
+
+    volatile int sink = 0;
+    timeIt((n + " boxed add").c_str(), (long)N * ROUNDS, [&] {
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) vd[k] = boxedAdd(va[k], vb[k]);
+    });
+    timeIt((n + " array add").c_str(), (long)N * ROUNDS, [&] {
+        Value out;
+        for (int r = 0; r < ROUNDS; r++) arrayArith(ARRAY_ADD, a, b, out);
+        sink = out.arr->length;
+    });
+    timeIt((n + " boxed dot").c_str(), (long)N * ROUNDS, [&] {
+        Value acc;
+        for (int r = 0; r < ROUNDS; r++) {
+            acc = boxedMul(va[0], vb[0]);
+            for (int k = 1; k < N; k++) acc = boxedAdd(acc, boxedMul(va[k], vb[k]));
+        }
+        sink = acc.i;
+    });
+    timeIt((n + " array dot").c_str(), (long)N * ROUNDS, [&] {
+        Value out;
+        for (int r = 0; r < ROUNDS; r++) arrayReduce(ARRAY_DOT, a, b, out);
+        sink = out.i;
+    });
+    timeIt((n + " array max").c_str(), (long)N * ROUNDS, [&] {
+        Value out;
+        for (int r = 0; r < ROUNDS; r++) arrayReduce(ARRAY_MAX, a, Value(), out);
+        sink = out.i;
+    });
+    (void)sink;
+}
+
+int main() {
+    std::printf("sizeof(Array) = %zu, alignof(Array) = %zu\n\n", sizeof(Array), alignof(Array));
+    runSuite("int", VAL_INT, Value(3));
+    runSuite("float", VAL_FLOAT, Value(1.5f));
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Test de stres pentru compilari concurente: acelasi set de programe (cele din workload.h, la dimensiuni mici,
+// un program cu erori semantice si fisierele date in linia de comanda) e compilat si rulat pe arbore, pe VM si
+// prin IR, intai pe un singur thread (referinta), apoi de --jobs ori in paralel pe WorkStealingPool.
+// Fiecare job are CompilationContext-ul si StreamSink-ul lui; iesirea si diagnosticele trebuie sa fie identice
+// cu referinta. Programele nu trebuie sa aiba erori la executie (acelea merg direct la std::cerr).
+//
+//   bison -d comp.y && flex comp.l
+//   g++ -O2 -pthread -I. -DCOMP_NO_MAIN bench/concurrent_stress.cpp comp.tab.c lex.yy.c value.cpp array.cpp bytecode.cpp vm.cpp fold.cpp ir.cpp ir_passes.cpp aot.cpp compilation.cpp source_file.cpp output.cpp -o concurrent_stress
+//   ./concurrent_stress [--jobs N] [--threads T] [program.txt...]      ex: ./concurrent_stress input_corect.txt input_gresit.txt
+//   (cu -fsanitize=thread in loc de -O2 pentru a cauta si curse de date)
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "compilation.h"
+#include "thread_pool.h"
+#include "workload.h"
+
+struct Program {
+    std::string name;
+    std::string source;
+};
+
+struct Result {
+    bool parsed = false;
+    std::string diagnostics;
+    std::string output;
+
+    bool operator==(const Result& o) const {
+        return parsed == o.parsed && diagnostics == o.diagnostics && output == o.output;
+    }
+};
+
+static const ExecMode MODES[] = { EXEC_TREE, EXEC_VM, EXEC_IR };
+static const char* MODE_NAMES[] = { "tree", "vm", "ir" };
+
+static Result compileAndRun(const Program& p, ExecMode mode) {
+    Result r;
+    CompilationContext ctx;
+    r.parsed = ctx.parse(p.source.data(), p.source.size());
+    std::ostringstream diag;
+    ctx.printDiagnostics(diag);
+    r.diagnostics = diag.str();
+    std::ostringstream out;
+    {
+        StreamSink sink(out);
+        ctx.execute(mode, sink);
+    }
+    r.output = out.str();
+    return r;
+}
+
+static std::vector<Program> programs(const std::vector<std::string>& files) {
+    std::vector<Program> all;
+    for (const auto& kind : workload::kinds()) {
+        int size = kind.defaultSize / 100 > 10 ? kind.defaultSize / 100 : 10;
+        all.push_back({ std::string(kind.name) + "=" + std::to_string(size), kind.make(size) });
+    }
+    all.push_back({ "semantic-errors",
+                    "int a;\nint f(int x) { return x + y; }\nmain() {\n    a = \"s\";\n    g(1);\n    print(f(1, 2));\n}\n" });
+    for (const auto& f : files) {
+        std::ifstream in(f, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "nu pot citi '%s'\n", f.c_str());
+            std::exit(2);
+        }
+        std::ostringstream s;
+        s << in.rdbuf();
+        all.push_back({ f, s.str() });
+    }
+    return all;
+}
+
+int main(int argc, char** argv) {
+    int jobs = 400;
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads < 8) threads = 8;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) jobs = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = (unsigned)std::atoi(argv[++i]);
+        else files.push_back(arg);
+    }
+
+    std::vector<Program> all = programs(files);
+    const int modes = sizeof(MODES) / sizeof(MODES[0]);
+
+    //referinta: fiecare (program, mod) o data, pe threadul principal
+    std::vector<Result> expected;
+    for (const auto& p : all)
+        for (int m = 0; m < modes; m++) expected.push_back(compileAndRun(p, MODES[m]));
+
+    std::vector<Result> results(jobs);
+    WorkStealingPool pool(threads);
+    for (int j = 0; j < jobs; j++) {
+        pool.submit([&, j] {
+            int k = j % (int)expected.size();
+            results[j] = compileAndRun(all[k / modes], MODES[k % modes]);
+        });
+    }
+    pool.run();
+
+    int failed = 0;
+    for (int j = 0; j < jobs; j++) {
+        int k = j % (int)expected.size();
+        if (results[j] == expected[k]) continue;
+        if (failed++ < 10)
+            std::fprintf(stderr, "job %d (%s, %s): rezultat diferit de cel secvential\n", j, all[k / modes].name.c_str(),
+                         MODE_NAMES[k % modes]);
+    }
+    std::printf("%d joburi pe %u thread-uri, %zu programe x %d moduri: %d diferite\n", jobs, threads, all.size(), modes,
+                failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+// Debitul lexerului (MB/s): aceeasi sursa mare citita prin FILE* (stdin, bufferul implicit flex)
+// si prin fisierul mapat dat lui yy_scan_buffer (fara copiere).
+//
+//   bison -d comp.y && flex comp.l
+//   g++ -O2 -I. bench/lex_bench.cpp lex.yy.c source_file.cpp value.cpp array.cpp -o lex_bench
+//   g++ -O2 -I. [-mavx2] bench/lex_bench.cpp scanner.cpp source_file.cpp value.cpp array.cpp -o lex_bench   (scannerul scris de mana)
+//   ./lex_bench [fisier | MB]     (fara fisier se genereaza o sursa de ~MB megaocteti, implicit 64)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "compilation.h"
+#include "comp.tab.h"
+
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+int yylex(YYSTYPE* yylval, YYLTYPE* yylloc, yyscan_t scanner);
+int yylex_init_extra(CompilationContext* extra, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* in, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, yyscan_t scanner);
+
+static std::string generate(size_t megabytes) {
+    std::string path = "/tmp/lex_bench_src.txt";
+    FILE* f = std::fopen(path.c_str(), "w");
+    std::fprintf(f, "int counter;\nfloat ratio;\nstring label;\nmain() {\n");
+    size_t target = megabytes << 20;
+    for (size_t i = 0; (size_t)std::ftell(f) < target; i++) {
+        std::fprintf(f, "    counter = counter + %zu * (counter - 3); // linia %zu\n", i, i);
+        std::fprintf(f, "    if (counter >= 100 && ratio != 2.5) { label = \"text %zu\"; }\n", i);
+    }
+    std::fprintf(f, "}\n");
+    std::fclose(f);
+    return path;
+}
+
+//numara tokenii; arena contextului primeste sirurile literale, ca in compilarea reala
+static size_t drain(yyscan_t scanner) {
+    YYSTYPE lval;
+    YYLTYPE lloc;
+    size_t tokens = 0;
+    while (yylex(&lval, &lloc, scanner)) tokens++;
+    return tokens;
+}
+
+static void report(const char* name, size_t bytes, size_t tokens, double seconds) {
+    std::printf("%-8s %10zu tokens %9.3f s %9.1f MB/s\n", name, tokens, seconds, bytes / seconds / (1 << 20));
+}
+
+int main(int argc, char** argv) {
+    std::string arg = argc > 1 ? argv[1] : "64";
+    bool size = arg.find_first_not_of("0123456789") == std::string::npos;
+    std::string path = size ? generate(std::atoi(arg.c_str())) : arg;
+    typedef std::chrono::steady_clock clock;
+
+    {
+        CompilationContext ctx;
+        Arena::Scope scope(ctx.arena);
+        FILE* in = std::fopen(path.c_str(), "r");
+        if (!in) { std::perror(path.c_str()); return 1; }
+        std::fseek(in, 0, SEEK_END);
+        size_t bytes = std::ftell(in);
+        std::rewind(in);
+
+        auto start = clock::now();
+        yyscan_t scanner;
+        yylex_init_extra(&ctx, &scanner);
+        yyset_in(in, scanner);
+        size_t tokens = drain(scanner);
+        yylex_destroy(scanner);
+        report("FILE*", bytes, tokens, std::chrono::duration<double>(clock::now() - start).count());
+        std::fclose(in);
+    }
+
+    {
+        CompilationContext ctx;
+        Arena::Scope scope(ctx.arena);
+        auto start = clock::now();
+        MappedSource source;
+        if (!source.open(path)) { std::fprintf(stderr, "%s: %s\n", path.c_str(), source.error().c_str()); return 1; }
+        yyscan_t scanner;
+        yylex_init_extra(&ctx, &scanner);
+        yy_scan_buffer(source.data(), source.scanSize(), scanner);
+        size_t tokens = drain(scanner);
+        yylex_destroy(scanner);
+        report("mmap", source.size(), tokens, std::chrono::duration<double>(clock::now() - start).count());
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+# Comparatie diferentiala intre scannerul generat de flex (comp.l) si cel scris de mana (scanner.cpp):
+# acelasi sir de tokeni (cu linii si valori) pe fiecare intrare, pentru toate variantele scannerului
+# (AVX2 daca procesorul il are, SSE2, scalar). Fara argumente se folosesc sursele din repo si cateva cazuri limita.
+#
+#   ./bench/lex_diff.sh [fisier...]
+
+set -e
+cd "$(dirname "$0")/.."
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+CXX=${CXX:-g++}
+
+bison -d -o $TMP/comp.tab.c comp.y 2> /dev/null
+flex -o $TMP/lex.yy.c comp.l
+BUILD="$CXX -std=c++17 -O2 -I. -I$TMP bench/token_dump.cpp value.cpp array.cpp"
+$BUILD $TMP/lex.yy.c -o $TMP/flex
+$BUILD scanner.cpp -o $TMP/sse2
+$BUILD scanner.cpp -DSCANNER_NO_SIMD -o $TMP/scalar
+VARIANTS="sse2 scalar"
+if grep -qw avx2 /proc/cpuinfo 2> /dev/null; then
+    $BUILD scanner.cpp -mavx2 -o $TMP/avx2
+    VARIANTS="avx2 $VARIANTS"
+fi
+
+if [ $# -eq 0 ]; then
+    printf 'int x;\nfloat  f;\t\r\nstring s;\nmain() {\n' > $TMP/edge1.txt
+    printf '  x = 12345678901 + 007 + 3.25 + 3. + 4.x;\n  s = "doua\nlinii" + "";\n' >> $TMP/edge1.txt
+    printf '  /* comentariu\n pe mai *multe* linii **/ if (x<=1&&!b||c!=d>=e==f) { Print(s); }\n' >> $TMP/edge1.txt
+    printf '  integer intx _y a_b9 Z9 while1 print PRINT // final\n  @ # $ ~ / * %% & |\n}\n' >> $TMP/edge1.txt
+    printf 'int a; "neinchis\nb c\n' > $TMP/edge2.txt
+    printf 'x /* neinchis\n\n' > $TMP/edge3.txt
+    awk 'BEGIN { for (i = 0; i < 40; i++) printf "%*s%s\n", i, "", "identificator_foarte_lung_care_trece_de_un_bloc" i " 1234567890123456789012345678901234567890 \"sir\"" }' > $TMP/edge4.txt
+    set -- input_corect.txt input_gresit.txt $TMP/edge*.txt
+fi
+
+status=0
+for f in "$@"; do
+    $TMP/flex < "$f" > $TMP/expected
+    for v in $VARIANTS; do
+        if ! $TMP/$v < "$f" | diff -q $TMP/expected - > /dev/null; then
+            echo "DIFERENTA $v: $f"
+            $TMP/$v < "$f" | diff $TMP/expected - | head -5
+            status=1
+        fi
+    done
+done
+[ $status -eq 0 ] && echo "identic: $# fisiere, variante: flex $VARIANTS"
+exit $status
@@ -0,0 +1,34 @@
+#!/bin/bash
+# Timpul de parsare + verificare semantica pe expresii lungi inlantuite (x = a + a + ... + a).
+# Cu inferType memorat pe noduri curba trebuie sa fie liniara in numarul de termeni.
+#
+#   ./bench/parse_chain.sh [./comp] [termeni...]
+
+COMP=${1:-./comp}
+shift
+SIZES=${@:-1000 2000 4000 8000 16000}
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+
+printf "%8s %10s %12s\n" "terms" "ms" "us/term"
+for n in $SIZES; do
+    src=$TMP/chain_$n.txt
+    {
+        echo "int a;"
+        echo "int x;"
+        echo "main() {"
+        printf "    x = a"
+        for ((i = 1; i < n; i++)); do printf " + a"; done
+        echo ";"
+        printf "    if (a"
+        for ((i = 1; i < n; i++)); do printf " + a"; done
+        echo " > 0) { x = 1; }"
+        echo "}"
+    } > $src
+
+    start=$(date +%s%N)
+    (cd $TMP && $COMP --check < $src > /dev/null) || { echo "compilare esuata pentru $n termeni"; exit 1; }
+    end=$(date +%s%N)
+    ms=$(( (end - start) / 1000000 ))
+    awk -v n=$n -v ms=$ms 'BEGIN { printf "%8d %10d %12.3f\n", n, ms, ms * 1000.0 / n }'
+done
@@ -0,0 +1,137 @@
+// Benchmark pe faze: lexer, parsare + verificare semantica, dumpAllScopes si executie
+// (program_node::eval pe arbore si, pentru comparatie, VM-ul, direct si prin IR-ul optimizat), pe programele din workload.h.
+// Fiecare faza e masurata de --repeat ori si se raporteaza minimul, ca linii JSON pe stdout.
+//
+//   bison -d comp.y && flex comp.l
+//   g++ -O2 -I. -DCOMP_NO_MAIN bench/phase_bench.cpp comp.tab.c lex.yy.c value.cpp array.cpp bytecode.cpp \
+//       vm.cpp fold.cpp ir.cpp ir_passes.cpp aot.cpp compilation.cpp source_file.cpp output.cpp -o phase_bench
+//   ./phase_bench [--repeat N] [tip[=dimensiune]...]     ex: ./phase_bench chain=50000 loop
+//   ./phase_bench --emit tip [dimensiune] > program.txt   (doar genereaza programul)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "compilation.h"
+#include "comp.tab.h"
+#include "vm.h"
+#include "workload.h"
+
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+int yylex(YYSTYPE* yylval, YYLTYPE* yylloc, yyscan_t scanner);
+int yylex_init_extra(CompilationContext* extra, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int len, yyscan_t scanner);
+
+//print formateaza normal, dar octetii nu ajung nicaieri: nu vrem sa masuram terminalul
+class DiscardSink : public OutputSink {
+protected:
+    void writeOut(const char*, size_t) override {}
+};
+
+//cel mai mic timp (ms) din `repeat` rulari; setup nu e cronometrat
+static double best(int repeat, const std::function<void()>& setup, const std::function<void()>& body) {
+    double ms = 1e300;
+    for (int r = 0; r < repeat; r++) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        ms = std::min(ms, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return ms;
+}
+
+static void run(const workload::Kind& kind, int size, int repeat) {
+    std::string src = kind.make(size);
+    DiscardSink discard;
+    size_t tokens = 0;
+
+    std::unique_ptr<CompilationContext> ctx;
+    auto fresh = [&] { ctx.reset(new CompilationContext()); };
+    auto parsed = [&] { fresh(); ctx->parse(src.data(), src.size()); };
+
+    double lex = best(repeat, fresh, [&] {
+        Arena::Scope scope(ctx->arena);
+        yyscan_t scanner;
+        yylex_init_extra(ctx.get(), &scanner);
+        yy_scan_bytes(src.data(), (int)src.size(), scanner);
+        YYSTYPE lval;
+        YYLTYPE lloc;
+        tokens = 0;
+        while (yylex(&lval, &lloc, scanner)) tokens++;
+        yylex_destroy(scanner);
+    });
+
+    //parse include si lexerul (parserul il cheama token cu token); parse_ms scade timpul lexerului
+    double parseTotal = best(repeat, fresh, [&] { ctx->parse(src.data(), src.size()); });
+    if (!ctx->ok()) {
+        ctx->printDiagnostics(std::cerr);
+        std::fprintf(stderr, "%s=%d: programul generat are erori\n", kind.name, size);
+        std::exit(1);
+    }
+
+    double dump = best(repeat, parsed, [&] {
+        std::ostringstream out;
+        ctx->scopes.dumpAllScopes(out);
+    });
+
+    double eval = best(repeat, parsed, [&] { ctx->execute(EXEC_TREE, discard, false); });
+
+    Chunk chunk;
+    double vm = best(repeat, [&] { parsed(); chunk = ctx->lower(false); }, [&] {
+        VM machine;
+        machine.run(chunk, discard);
+    });
+
+    Chunk optimized;
+    double ir = best(repeat, [&] { parsed(); optimized = ctx->lowerOptimized(false); }, [&] {
+        VM machine;
+        machine.run(optimized, discard);
+    });
+
+    std::printf("{\"workload\":\"%s\",\"size\":%d,\"bytes\":%zu,\"tokens\":%zu,"
+                "\"lex_ms\":%.3f,\"parse_ms\":%.3f,\"dump_ms\":%.3f,\"eval_ms\":%.3f,\"vm_ms\":%.3f,\"ir_ms\":%.3f}\n",
+                kind.name, size, src.size(), tokens,
+                lex, std::max(0.0, parseTotal - lex), dump, eval, vm, ir);
+    std::fflush(stdout);
+}
+
+static const workload::Kind* findKind(const std::string& name) {
+    for (const auto& k : workload::kinds())
+        if (name == k.name) return &k;
+    std::fprintf(stderr, "tip necunoscut: %s (", name.c_str());
+    for (const auto& k : workload::kinds()) std::fprintf(stderr, " %s", k.name);
+    std::fprintf(stderr, " )\n");
+    std::exit(1);
+}
+
+int main(int argc, char** argv) {
+    int repeat = 3;
+    std::vector<std::pair<const workload::Kind*, int>> todo;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--emit" && i + 1 < argc) {
+            const workload::Kind* k = findKind(argv[++i]);
+            int size = i + 1 < argc ? std::atoi(argv[++i]) : k->defaultSize;
+            std::fputs(k->make(size).c_str(), stdout);
+            return 0;
+        }
+        else {
+            size_t eq = arg.find('=');
+            const workload::Kind* k = findKind(arg.substr(0, eq));
+            todo.push_back({ k, eq == std::string::npos ? k->defaultSize : std::atoi(arg.c_str() + eq + 1) });
+        }
+    }
+    if (todo.empty())
+        for (const auto& k : workload::kinds()) todo.push_back({ &k, k.defaultSize });
+
+    for (auto& t : todo) run(*t.first, t.second, repeat);
+    return 0;
+}
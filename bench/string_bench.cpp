@@ -0,0 +1,67 @@
+// Microbenchmark pentru siruri: construirea unui sir prin `s = s + piesa` repetat si copierea sirurilor scurte.
+// Compara Value::concat (SSO + adaugare in bufferul partajat) cu varianta veche, care copia ambii operanzi
+// intr-un std::string nou la fiecare concatenare.
+//
+//   g++ -O2 -I. bench/string_bench.cpp value.cpp array.cpp -o string_bench && ./string_bench [n]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "value.h"
+
+template <typename F>
+static double timeIt(const char* name, long ops, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    std::printf("%-28s %10.2f ns/op %10.1f ms total\n", name, ns / ops, ns / 1e6);
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    long n = argc > 1 ? std::atol(argv[1]) : 50000;
+    Value piece(std::string("xy"));
+    volatile size_t sink = 0;
+
+    //copie completa la fiecare pas, ca Value(l.s() + r.s()): O(n^2)
+    timeIt("append copy", n, [&] {
+        Value s(std::string(""));
+        for (long k = 0; k < n; k++) s = Value(std::string(s.s()) + std::string(piece.s()));
+        sink = sink + s.s().size();
+    });
+
+    //adaugare in bufferul lui s: O(n) amortizat
+    timeIt("append concat", n, [&] {
+        Value s(std::string(""));
+        for (long k = 0; k < n; k++) s = Value::concat(s, piece);
+        sink = sink + s.s().size();
+    });
+
+    //o vedere veche pastrata in viata nu se schimba cand bufferul creste
+    timeIt("append concat + snapshot", n, [&] {
+        Value s(std::string(""));
+        Value snapshot;
+        for (long k = 0; k < n; k++) {
+            s = Value::concat(s, piece);
+            if (k % 1000 == 0) snapshot = s;
+        }
+        sink = sink + s.s().size() + snapshot.s().size();
+    });
+
+    //siruri scurte: raman in valoare, fara heap si fara numarare de referinte
+    const int N = 1024, ROUNDS = 2000;
+    std::vector<Value> src(N, Value(std::string("short"))), dst(N);
+    timeIt("copy short string", (long)N * ROUNDS, [&] {
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) dst[k] = src[k];
+    });
+    timeIt("concat short strings", (long)N * ROUNDS, [&] {
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) dst[k] = Value::concat(src[k], piece);
+    });
+
+    return sink == 0;
+}
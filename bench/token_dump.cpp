@@ -0,0 +1,40 @@
+// Sirul de tokeni produs de scannerul cu care e legat (lex.yy.c sau scanner.cpp), cate unul pe linie:
+// linia, codul tokenului si valoarea lui. bench/lex_diff.sh compara iesirile celor doua scannere.
+//
+//   g++ -O2 -I. bench/token_dump.cpp lex.yy.c value.cpp array.cpp -o token_dump     (sau scanner.cpp in loc de lex.yy.c)
+//   ./token_dump < program.txt
+
+#include <cstdio>
+#include "compilation.h"
+#include "comp.tab.h"
+
+int yylex(YYSTYPE* yylval, YYLTYPE* yylloc, yyscan_t scanner);
+int yylex_init_extra(CompilationContext* extra, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* in, yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
+
+int main() {
+    CompilationContext ctx;
+    Arena::Scope scope(ctx.arena);
+    yyscan_t scanner;
+    yylex_init_extra(&ctx, &scanner);
+    yyset_in(stdin, scanner);
+
+    YYSTYPE lval;
+    YYLTYPE lloc;
+    int token;
+    while ((token = yylex(&lval, &lloc, scanner))) {
+        std::printf("%d %d", lloc.first_line, token);
+        switch (token) {
+        case ID: std::printf(" %s", lval.Name->text.c_str()); break;
+        case INT_LITERAL: std::printf(" %d", lval.Int); break;
+        case FLOAT_LITERAL: std::printf(" %.9g", lval.Float); break;
+        case STRING_LITERAL: std::printf(" \"%s\"", lval.String->c_str()); break;
+        }
+        std::printf("\n");
+    }
+    std::printf("eof %d %d\n", lloc.first_line, yyget_lineno(scanner));
+    yylex_destroy(scanner);
+    return 0;
+}
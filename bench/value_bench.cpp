@@ -0,0 +1,86 @@
+// Microbenchmark pentru reprezentarea Value: copiere si aritmetica,
+// vechiul layout (int + float + bool + std::string + hasReturn) vs. valoarea etichetata.
+//
+//   g++ -O2 -I. bench/value_bench.cpp value.cpp array.cpp -o value_bench && ./value_bench
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "value.h"
+
+//copie a vechiului Value, pastrata doar pentru comparatie
+struct LegacyValue {
+    ValueType type;
+    int i;
+    float f;
+    bool b;
+    std::string s;
+    bool hasReturn;
+
+    LegacyValue() : type(VAL_VOID), i(0), f(0.0f), b(false), s(""), hasReturn(false) {}
+    LegacyValue(int v) : type(VAL_INT), i(v), f(0.0f), b(false), s(""), hasReturn(false) {}
+    LegacyValue(float v) : type(VAL_FLOAT), i(0), f(v), b(false), s(""), hasReturn(false) {}
+    LegacyValue(const std::string& v) : type(VAL_STRING), i(0), f(0.0f), b(false), s(v), hasReturn(false) {}
+};
+
+template <typename T>
+static T add(const T& l, const T& r) {
+    if (l.type == VAL_INT) return T(l.i + r.i);
+    if (l.type == VAL_FLOAT) return T(l.f + r.f);
+    return T();
+}
+
+template <typename F>
+static double timeIt(const char* name, long ops, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    std::printf("%-28s %8.2f ns/op %10.1f Mops/s\n", name, ns / ops, ops * 1e3 / ns);
+    return ns;
+}
+
+template <typename T>
+static void runSuite(const char* label, const T& seed) {
+    const int N = 1024;
+    const int ROUNDS = 5000;
+    std::vector<T> src(N, seed), dst(N);
+    std::string n = label;
+
+    timeIt((n + " copy").c_str(), (long)N * ROUNDS, [&] {
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) dst[k] = src[k];
+    });
+
+    volatile int sink = 0;
+    timeIt((n + " add").c_str(), (long)N * ROUNDS, [&] {
+        T acc = seed;
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) acc = add(acc, src[k]);
+        sink = acc.i;
+    });
+    (void)sink;
+}
+
+int main() {
+    std::printf("sizeof(LegacyValue) = %zu, sizeof(Value) = %zu\n\n", sizeof(LegacyValue), sizeof(Value));
+
+    runSuite("legacy int", LegacyValue(1));
+    runSuite("tagged int", Value(1));
+    runSuite("legacy float", LegacyValue(1.0f));
+    runSuite("tagged float", Value(1.0f));
+
+    const int N = 1024, ROUNDS = 2000;
+    std::vector<LegacyValue> ls(N, LegacyValue(std::string("a string that does not fit in SSO"))), ld(N);
+    std::vector<Value> vs(N, Value(std::string("a string that does not fit in SSO"))), vd(N);
+    timeIt("legacy string copy", (long)N * ROUNDS, [&] {
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) ld[k] = ls[k];
+    });
+    timeIt("tagged string copy", (long)N * ROUNDS, [&] {
+        for (int r = 0; r < ROUNDS; r++)
+            for (int k = 0; k < N; k++) vd[k] = vs[k];
+    });
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Generator de programe sintetice, scalabile, pentru benchmark-uri.
+// Fiecare tip stresseaza alta faza: lanturi lungi de expresii (parser + inferType), mii de functii
+// si clase (tabele de simboluri + dump), blocuri imbricate adanc si bucle lungi (eval), apeluri recursive (fib).
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <string>
+#include <vector>
+
+namespace workload {
+
+//x = a + a + ... + a, o data ca atribuire si o data intr-o conditie
+inline std::string chain(int terms) {
+    std::string s = "int a;\nint x;\nmain() {\n    a = 1;\n    x = a";
+    for (int i = 1; i < terms; i++) s += " + a";
+    s += ";\n    if (a";
+    for (int i = 1; i < terms; i++) s += " + a";
+    s += " > 0) { x = 1; }\n    print(x);\n}\n";
+    return s;
+}
+
+//n functii cu parametri si variabile locale, apelate din main
+inline std::string functions(int n) {
+    std::string s = "int total;\n";
+    for (int i = 0; i < n; i++) {
+        std::string k = std::to_string(i);
+        s += "int f" + k + "(int p, float q, bool r) {\n    int v = p + " + k + ";\n    float w = q * 2.5;\n"
+             "    if (r) { return v * 2; }\n    return v;\n}\n";
+    }
+    s += "main() {\n";
+    for (int i = 0; i < n; i++) s += "    total = total + f" + std::to_string(i) + "(total, 1.5, true);\n";
+    s += "    print(total);\n}\n";
+    return s;
+}
+
+//n clase cu membri si metode, cate o instanta a fiecareia in main
+inline std::string classes(int n) {
+    std::string s;
+    for (int i = 0; i < n; i++) {
+        std::string k = std::to_string(i);
+        s += "class C" + k + " {\n    int a;\n    float b;\n    string c;\n"
+             "    int get(int d) {\n        return d + " + k + ";\n    }\n"
+             "    void set() {\n        a = " + k + ";\n    }\n};\n";
+    }
+    s += "int sum;\nmain() {\n";
+    for (int i = 0; i < n; i++) {
+        std::string k = std::to_string(i);
+        s += "    C" + k + " o" + k + ";\n    o" + k + ".a = " + k + ";\n    sum = sum + o" + k + ".a;\n";
+    }
+    s += "    print(sum);\n}\n";
+    return s;
+}
+
+//depth blocuri if/while imbricate, cu declaratii si atribuiri pe fiecare nivel
+inline std::string nested(int depth) {
+    std::string s = "int n;\nmain() {\n    n = 0;\n";
+    std::string indent = "    ";
+    for (int i = 0; i < depth; i++) {
+        std::string k = std::to_string(i);
+        s += indent + (i % 2 ? "while (n < " + std::to_string(i + 1) + ") {\n" : "if (n >= 0) {\n");
+        if (i < 16) indent += "    "; //indentare plafonata, altfel sursa creste patratic
+        s += indent + "int v" + k + " = n + " + k + ";\n";
+        s += indent + "n = v" + k + " - " + k + " + 1;\n";
+    }
+    for (int i = depth; i > 0; i--) {
+        if (i <= 16) indent.resize(indent.size() - 4);
+        s += indent + "}\n";
+    }
+    s += "    print(n);\n}\n";
+    return s;
+}
+
+//o bucla while de `iterations` pasi cu aritmetica intreaga, reala si concatenare de siruri
+inline std::string loop(int iterations) {
+    return "int i;\nint acc;\nfloat f;\nstring s;\nstring t;\nbool odd;\nmain() {\n"
+           "    i = 0;\n    acc = 0;\n    f = 0.5;\n    s = \"abc\";\n"
+           "    while (i < " + std::to_string(iterations) + ") {\n"
+           "        acc = acc + i * 3 - acc / 7;\n"
+           "        f = f * 1.0001 + 0.25;\n"
+           "        t = s + \"-\" + s;\n"
+           "        odd = !(acc / 2 * 2 == acc);\n"
+           "        if (odd && acc > 100) { acc = acc - 100; }\n"
+           "        i = i + 1;\n"
+           "    }\n"
+           "    print(acc);\n    print(t);\n}\n";
+}
+
+//un sir construit prin `s = s + ...` repetat; cu copiere la fiecare pas costul ar fi patratic
+inline std::string strings(int iterations) {
+    return "int i;\nstring s;\nstring piece;\nbool same;\nmain() {\n"
+           "    i = 0;\n    s = \"\";\n    piece = \"xy\";\n"
+           "    while (i < " + std::to_string(iterations) + ") {\n"
+           "        s = s + piece;\n"
+           "        s = s + \"-\";\n"
+           "        same = piece == \"xy\";\n"
+           "        i = i + 1;\n"
+           "    }\n"
+           "    print(same);\n}\n";
+}
+
+//bucla cu subexpresii repetate si calcule invariante (tinta pentru CSE si LICM din --ir)
+inline std::string invariant(int iterations) {
+    return "int i;\nint n;\nint a;\nint b;\nint acc;\nfloat f;\nfloat scale;\nmain() {\n"
+           "    a = 3;\n    b = 4;\n    scale = 1.5;\n    n = " + std::to_string(iterations) + ";\n    i = 0;\n"
+           "    while (i < n) {\n"
+           "        acc = acc + (a * b + a * b) * i - (a + b) * (a - b);\n"
+           "        f = f + scale * 2.0 * scale;\n"
+           "        i = i + 1;\n"
+           "    }\n"
+           "    print(acc);\n    print(f);\n}\n";
+}
+
+//fib recursiv: costul unui apel (cadru nou, argumente, return) domina executia
+inline std::string fib(int n) {
+    return "int fib(int k) {\n    if (k < 2) { return k; }\n    return fib(k - 1) + fib(k - 2);\n}\n"
+           "main() {\n    print(fib(" + std::to_string(n) + "));\n}\n";
+}
+
+struct Kind {
+    const char* name;
+    std::string (*make)(int);
+    int defaultSize;
+};
+
+inline const std::vector<Kind>& kinds() {
+    static const std::vector<Kind> all = {
+        { "chain", chain, 20000 },
+        { "functions", functions, 3000 },
+        { "classes", classes, 3000 },
+        { "nested", nested, 500 },
+        { "loop", loop, 300000 },
+        { "strings", strings, 200000 },
+        { "invariant", invariant, 300000 },
+        { "fib", fib, 25 },
+    };
+    return all;
+}
+
+}
+
+#endif
@@ -0,0 +1,416 @@
+#include "bytecode.h"
+
+const char* opName(OpCode op) {
+    static const char* names[OP_COUNT] = {
+        "CONST", "LOAD_GLOBAL", "STORE_GLOBAL", "LOAD_LOCAL", "STORE_LOCAL",
+        "LOAD_FIELD", "STORE_FIELD", "GET_FIELD", "SET_FIELD", "POP",
+        "ADD", "SUB", "MUL", "DIV",
+        "LT", "GT", "LE", "GE", "EQ", "NE",
+        "ADD_I", "SUB_I", "MUL_I", "DIV_I",
+        "LT_I", "GT_I", "LE_I", "GE_I", "EQ_I", "NE_I",
+        "ADD_F", "SUB_F", "MUL_F", "DIV_F",
+        "LT_F", "GT_F", "LE_F", "GE_F", "EQ_F", "NE_F",
+        "CONCAT", "EQ_S", "NE_S",
+        "EQ_B", "NE_B",
+        "NOT", "AND_JUMP", "OR_JUMP", "TO_BOOL",
+        "JUMP", "JUMP_IF_FALSE", "PRINT",
+        "CALL", "CALL_METHOD", "NEW",
+        "NEW_ARRAY", "ARRAY_LITERAL", "INDEX", "INDEX_UNCHECKED", "SET_INDEX", "SET_INDEX_UNCHECKED", "ARRAY_LEN", "ARRAY_REDUCE", "ARRAY_ARITH",
+        "RETURN", "HALT"
+    };
+    return op < OP_COUNT ? names[op] : "?";
+}
+
+void Chunk::disassemble(std::ostream& out) const {
+    for (size_t i = 0; i < code.size(); i++) {
+        const Instruction& in = code[i];
+        out << i << "\t" << opName(in.op);
+        switch (in.op) {
+            case OP_CONST: out << "\t" << in.arg << " (" << constants[in.arg].toString() << ")"; break;
+            case OP_LOAD_GLOBAL: case OP_STORE_GLOBAL: case OP_LOAD_LOCAL: case OP_STORE_LOCAL:
+            case OP_LOAD_FIELD: case OP_STORE_FIELD: case OP_GET_FIELD: case OP_SET_FIELD:
+            case OP_JUMP: case OP_JUMP_IF_FALSE: case OP_AND_JUMP: case OP_OR_JUMP:
+                out << "\t" << in.arg; break;
+            case OP_CALL: case OP_CALL_METHOD:
+                out << "\t" << in.arg << " (" << functions[in.arg].name << ")"; break;
+            case OP_NEW:
+                out << "\t" << in.arg << " (" << classes[in.arg].name << ")"; break;
+            case OP_NEW_ARRAY: case OP_ARRAY_ARITH:
+                out << "\t" << in.arg; break;
+            case OP_ARRAY_LITERAL:
+                out << "\t" << (in.arg >> 2) << " (elem " << (in.arg & 3) << ")"; break;
+            case OP_ARRAY_REDUCE:
+                out << "\t" << in.arg << " (" << arrayFnName((ArrayFn)in.arg) << ")"; break;
+            default: break;
+        }
+        out << "\n";
+    }
+    for (const FunctionInfo& f : functions)
+        out << "; " << f.name << ": entry " << f.entry << ", params " << f.params << ", locals " << f.locals << "\n";
+    for (const ClassInfo& c : classes)
+        out << "; class " << c.name << ": fields " << c.fields << ", defaults " << c.defaults << ", init " << c.init << "\n";
+}
+
+void FunctionTable::collect(program_node* program) {
+    auto add = [&](int classId, ast_node* node) {
+        func_def_node* f = static_cast<func_def_node*>(node);
+        index[key(classId, f->name_id)] = (int)list.size();
+        list.push_back(f);
+    };
+    if (!program) return;
+    for (auto g : program->globals) {
+        if (!g) continue;
+        if (g->kind == NODE_FUNC_DEF) add(-1, g);
+        else if (g->kind == NODE_CLASS_DEF) {
+            class_def_node* c = static_cast<class_def_node*>(g);
+            classIndex[c->class_id] = (int)classList.size();
+            classList.push_back(c);
+            for (auto m : c->members)
+                if (m && m->kind == NODE_FUNC_DEF) add(c->class_id, m);
+        }
+    }
+}
+
+//depth 0 = variabile globale, localDepth = cadrul curent; intr-o metoda, depth 1 sunt campurile obiectului
+void BytecodeCompiler::emitLoad(int depth, int slot) {
+    if (slot < 0) chunk->emit(OP_CONST, addConstant(Value()));
+    else chunk->emit(depth == 0 ? OP_LOAD_GLOBAL : depth == localDepth ? OP_LOAD_LOCAL : OP_LOAD_FIELD, slot);
+}
+
+void BytecodeCompiler::emitStore(int depth, int slot) {
+    if (slot < 0) return;
+    chunk->emit(depth == 0 ? OP_STORE_GLOBAL : depth == localDepth ? OP_STORE_LOCAL : OP_STORE_FIELD, slot);
+}
+
+int BytecodeCompiler::addConstant(const Value& v) {
+    chunk->constants.push_back(v);
+    return (int)chunk->constants.size() - 1;
+}
+
+Value defaultValue(const TypeInfo* type) {
+    if (type && type->type == TYPE_INT) return Value(0);
+    if (type && type->type == TYPE_FLOAT) return Value(0.0f);
+    if (type && type->type == TYPE_BOOL) return Value(false);
+    if (type && type->type == TYPE_STRING) return Value(std::string(""));
+    return Value();
+}
+
+void BytecodeCompiler::pushDefault(const TypeInfo* type) {
+    chunk->emit(OP_CONST, addConstant(defaultValue(type)));
+}
+
+void BytecodeCompiler::compileBlock(block_node* block) {
+    if (!block) return;
+    for (auto s : block->statements) compileStmt(s);
+}
+
+void BytecodeCompiler::compileStmt(ast_node* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NODE_BLOCK:
+            compileBlock(static_cast<block_node*>(node));
+            return;
+
+        case NODE_MAIN:
+            compileBlock(static_cast<main_node*>(node)->body);
+            return;
+
+        case NODE_VAR_DECL: {
+            var_decl_node* d = static_cast<var_decl_node*>(node);
+            int cls = d->init_val ? -1 : table.findClass(d->class_id);
+            if (d->init_val) compileExpr(d->init_val);
+            else if (cls >= 0) chunk->emit(OP_NEW, cls);
+            else pushDefault(d->type);
+            emitStore(d->depth, d->slot);
+            chunk->emit(OP_POP);
+            return;
+        }
+
+        //functiile si clasele nu se executa la definire
+        case NODE_FUNC_DEF:
+        case NODE_CLASS_DEF:
+            return;
+
+        case NODE_IF: {
+            if_node* i = static_cast<if_node*>(node);
+            compileExpr(i->condition);
+            int jf = chunk->emit(OP_JUMP_IF_FALSE);
+            compileStmt(i->then_block);
+            chunk->patch(jf, chunk->here());
+            return;
+        }
+
+        case NODE_WHILE: {
+            while_node* w = static_cast<while_node*>(node);
+            int start = chunk->here();
+            compileExpr(w->condition);
+            int jf = chunk->emit(OP_JUMP_IF_FALSE);
+            compileStmt(w->body);
+            chunk->emit(OP_JUMP, start);
+            chunk->patch(jf, chunk->here());
+            return;
+        }
+
+        //in main, return opreste programul
+        case NODE_RETURN: {
+            return_node* r = static_cast<return_node*>(node);
+            if (inFunction) {
+                compileExpr(r->expr);
+                chunk->emit(OP_RETURN);
+                return;
+            }
+            if (r->expr) {
+                compileExpr(r->expr);
+                chunk->emit(OP_POP);
+            }
+            chunk->emit(OP_HALT);
+            return;
+        }
+
+        case NODE_PRINT:
+            compileExpr(static_cast<print_node*>(node)->expr);
+            chunk->emit(OP_PRINT);
+            return;
+
+        default:
+            //instructiune-expresie: rezultatul se arunca
+            compileExpr(node);
+            chunk->emit(OP_POP);
+            return;
+    }
+}
+
+void BytecodeCompiler::compileExpr(ast_node* node) {
+    if (!node) {
+        chunk->emit(OP_CONST, addConstant(Value()));
+        return;
+    }
+
+    switch (node->kind) {
+        case NODE_LITERAL:
+            chunk->emit(OP_CONST, addConstant(static_cast<literal_node*>(node)->val));
+            return;
+
+        case NODE_ID: {
+            id_node* id = static_cast<id_node*>(node);
+            emitLoad(id->depth, id->slot);
+            return;
+        }
+
+        case NODE_ASSIGN: {
+            assign_node* a = static_cast<assign_node*>(node);
+            compileExpr(a->val);
+            emitStore(a->depth, a->slot);
+            return;
+        }
+
+        //obiectul se evalueaza primul, ca in member_assign_node::eval
+        case NODE_MEMBER_ASSIGN: {
+            member_assign_node* m = static_cast<member_assign_node*>(node);
+            compileExpr(m->obj);
+            if (m->slot < 0) chunk->emit(OP_POP);
+            compileExpr(m->val);
+            if (m->slot >= 0) chunk->emit(OP_SET_FIELD, m->slot);
+            return;
+        }
+
+        case NODE_DOT: {
+            dot_node* d = static_cast<dot_node*>(node);
+            compileExpr(d->obj);
+            if (d->slot >= 0) chunk->emit(OP_GET_FIELD, d->slot);
+            else {
+                chunk->emit(OP_POP);
+                chunk->emit(OP_CONST, addConstant(Value()));
+            }
+            return;
+        }
+
+        case NODE_BINARY:
+            compileBinary(static_cast<binary_expr_node*>(node));
+            return;
+
+        case NODE_ARRAY_NEW: {
+            array_new_node* a = static_cast<array_new_node*>(node);
+            compileExpr(a->size);
+            chunk->emit(OP_NEW_ARRAY, elementValueType(a->element));
+            return;
+        }
+
+        case NODE_ARRAY_LITERAL: {
+            array_literal_node* a = static_cast<array_literal_node*>(node);
+            for (auto i : a->items) compileExpr(i);
+            chunk->emit(OP_ARRAY_LITERAL, (int)a->items.size() << 2 | elementValueType(a->element));
+            return;
+        }
+
+        case NODE_INDEX: {
+            index_node* ix = static_cast<index_node*>(node);
+            compileExpr(ix->arr);
+            compileExpr(ix->index);
+            chunk->emit(OP_INDEX);
+            return;
+        }
+
+        case NODE_INDEX_ASSIGN: {
+            index_assign_node* ia = static_cast<index_assign_node*>(node);
+            compileExpr(ia->arr);
+            compileExpr(ia->index);
+            compileExpr(ia->val);
+            chunk->emit(OP_SET_INDEX);
+            return;
+        }
+
+        case NODE_ARRAY_CALL: {
+            array_call_node* ac = static_cast<array_call_node*>(node);
+            compileExpr(ac->arr);
+            if (ac->fn == ARRAY_LENGTH) {
+                chunk->emit(OP_ARRAY_LEN);
+                return;
+            }
+            if (ac->fn == ARRAY_DOT) compileExpr(ac->arg);
+            chunk->emit(OP_ARRAY_REDUCE, ac->fn);
+            return;
+        }
+
+        case NODE_CALL: {
+            call_node* c = static_cast<call_node*>(node);
+            compileCall(table.find(c->class_id, c->func_id), OP_CALL, c->args);
+            return;
+        }
+
+        case NODE_METHOD_CALL: {
+            method_call_node* m = static_cast<method_call_node*>(node);
+            int target = m->class_id < 0 ? -1 : table.find(m->class_id, m->method_id);
+            if (target >= 0) compileExpr(m->obj); //obiectul sta sub argumente
+            compileCall(target, OP_CALL_METHOD, m->args);
+            return;
+        }
+
+        default:
+            chunk->emit(OP_CONST, addConstant(Value()));
+            return;
+    }
+}
+
+//argumentele in plus se evalueaza si se arunca, cele lipsa raman void (ca in func_def_node::invoke);
+//fara tinta, apelul e void si argumentele nu se evalueaza
+void BytecodeCompiler::compileCall(int function, OpCode op, const node_list& args) {
+    if (function < 0) {
+        chunk->emit(OP_CONST, addConstant(Value()));
+        return;
+    }
+    size_t params = table.at(function)->param_names.size();
+    for (size_t i = 0; i < args.size(); i++) {
+        compileExpr(args[i]);
+        if (i >= params) chunk->emit(OP_POP);
+    }
+    for (size_t i = args.size(); i < params; i++) chunk->emit(OP_CONST, addConstant(Value()));
+    chunk->emit(op, function);
+}
+
+void BytecodeCompiler::compileBinary(binary_expr_node* bin) {
+    compileExpr(bin->left);
+    if (bin->op == BIN_NOT || !bin->right) {
+        chunk->emit(OP_NOT);
+        return;
+    }
+
+    if (bin->op == BIN_AND || bin->op == BIN_OR) {
+        int j = chunk->emit(bin->op == BIN_AND ? OP_AND_JUMP : OP_OR_JUMP);
+        compileExpr(bin->right);
+        chunk->emit(OP_TO_BOOL);
+        chunk->patch(j, chunk->here());
+        return;
+    }
+
+    compileExpr(bin->right);
+    int op = bin->op;
+    switch (bin->operand) {
+        case VAL_INT: chunk->emit((OpCode)(OP_ADD_I + op)); return;
+        case VAL_FLOAT: chunk->emit((OpCode)(OP_ADD_F + op)); return;
+        case VAL_STRING:
+            if (bin->op == BIN_ADD) { chunk->emit(OP_CONCAT); return; }
+            if (bin->op == BIN_EQ) { chunk->emit(OP_EQ_S); return; }
+            if (bin->op == BIN_NE) { chunk->emit(OP_NE_S); return; }
+            break;
+        case VAL_BOOL:
+            if (bin->op == BIN_EQ) { chunk->emit(OP_EQ_B); return; }
+            if (bin->op == BIN_NE) { chunk->emit(OP_NE_B); return; }
+            break;
+        case VAL_ARRAY: chunk->emit(OP_ARRAY_ARITH, op); return;
+        default:
+            break;
+    }
+    chunk->emit((OpCode)(OP_ADD + op));
+}
+
+Chunk BytecodeCompiler::compile(program_node* program) {
+    Chunk result;
+    chunk = &result;
+
+    if (program) {
+        result.globalCount = program->global_slots;
+        if (program->main_block && program->main_block->kind == NODE_MAIN)
+            result.localCount = static_cast<main_node*>(program->main_block)->frame_slots;
+        table.collect(program);
+        for (auto g : program->globals) compileStmt(g);
+        compileStmt(program->main_block);
+    }
+    chunk->emit(OP_HALT);
+    compileFunctions(program, result);
+    chunk = nullptr;
+    return result;
+}
+
+//corpul fiecarei functii se termina cu valoarea implicita a tipului returnat, pentru drumurile fara return
+void BytecodeCompiler::compileFunctions(program_node* program, Chunk& into) {
+    Chunk* saved = chunk;
+    chunk = &into;
+    table = FunctionTable();
+    table.collect(program);
+    into.functions.assign(table.size(), FunctionInfo());
+    for (int i = 0; i < table.size(); i++) {
+        func_def_node* f = table.at(i);
+        FunctionInfo& info = into.functions[i];
+        info.name = f->owner ? f->owner->name + "." + f->name : f->name;
+        info.params = (int)f->param_names.size();
+        info.locals = f->frame_slots;
+        localDepth = f->depth;
+        inFunction = true;
+        info.entry = chunk->here();
+        compileBlock(f->body);
+        pushDefault(f->return_type);
+        chunk->emit(OP_RETURN);
+    }
+    into.classes.assign(table.classCount(), ClassInfo());
+    for (int i = 0; i < table.classCount(); i++) compileClass(table.classAt(i), into.classes[i]);
+    localDepth = 1;
+    inFunction = false;
+    chunk = saved;
+}
+
+//ca class_def_node::instantiate: constantele campurilor, sau declaratiile lor compilate ca in metode (depth 1 = rp)
+void BytecodeCompiler::compileClass(class_def_node* c, ClassInfo& info) {
+    info.name = c->name;
+    info.fields = c->field_slots;
+    if (c->hasConstantFields()) {
+        info.defaults = (int)chunk->constants.size();
+        chunk->constants.resize(chunk->constants.size() + c->field_slots);
+        for (auto m : c->members) {
+            if (!m || m->kind != NODE_VAR_DECL) continue;
+            var_decl_node* d = static_cast<var_decl_node*>(m);
+            if (d->slot < 0) continue;
+            chunk->constants[info.defaults + d->slot] =
+                d->init_val ? static_cast<literal_node*>(d->init_val)->val : defaultValue(d->type);
+        }
+        return;
+    }
+    localDepth = 2;
+    inFunction = true;
+    info.init = chunk->here();
+    for (auto m : c->members)
+        if (m && m->kind == NODE_VAR_DECL) compileStmt(m);
+    chunk->emit(OP_CONST, addConstant(Value()));
+    chunk->emit(OP_RETURN);
+}
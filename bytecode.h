@@ -0,0 +1,156 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "value.h"
+#include "ast.h"
+
+//setul de instructiuni al masinii virtuale (stack VM)
+enum OpCode {
+    OP_CONST,          // push constants[arg]
+    OP_LOAD_GLOBAL,    // push globals[arg]
+    OP_STORE_GLOBAL,   // globals[arg] = top (valoarea ramane pe stiva)
+    OP_LOAD_LOCAL,     // push stack[fp + arg]
+    OP_STORE_LOCAL,    // stack[fp + arg] = top
+    OP_LOAD_FIELD,     // push rp[arg] (campurile obiectului metodei curente)
+    OP_STORE_FIELD,    // rp[arg] = top
+    OP_GET_FIELD,      // top = campul arg al obiectului din top (void daca nu e obiect)
+    OP_SET_FIELD,      // pop valoarea, pop obiectul, campul arg = valoarea; push valoarea
+    OP_POP,
+    //generice: aleg operatia dupa tipul operandului stang (aceeasi ordine ca BinOp)
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV,
+    OP_LT, OP_GT, OP_LE, OP_GE, OP_EQ, OP_NE,
+    //specializate pe tip, emise pentru nodurile binare tipizate
+    OP_ADD_I, OP_SUB_I, OP_MUL_I, OP_DIV_I,
+    OP_LT_I, OP_GT_I, OP_LE_I, OP_GE_I, OP_EQ_I, OP_NE_I,
+    OP_ADD_F, OP_SUB_F, OP_MUL_F, OP_DIV_F,
+    OP_LT_F, OP_GT_F, OP_LE_F, OP_GE_F, OP_EQ_F, OP_NE_F,
+    OP_CONCAT, OP_EQ_S, OP_NE_S,
+    OP_EQ_B, OP_NE_B,
+    OP_NOT,
+    OP_AND_JUMP,       // stanga false -> ramane pe stiva si ip = arg; true -> pop; altfel void si ip = arg
+    OP_OR_JUMP,        // simetric pentru ||
+    OP_TO_BOOL,        // top = (top este bool true)
+    OP_JUMP,           // ip = arg
+    OP_JUMP_IF_FALSE,  // pop; daca nu e bool true -> ip = arg
+    OP_PRINT,          // pop si afiseaza
+    OP_CALL,           // functions[arg]: argumentele sunt deja pe stiva si devin primele locale ale cadrului nou
+    OP_CALL_METHOD,    // ca OP_CALL, pe obiectul aflat sub argumente (void -> nu se apeleaza, rezultat void)
+    OP_NEW,            // push un obiect nou din classes[arg], cu campurile initializate
+    //tablouri (array.h); o eroare opreste programul
+    OP_NEW_ARRAY,      // top = tablou nou cu top elemente zero de tipul arg (ValueType)
+    OP_ARRAY_LITERAL,  // pop arg >> 2 valori, push tabloul lor cu elementele de tipul arg & 3
+    OP_INDEX,          // pop indicele, top = elementul lui din tabloul din top
+    OP_INDEX_UNCHECKED,// ca OP_INDEX, cu indicele dovedit in limite (doar din IR, vezi ir_passes.cpp)
+    OP_SET_INDEX,      // pop valoarea, pop indicele, top = tabloul; scrie elementul, top = valoarea
+    OP_SET_INDEX_UNCHECKED, // ca OP_SET_INDEX, cu indicele dovedit in limite
+    OP_ARRAY_LEN,      // top = lungimea tabloului din top
+    OP_ARRAY_REDUCE,   // metoda arg (ArrayFn) pe tabloul din top; pentru dot, argumentul e deasupra lui
+    OP_ARRAY_ARITH,    // operatia element cu element arg (ArrayOp) pe ultimele doua valori
+    OP_RETURN,         // pop rezultatul, elibereaza cadrul, push rezultatul si revine la apelant
+    OP_HALT,
+    OP_COUNT
+};
+
+struct Instruction {
+    OpCode op;
+    int arg;
+};
+
+//o functie sau metoda compilata; codul ei sta in acelasi Chunk, dupa HALT-ul lui main
+struct FunctionInfo {
+    std::string name;
+    int entry = 0;     //prima instructiune a corpului
+    int params = 0;
+    int locals = 0;    //parametrii + variabilele locale
+};
+
+//forma obiectelor unei clase. Campurile initializate doar cu constante se copiaza din
+//constants[defaults ...], restul ruleaza init (declaratiile campurilor, cu obiectul nou ca rp)
+struct ClassInfo {
+    std::string name;
+    int fields = 0;
+    int defaults = -1;  //primul din cele fields constante consecutive, sau -1
+    int init = -1;      //codul de initializare (se termina cu RETURN), sau -1
+};
+
+//programul liniarizat: instructiuni + constante + dimensiunea cadrelor (globale si main) + functiile
+struct Chunk {
+    std::vector<Instruction> code;
+    std::vector<Value> constants;
+    int globalCount = 0;
+    int localCount = 0;
+    std::vector<FunctionInfo> functions;
+    std::vector<ClassInfo> classes;
+
+    int emit(OpCode op, int arg = 0) {
+        code.push_back({op, arg});
+        return (int)code.size() - 1;
+    }
+    void patch(int at, int target) { code[at].arg = target; }
+    int here() const { return (int)code.size(); }
+
+    void disassemble(std::ostream& out) const;
+};
+
+//functiile, metodele si clasele programului, in ordinea definirii; pozitia e indexul din
+//Chunk::functions, respectiv Chunk::classes
+class FunctionTable {
+    std::vector<func_def_node*> list;
+    std::unordered_map<long, int> index;
+    std::vector<class_def_node*> classList;
+    std::unordered_map<int, int> classIndex;
+
+    static long key(int classId, int nameId) { return (long)(classId + 1) << 32 | (unsigned)nameId; }
+
+public:
+    void collect(program_node* program);
+    //classId -1 pentru functiile globale; -1 daca nu exista
+    int find(int classId, int nameId) const {
+        auto it = index.find(key(classId, nameId));
+        return it == index.end() ? -1 : it->second;
+    }
+    func_def_node* at(int i) const { return list[i]; }
+    int size() const { return (int)list.size(); }
+
+    int findClass(int classId) const {
+        auto it = classIndex.find(classId);
+        return it == classIndex.end() ? -1 : it->second;
+    }
+    class_def_node* classAt(int i) const { return classList[i]; }
+    int classCount() const { return (int)classList.size(); }
+};
+
+//coboara arborele program_node intr-un Chunk
+class BytecodeCompiler {
+    Chunk* chunk;
+    FunctionTable table;
+    int localDepth = 1;      //adancimea cadrului curent: 1 in main si in functii, 2 in metode
+    bool inFunction = false; //return iese din functie; in main opreste programul
+
+    void emitLoad(int depth, int slot);
+    void emitStore(int depth, int slot);
+    int addConstant(const Value& v);
+    void compileStmt(ast_node* node);
+    void compileExpr(ast_node* node);
+    void compileBlock(block_node* block);
+    void compileBinary(binary_expr_node* bin);
+    void compileCall(int function, OpCode op, const node_list& args);
+    void pushDefault(const TypeInfo* type);
+    void compileClass(class_def_node* c, ClassInfo& info);
+
+public:
+    Chunk compile(program_node* program);
+    //adauga in into corpurile functiilor si metodelor (dupa codul lui main) si initializarea obiectelor;
+    //completeaza into.functions si into.classes
+    void compileFunctions(program_node* program, Chunk& into);
+};
+
+const char* opName(OpCode op);
+
+//valoarea unei variabile declarate fara initializare (obiectele se creeaza separat)
+Value defaultValue(const TypeInfo* type);
+
+#endif
@@ -0,0 +1,286 @@
+#include "cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+//versiunea compilatorului din cheie: orice recompilare invalideaza cache-ul, daca nu e data explicit
+#ifndef COMPILER_VERSION
+#define COMPILER_VERSION __DATE__ " " __TIME__
+#endif
+
+static const char CACHE_MAGIC[8] = { 'L', 'F', 'A', 'C', 'B', 'C', '0', '5' };
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static uint64_t checksum(std::string_view data) {
+    return fnv1a(14695981039346656037ull, data.data(), data.size());
+}
+
+uint64_t ProgramCache::key(const char* source, size_t size, bool fold) {
+    uint64_t h = 14695981039346656037ull;
+    h = fnv1a(h, COMPILER_VERSION, sizeof(COMPILER_VERSION));
+    h = fnv1a(h, &fold, sizeof(fold));
+    return fnv1a(h, source, size);
+}
+
+std::string ProgramCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bc", (unsigned long long)key);
+    return (std::filesystem::path(dir) / name).string();
+}
+
+//formatul: magic, cheie, globalCount, localCount, instructiuni, constante, functii, tabele, apoi suma de control
+//a tuturor octetilor de dinainte (un fisier corupt sau trunchiat e un miss, nu un program gresit)
+namespace {
+struct Writer {
+    std::ostream& out;
+    template <typename T> void pod(const T& v) { out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+    void str(std::string_view s) { pod<uint32_t>((uint32_t)s.size()); out.write(s.data(), s.size()); }
+};
+
+struct Reader {
+    std::istream& in;
+    std::streamoff end; //lungimea datelor: lungimile citite nu pot trece de ea
+
+    template <typename T> bool pod(T& v) { return (bool)in.read(reinterpret_cast<char*>(&v), sizeof(T)); }
+    //un numar de elemente de cel putin minSize octeti fiecare, care inca incap in fisier
+    bool count(uint32_t& n, size_t minSize) {
+        if (!pod(n)) return false;
+        std::streamoff at = in.tellg();
+        return at >= 0 && (uint64_t)n * minSize <= (uint64_t)(end - at);
+    }
+    bool str(std::string& s) {
+        uint32_t n;
+        if (!count(n, 1)) return false;
+        s.resize(n);
+        return (bool)in.read(&s[0], n);
+    }
+};
+}
+
+bool ProgramCache::store(uint64_t key, const Chunk& chunk, const std::string& tables) const {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) return false;
+
+    std::string path = pathFor(key);
+    std::string tmp = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ostringstream body;
+        Writer w{ body };
+        body.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        w.pod(key);
+        w.pod<int32_t>(chunk.globalCount);
+        w.pod<int32_t>(chunk.localCount);
+
+        w.pod<uint32_t>((uint32_t)chunk.code.size());
+        for (const Instruction& ins : chunk.code) {
+            w.pod<int32_t>(ins.op);
+            w.pod<int32_t>(ins.arg);
+        }
+
+        w.pod<uint32_t>((uint32_t)chunk.constants.size());
+        for (const Value& v : chunk.constants) {
+            w.pod<uint8_t>(v.type);
+            switch (v.type) {
+                case VAL_INT:    w.pod<int32_t>(v.i); break;
+                case VAL_FLOAT:  w.pod<float>(v.f); break;
+                case VAL_BOOL:   w.pod<uint8_t>(v.b); break;
+                case VAL_STRING: w.str(v.s()); break;
+                case VAL_VOID:   break;
+                case VAL_OBJECT: break; //constantele nu sunt niciodata obiecte
+                case VAL_ARRAY:  break; //si nici tablouri (se creeaza la executie)
+            }
+        }
+
+        w.pod<uint32_t>((uint32_t)chunk.functions.size());
+        for (const FunctionInfo& f : chunk.functions) {
+            w.str(f.name);
+            w.pod<int32_t>(f.entry);
+            w.pod<int32_t>(f.params);
+            w.pod<int32_t>(f.locals);
+        }
+
+        w.pod<uint32_t>((uint32_t)chunk.classes.size());
+        for (const ClassInfo& c : chunk.classes) {
+            w.str(c.name);
+            w.pod<int32_t>(c.fields);
+            w.pod<int32_t>(c.defaults);
+            w.pod<int32_t>(c.init);
+        }
+
+        w.str(tables);
+
+        std::string data = body.str();
+        uint64_t sum = checksum(data);
+        std::ofstream file(tmp, std::ios::binary);
+        if (!file) return false;
+        file.write(data.data(), data.size());
+        file.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+        if (!file) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::remove(tmp.c_str());
+    return !ec;
+}
+
+bool ProgramCache::load(uint64_t key, CachedProgram& out) const {
+    std::ifstream file(pathFor(key), std::ios::binary);
+    if (!file) return false;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t sum;
+    if (data.size() < sizeof(CACHE_MAGIC) + sizeof(sum)) return false;
+    std::memcpy(&sum, data.data() + data.size() - sizeof(sum), sizeof(sum));
+    data.resize(data.size() - sizeof(sum));
+    if (sum != checksum(data)) return false;
+    std::streamoff size = (std::streamoff)data.size();
+    std::istringstream in(std::move(data));
+    Reader r{ in, size };
+
+    char magic[sizeof(CACHE_MAGIC)];
+    uint64_t storedKey;
+    int32_t globals, locals;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    if (!r.pod(storedKey) || storedKey != key) return false;
+    if (!r.pod(globals) || !r.pod(locals) || globals < 0 || locals < 0) return false;
+
+    Chunk chunk;
+    chunk.globalCount = globals;
+    chunk.localCount = locals;
+
+    uint32_t count;
+    if (!r.count(count, 2 * sizeof(int32_t)) || count == 0) return false;
+    chunk.code.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t op, arg;
+        if (!r.pod(op) || !r.pod(arg) || op < 0 || op >= OP_COUNT) return false;
+        chunk.code.push_back({ (OpCode)op, arg });
+    }
+
+    if (!r.count(count, sizeof(uint8_t))) return false;
+    chunk.constants.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t type;
+        if (!r.pod(type)) return false;
+        switch (type) {
+            case VAL_INT:    { int32_t v; if (!r.pod(v)) return false; chunk.constants.push_back(Value((int)v)); break; }
+            case VAL_FLOAT:  { float v; if (!r.pod(v)) return false; chunk.constants.push_back(Value(v)); break; }
+            case VAL_BOOL:   { uint8_t v; if (!r.pod(v)) return false; chunk.constants.push_back(Value(v != 0)); break; }
+            case VAL_STRING: { std::string v; if (!r.str(v)) return false; chunk.constants.push_back(Value(std::move(v))); break; }
+            case VAL_VOID:   chunk.constants.push_back(Value()); break;
+            default:         return false;
+        }
+    }
+
+    if (!r.count(count, sizeof(uint32_t) + 3 * sizeof(int32_t))) return false;
+    chunk.functions.resize(count);
+    for (FunctionInfo& f : chunk.functions) {
+        int32_t v[3];
+        if (!r.str(f.name)) return false;
+        for (int32_t& x : v)
+            if (!r.pod(x)) return false;
+        if (v[0] < 0 || v[0] >= (int32_t)chunk.code.size() || v[1] < 0 || v[2] < v[1]) return false;
+        f.entry = v[0]; f.params = v[1]; f.locals = v[2];
+    }
+
+    if (!r.count(count, sizeof(uint32_t) + 3 * sizeof(int32_t))) return false;
+    chunk.classes.resize(count);
+    int maxFields = 0;
+    for (ClassInfo& c : chunk.classes) {
+        int32_t v[3];
+        if (!r.str(c.name)) return false;
+        for (int32_t& x : v)
+            if (!r.pod(x)) return false;
+        //exact una dintre constante si codul de initializare
+        if (v[0] < 0 || (v[1] < 0) == (v[2] < 0)) return false;
+        if (v[1] >= 0 && (int64_t)v[1] + v[0] > (int64_t)chunk.constants.size()) return false;
+        if (v[2] >= (int32_t)chunk.code.size()) return false;
+        c.fields = v[0]; c.defaults = v[1]; c.init = v[2];
+        if (c.fields > maxFields) maxFields = c.fields;
+    }
+
+    //fiecare slot (globala, locala, camp) e un simbol cu linia lui in tabele, deci numarul lor e limitat de
+    //lungimea tabelelor; altfel VM-ul ar aloca cadre cat cere fisierul
+    std::string tables;
+    if (!r.str(tables)) return false;
+    const int64_t maxSlots = (int64_t)tables.size();
+    if (chunk.globalCount > maxSlots || chunk.localCount > maxSlots || maxFields > maxSlots) return false;
+    for (const FunctionInfo& f : chunk.functions)
+        if (f.locals > maxSlots) return false;
+
+    //cadrul fiecarei instructiuni: main de la 0, apoi fiecare functie si fiecare cod de initializare
+    //(acesta din urma fara locale) pana la urmatorul punct de intrare; la intrari egale conteaza cadrul cel mai mic
+    std::vector<std::pair<int, int>> frames = { { 0, chunk.localCount } };
+    for (const FunctionInfo& f : chunk.functions) frames.push_back({ f.entry, f.locals });
+    for (const ClassInfo& c : chunk.classes)
+        if (c.init >= 0) frames.push_back({ c.init, 0 });
+    std::sort(frames.begin(), frames.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    });
+
+    const int codeSize = (int)chunk.code.size();
+    size_t frame = 0;
+    for (int at = 0; at < codeSize; at++) {
+        const Instruction& ins = chunk.code[at];
+        while (frame + 1 < frames.size() && frames[frame + 1].first <= at) frame++;
+        switch (ins.op) {
+            case OP_CONST:
+                if (ins.arg < 0 || ins.arg >= (int)chunk.constants.size()) return false;
+                break;
+            case OP_LOAD_GLOBAL: case OP_STORE_GLOBAL:
+                if (ins.arg < 0 || ins.arg >= chunk.globalCount) return false;
+                break;
+            case OP_LOAD_LOCAL: case OP_STORE_LOCAL:
+                if (ins.arg < 0 || ins.arg >= frames[frame].second) return false;
+                break;
+            case OP_JUMP: case OP_JUMP_IF_FALSE: case OP_AND_JUMP: case OP_OR_JUMP:
+                if (ins.arg < 0 || ins.arg >= codeSize) return false;
+                break;
+            case OP_CALL: case OP_CALL_METHOD:
+                if (ins.arg < 0 || ins.arg >= (int)chunk.functions.size()) return false;
+                break;
+            case OP_NEW:
+                if (ins.arg < 0 || ins.arg >= (int)chunk.classes.size()) return false;
+                break;
+            case OP_GET_FIELD: case OP_SET_FIELD: case OP_LOAD_FIELD: case OP_STORE_FIELD:
+                if (ins.arg < 0 || ins.arg >= maxFields) return false;
+                break;
+            //tablourile: tipul elementelor, metoda si operatia; indexarile fara verificari vin doar din IR, care nu se salveaza
+            case OP_NEW_ARRAY:
+                if (ins.arg < VAL_INT || ins.arg > VAL_BOOL) return false;
+                break;
+            case OP_ARRAY_LITERAL:
+                if (ins.arg < 0 || (ins.arg & 3) > VAL_BOOL) return false;
+                break;
+            case OP_ARRAY_REDUCE:
+                if (ins.arg <= ARRAY_LENGTH || ins.arg > ARRAY_DOT) return false;
+                break;
+            case OP_ARRAY_ARITH:
+                if (ins.arg < ARRAY_ADD || ins.arg > ARRAY_MUL) return false;
+                break;
+            case OP_INDEX_UNCHECKED: case OP_SET_INDEX_UNCHECKED:
+                return false;
+            default:
+                break;
+        }
+    }
+
+    out.tables = std::move(tables);
+    out.chunk = std::move(chunk);
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "bytecode.h"
+
+//programul verificat, asa cum e pastrat pe disc: bytecode-ul coborat + tabelele de simboluri
+struct CachedProgram {
+    Chunk chunk;
+    std::string tables; //continutul lui tables.txt
+};
+
+//cache pe disc pentru programe compilate. Cheia e hash-ul sursei, al versiunii compilatorului
+//si al optiunilor care schimba bytecode-ul; un hit sare peste lexer, parser si verificare.
+class ProgramCache {
+    std::string dir;
+
+    std::string pathFor(uint64_t key) const;
+
+public:
+    explicit ProgramCache(const std::string& directory) : dir(directory) {}
+
+    static uint64_t key(const char* source, size_t size, bool fold);
+
+    //false la miss, la fisier corupt sau scris de alta versiune
+    bool load(uint64_t key, CachedProgram& out) const;
+    //scrie atomic (fisier temporar + rename), ca doua procese sa nu vada o intrare pe jumatate
+    bool store(uint64_t key, const Chunk& chunk, const std::string& tables) const;
+};
+
+#endif
@@ -3,8 +3,20 @@
   #include <vector>
   #include "types.h"
   #include "ast.h"
+
+  #ifndef YY_TYPEDEF_YY_SCANNER_T
+  #define YY_TYPEDEF_YY_SCANNER_T
+  typedef void* yyscan_t;
+  #endif
+
+  class CompilationContext;
 }
 
+%define api.pure full
+%locations
+%lex-param   { yyscan_t scanner }
+%parse-param { yyscan_t scanner } { CompilationContext* ctx }
+
 %{
 #include <iostream>
 #include <string>
@@ -16,34 +28,176 @@
 #include "ast.h"
 #include "SymTableStub.h"
 #include "inferType.h"
+#include "compilation.h"
+#include "batch.h"
+#include "cache.h"
+#include "symbol_export.h"
+#include "vm.h"
+#include "aot.h"
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+%}
 
-std::vector<std::pair<std::string, TypeInfo>> currentParams;
+%code {
+int yylex(YYSTYPE* yylval, YYLTYPE* yylloc, yyscan_t scanner);
+
+//ruleaza inaintea fiecarei actiuni: locatia implicita a regulii, plus linia primita de nodurile
+//construite in actiune (ast_node::line), fara s-o mai setam de mana in fiecare regula
+#define YYLLOC_DEFAULT(Current, Rhs, N)                                   \
+  do {                                                                    \
+    if (N) {                                                              \
+      (Current).first_line   = YYRHSLOC(Rhs, 1).first_line;               \
+      (Current).first_column = YYRHSLOC(Rhs, 1).first_column;             \
+      (Current).last_line    = YYRHSLOC(Rhs, N).last_line;                \
+      (Current).last_column  = YYRHSLOC(Rhs, N).last_column;              \
+    } else {                                                              \
+      (Current).first_line   = (Current).last_line = YYRHSLOC(Rhs, 0).last_line;     \
+      (Current).first_column = (Current).last_column = YYRHSLOC(Rhs, 0).last_column; \
+    }                                                                     \
+    ast_node::constructionLine = (Current).first_line;                    \
+  } while (0)
+
+void yyerror(YYLTYPE*, yyscan_t, CompilationContext* ctx, const char* s) {
+    ctx->error(s);
+}
 
-int semantic_errors = 0;
+//tipul comun al operanzilor, folosit pentru a alege nodul binar specializat
+static TipBaza commonType(CompilationContext* ctx, ast_node* l, ast_node* r) {
+    TypeInfo t1 = inferType(ctx, l, false);
+    TypeInfo t2 = inferType(ctx, r, false);
+    return t1 == t2 ? t1.type : TYPE_UNKNOWN;
+}
 
-extern int yylex(); 
+//copiaza in nod pozitia (depth, slot) a variabilei, calculata de SymbolTable::addSymbol
+template <typename Node>
+static Node* bindSlot(Node* node, SymbolInfo* sym) {
+    if (sym && sym->slot >= 0) {
+        node->depth = sym->depth;
+        node->slot = sym->slot;
+    }
+    return node;
+}
 
-extern int yylineno;
+//a.x: clasa statica a lui a si slotul lui x in inregistrarea obiectului (acelasi slot ca in scope-ul clasei)
+template <typename Node>
+static Node* bindMember(CompilationContext* ctx, Node* node) {
+    if (!node->obj || node->obj->kind != NODE_ID) return node;
+    SymbolInfo* o = ctx->scopes.currentScope->lookup(static_cast<id_node*>(node->obj)->name_id);
+    if (!o || o->type.type != TYPE_CLASS) return node;
+    SymbolInfo* m = ctx->scopes.lookupInClass(o->type.className, node->member_id);
+    if (m && m->slot >= 0) {
+        node->class_id = Interner::global().find(o->type.className);
+        node->slot = m->slot;
+    }
+    return node;
+}
 
-extern void yyerror(const char* s);
+//+ - * /: operanzi de acelasi tip, sau un tablou int[] / float[] cu un tablou de acelasi tip ori cu un scalar
+//de tipul elementelor (element cu element, fara /)
+static ast_node* arithmetic(CompilationContext* ctx, BinOp op, ast_node* l, ast_node* r) {
+    TypeInfo t1 = inferType(ctx, l); TypeInfo t2 = inferType(ctx, r);
+    std::string mismatch = std::string("Semantic Error: Type mismatch (") + binOpSymbol(op) + ").";
+    if (t1.type == TYPE_ARRAY || t2.type == TYPE_ARRAY) {
+        TypeInfo arr = t1.type == TYPE_ARRAY ? t1 : t2;
+        TypeInfo other = t1.type == TYPE_ARRAY ? t2 : t1;
+        bool numeric = arr.element == TYPE_INT || arr.element == TYPE_FLOAT;
+        if (op == BIN_DIV || !numeric || (other != arr && other.type != arr.element)) ctx->error(mismatch);
+        return annotateType(ctx, arenaNew<array_binary_node>(op, l, r));
+    }
+    if (t1 != t2) ctx->error(mismatch);
+    return annotateType(ctx, make_binary_node(op, l, r, t1 == t2 ? t1.type : TYPE_UNKNOWN));
+}
 
-ScopeManager scopeManager; //retine scopeul global, curent, scope-ul clasei, toate scopurile prin care am trecut
-program_node* root = nullptr;
+//a[i]: tipul lui a (verificat: tablou, indice int)
+static TypeInfo checkIndex(CompilationContext* ctx, ast_node* a, ast_node* i) {
+    TypeInfo t = inferType(ctx, a);
+    TypeInfo it = inferType(ctx, i);
+    if (t.type != TYPE_ARRAY && t.type != TYPE_UNKNOWN) ctx->error("Semantic Error: Indexed value is not an array.");
+    if (it.type != TYPE_INT && it.type != TYPE_UNKNOWN) ctx->error("Semantic Error: Array index must be int.");
+    return t;
+}
 
-%}
+static ast_node* newArrayNode(CompilationContext* ctx, TipBaza element, ast_node* n) {
+    TypeInfo t = inferType(ctx, n);
+    if (t.type != TYPE_INT && t.type != TYPE_UNKNOWN) ctx->error("Semantic Error: Array size must be int.");
+    return annotateType(ctx, arenaNew<array_new_node>(element, n));
+}
+
+//[e0, e1, ...]: toate elementele int, toate float sau toate bool
+static ast_node* arrayLiteralNode(CompilationContext* ctx, node_list* items) {
+    TipBaza element = TYPE_UNKNOWN;
+    bool same = true;
+    for (auto item : *items) {
+        TypeInfo t = inferType(ctx, item);
+        if (t.type == TYPE_UNKNOWN) continue;
+        if (element == TYPE_UNKNOWN) element = t.type;
+        if (t.type != element) same = false;
+    }
+    if (!same || (element != TYPE_INT && element != TYPE_FLOAT && element != TYPE_BOOL && element != TYPE_UNKNOWN))
+        ctx->error("Semantic Error: Array elements must be all int, all float or all bool.");
+    if (element != TYPE_FLOAT && element != TYPE_BOOL) element = TYPE_INT;
+    return annotateType(ctx, arenaNew<array_literal_node>(element, std::move(*items)));
+}
+
+//argumentele unui apel de functie sau metoda: numarul si tipul fiecaruia; un tablou trebuie sa aiba
+//acelasi tip al elementelor ca parametrul
+static void checkCallArgs(CompilationContext* ctx, const SymbolInfo* f, const node_list* args) {
+    if (f->paramInfo.size() != args->size()) {
+        ctx->error("Semantic Error: Arg count mismatch.");
+    }
+    for (size_t i = 0; i < args->size() && i < f->paramInfo.size(); ++i) {
+        TypeInfo argT = inferType(ctx, (*args)[i]);
+        const TypeInfo& p = f->paramInfo[i];
+        if (argT.type == TYPE_UNKNOWN) continue;
+        bool match = argT.type == p.type && (p.type != TYPE_ARRAY || argT.element == p.element) &&
+                     (p.type == TYPE_INT || p.type == TYPE_FLOAT || p.type == TYPE_BOOL || p.type == TYPE_STRING ||
+                      p.type == TYPE_CLASS || p.type == TYPE_ARRAY);
+        if (!match) {
+            ctx->error("Semantic Error: Arg type mismatch.");
+        }
+    }
+}
+
+//a.length(), a.sum(), a.min(), a.max(), a.dot(b); in afara de length, doar pe int[] si float[]
+static ast_node* arrayCall(CompilationContext* ctx, ast_node* a, const InternedName* name, node_list* args) {
+    TypeInfo t = inferType(ctx, a);
+    int fn = -1;
+    for (int k = ARRAY_LENGTH; k <= ARRAY_DOT; k++)
+        if (name->text == arrayFnName((ArrayFn)k)) fn = k;
+    if (fn < 0) {
+        ctx->error("Semantic Error: Array method '" + name->text + "' undefined.");
+        fn = ARRAY_LENGTH;
+    }
+    else if (args->size() != (fn == ARRAY_DOT ? 1u : 0u)) {
+        ctx->error("Semantic Error: Arg count mismatch.");
+    }
+    else if (fn != ARRAY_LENGTH && t.element != TYPE_INT && t.element != TYPE_FLOAT) {
+        ctx->error("Semantic Error: Array method '" + name->text + "' needs int[] or float[].");
+    }
+    ast_node* arg = fn == ARRAY_DOT && !args->empty() ? (*args)[0] : nullptr;
+    if (arg) {
+        TypeInfo b = inferType(ctx, arg);
+        if (b != t && b.type != TYPE_UNKNOWN) ctx->error("Semantic Error: Arg type mismatch.");
+    }
+    return annotateType(ctx, arenaNew<array_call_node>(a, (ArrayFn)fn, arg));
+}
+}
 
 %union {
   int           Int;
   float         Float;
   std::string   *String;
+  const InternedName *Name;
   TypeInfo      *TypeVal;
   ast_node      *Node;
-  std::vector<ast_node*> *NodeList; 
-  std::vector<TypeInfo>  *TypeList;
+  node_list     *NodeList; 
+  arena_vector<TypeInfo> *TypeList;
 }
 
 %token INT FLOAT STRING BOOL VOID CLASS MAIN IF WHILE RETURN PRINT TRUE FALSE
-%token <String> ID STRING_LITERAL
+%token <Name> ID
+%token <String> STRING_LITERAL
 %token <Int> INT_LITERAL
 %token <Float> FLOAT_LITERAL
 %token EQ NEQ LE GE AND OR NOT
@@ -59,7 +213,7 @@ program_node* root = nullptr;
 %left '.' '[' '('
 
 %type <TypeVal> standard_type
-%type <NodeList> arg_list arg_list_opt stmt_list global_list block_items
+%type <NodeList> arg_list arg_list_opt stmt_list global_list block_items class_member_list
 %type <TypeList> param_list param_list_nonempty
 %type <Node> expr bool_expr main_block statement var_decl func_def class_def 
 %type <TypeVal> param_decl
@@ -71,10 +225,11 @@ program_node* root = nullptr;
 program
 : global_list main_block
 {
-  root = new program_node();
-  root->globals = *$1; 
-  delete $1;
-  root->main_block = $2;
+  ctx->root = arenaNew<program_node>();
+  ctx->root->globals = std::move(*$1);
+  ctx->root->main_block = $2;
+  ctx->root->global_slots = ctx->scopes.globalScope->getSlotCount();
+  ctx->scopes.closeGlobal();
 }
 ;
 
@@ -82,7 +237,7 @@ program
 global_list
 : /* empty */ 
   { 
-    $$ = new std::vector<ast_node*>(); 
+    $$ = arenaNew<node_list>(); 
   }
 
 | global_list var_decl ';'  
@@ -106,10 +261,10 @@ main_header
 {
     //inregistram main in global
     SymbolInfo mainSym("main", TypeInfo(TYPE_INT), "function");
-    scopeManager.currentScope->addSymbol(mainSym);
+    ctx->scopes.currentScope->addSymbol(mainSym);
     
     //intram in scope
-    scopeManager.enterScope("func_main");
+    ctx->scopes.enterScope("func_main");
 }
 ;
 
@@ -117,99 +272,98 @@ main_block
 : main_header '{' stmt_list '}'
 {
     //iesim din scope DUPA ce am parsat body-ul
-    scopeManager.exitScope();
+    int frameSlots = ctx->scopes.currentScope->getSlotCount();
+    ctx->scopes.exitScope();
 
-    block_node* b = new block_node();
+    block_node* b = arenaNew<block_node>();
     for (auto s : *$3)
         if (s) b->addStatement(s);
-    delete $3;
-    $$ = new main_node(b);
+    $$ = arenaNew<main_node>(b, frameSlots);
 }
 ;
 
 
 var_decl
 : standard_type ID {
-    if (scopeManager.currentScope->lookupCurrent(*$2)) {
-        yyerror(("Semantic Error: Variable '" + *$2 + "' redeclared.").c_str());
+    if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+        ctx->error("Semantic Error: Variable '" + $2->text + "' redeclared.");
     }
-    SymbolInfo info(*$2, *$1, "variable"); 
-    scopeManager.currentScope->addSymbol(info);
+    SymbolInfo info($2->text, *$1, "variable"); 
+    ctx->scopes.currentScope->addSymbol(info);
 
-    $$ = new var_decl_node($1, *$2, nullptr);
-    delete $2;
+    $$ = bindSlot(arenaNew<var_decl_node>($1, $2->text, nullptr), ctx->scopes.currentScope->lookupCurrent($2->id));
 }
 | standard_type ID '=' expr { 
-    if (scopeManager.currentScope->lookupCurrent(*$2)) {
-        yyerror(("Semantic Error: Variable '" + *$2 + "' redeclared.").c_str()); 
+    if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+        ctx->error("Semantic Error: Variable '" + $2->text + "' redeclared."); 
     }
     
     // Logica de initializare (nu assignment simplu)
     string valStr = "?";
-    if (dynamic_cast<literal_node*>($4)) {
-        valStr = dynamic_cast<literal_node*>($4)->val;
+    if ($4 && $4->kind == NODE_LITERAL) {
+        valStr = static_cast<literal_node*>($4)->val.toString();
     }
     
-    SymbolInfo info(*$2, *$1, "variable");
+    SymbolInfo info($2->text, *$1, "variable");
     info.value = valStr;
-    scopeManager.currentScope->addSymbol(info);
+    ctx->scopes.currentScope->addSymbol(info);
 
-    TypeInfo exprT = inferType($4);
+    TypeInfo exprT = inferType(ctx, $4);
     if (*$1 != exprT && exprT.type != TYPE_UNKNOWN) {
-        yyerror(("Semantic Error: Type mismatch init '" + *$2 + "'.").c_str()); 
+        ctx->error("Semantic Error: Type mismatch init '" + $2->text + "'."); 
     }
 
-    $$ = new var_decl_node($1, *$2, $4);
-    delete $2;
+    $$ = bindSlot(arenaNew<var_decl_node>($1, $2->text, $4), ctx->scopes.currentScope->lookupCurrent($2->id));
 }
 | ID ID {
-    if (scopeManager.currentScope->lookupCurrent(*$2)) {
-        yyerror(("Semantic Error: Variable '" + *$2 + "' redeclared.").c_str()); 
+    if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+        ctx->error("Semantic Error: Variable '" + $2->text + "' redeclared."); 
     }
-    if (!scopeManager.classScopes.count(*$1)) {
-        yyerror(("Semantic Error: Class '" + *$1 + "' undefined.").c_str()); 
+    if (!ctx->scopes.isClass($1->id)) {
+        ctx->error("Semantic Error: Class '" + $1->text + "' undefined."); 
     }
 
-    TypeInfo* t = new TypeInfo(*$1);
-    SymbolInfo info(*$2, *t, "variable");
-    scopeManager.currentScope->addSymbol(info);
+    TypeInfo* t = arenaNew<TypeInfo>($1->text);
+    SymbolInfo info($2->text, *t, "variable");
+    ctx->scopes.currentScope->addSymbol(info);
 
-    $$ = new var_decl_node(t, *$2, nullptr);
-    delete $1; delete $2;
+    var_decl_node* d = bindSlot(arenaNew<var_decl_node>(t, $2->text, nullptr), ctx->scopes.currentScope->lookupCurrent($2->id));
+    //declaratia creeaza obiectul; un camp de tipul clasei care il contine ramane void (clasa e inca incompleta)
+    if (ctx->scopes.isClass($1->id) && ctx->scopes.classScope($1->id) != ctx->scopes.currentScope) d->class_id = $1->id;
+    $$ = d;
 }
 | ID ID '=' expr {
-    if (scopeManager.currentScope->lookupCurrent(*$2)) {
-        yyerror(("Semantic Error: Variable '" + *$2 + "' redeclared.").c_str()); 
+    if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+        ctx->error("Semantic Error: Variable '" + $2->text + "' redeclared."); 
     }
-    if (!scopeManager.classScopes.count(*$1)) {
-        yyerror(("Semantic Error: Class '" + *$1 + "' undefined.").c_str()); 
+    if (!ctx->scopes.isClass($1->id)) {
+        ctx->error("Semantic Error: Class '" + $1->text + "' undefined."); 
     }
 
-    TypeInfo* t = new TypeInfo(*$1);
-    SymbolInfo info(*$2, *t, "variable");
-    scopeManager.currentScope->addSymbol(info);
+    TypeInfo* t = arenaNew<TypeInfo>($1->text);
+    SymbolInfo info($2->text, *t, "variable");
+    ctx->scopes.currentScope->addSymbol(info);
 
-    $$ = new var_decl_node(t, *$2, $4);
-    delete $1; delete $2;
+    $$ = bindSlot(arenaNew<var_decl_node>(t, $2->text, $4), ctx->scopes.currentScope->lookupCurrent($2->id));
 }
 ;
 
 func_def
   : standard_type ID '(' {
         //ne asiguram ca ID nu este redclarat altundeva 
-        if (scopeManager.currentScope->lookupCurrent(*$2)) {
-            yyerror(("Semantic Error: Function '" + *$2 + "' redeclared.").c_str()); 
+        if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+            ctx->error("Semantic Error: Function '" + $2->text + "' redeclared."); 
         }
         //facem un simbol de nume {ID, tip, cat = "functie"} si intram in scope-ul functiei
-        SymbolInfo funcSym(*$2, *$1, "function");
-        scopeManager.currentScope->addSymbol(funcSym); 
-        scopeManager.enterScope("func_" + *$2); 
-        currentParams.clear();
+        SymbolInfo funcSym($2->text, *$1, "function");
+        ctx->scopes.currentScope->addSymbol(funcSym); 
+        ctx->scopes.enterScope("func_" + $2->text); 
+        ctx->currentParams.clear();
     }
     //
     param_list ')' {
         // Actualizam parametrii functiei in scope-ul parinte
-        SymbolInfo* s = scopeManager.currentScope->getParent()->lookup(*$2);
+        SymbolInfo* s = ctx->scopes.currentScope->getParent()->lookup($2->id);
         if(s) {
             for(const auto& tInfo : *$5) {
 
@@ -225,293 +379,471 @@ func_def
 
                 else if(tInfo.type == TYPE_CLASS) st = SYM_CLASS;
 
+                else if(tInfo.type == TYPE_ARRAY) st = SYM_ARRAY;
+
                 s->paramTypes.push_back(st);
+                s->paramInfo.push_back(tInfo);
             }
         }
     }
     '{' block_items '}' {
-       scopeManager.exitScope(); // Iesim din scope-ul functiei
+       int frameSlots = ctx->scopes.currentScope->getSlotCount();
+       int depth = ctx->scopes.currentScope->getDepth();
+       ctx->scopes.exitScope(); // Iesim din scope-ul functiei
 
-       std::string fname = *$2;
-       delete $2;
+       std::string fname = $2->text;
 
-       block_node* b = new block_node();
+       block_node* b = arenaNew<block_node>();
        for (auto s : *$9) if (s) b->addStatement(s);
-       delete $9;
 
       std::vector<std::string> paramNames;
-      for(auto p : currentParams) paramNames.push_back(p.first);
-
-
-      $$ = new func_def_node($1, fname, paramNames, b);
+      for(auto p : ctx->currentParams) paramNames.push_back(p.first);
+
+      func_def_node* f = arenaNew<func_def_node>($1, fname, paramNames, b);
+      f->name_id = $2->id;
+      for (auto p : ctx->currentParams) f->param_types.push_back(p.second);
+      f->depth = depth;
+      f->frame_slots = frameSlots;
+      $$ = f;
     }
  ;
 
 //in block_items, pusham un statement sau un var_decl
 block_items
-: /* empty */ { $$ = new std::vector<ast_node*>(); }
+: /* empty */ { $$ = arenaNew<node_list>(); }
 | block_items statement { $1->push_back($2); $$ = $1; }
 | block_items var_decl ';' { $1->push_back($2); $$ = $1; }
 ;
 
 //returnam un vector gol de TypeInfo sau param_list_nonempty
 param_list
-  : /* empty */         { $$ = new std::vector<TypeInfo>(); }
+  : /* empty */         { $$ = arenaNew<arena_vector<TypeInfo>>(); }
   | param_list_nonempty { $$ = $1; }
   ;
 
 //declaram un singur parametru sau mai multi parametri, pe care ii pusham recursiv
 param_list_nonempty
-  : param_decl { $$ = new std::vector<TypeInfo>(); $$->push_back(*$1); }
+  : param_decl { $$ = arenaNew<arena_vector<TypeInfo>>(); $$->push_back(*$1); }
   | param_list_nonempty ',' param_decl { $1->push_back(*$3); $$ = $1; }
   ;
 
 //verificăm dacă numele parametrului nu este duplicat în scope-ul local al funcției și îl înregistrăm ca simbol de tip "parameter"
 param_decl 
   : standard_type ID { 
-        if (scopeManager.currentScope->lookupCurrent(*$2)) {
-             yyerror("Semantic Error: Parameter redeclared."); 
+        if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+             ctx->error("Semantic Error: Parameter redeclared."); 
         }
-        scopeManager.currentScope->addSymbol(SymbolInfo(*$2, *$1, "parameter"));
+        ctx->scopes.currentScope->addSymbol(SymbolInfo($2->text, *$1, "parameter"));
  
-        currentParams.push_back({ *$2, *$1 });
+        ctx->currentParams.push_back({ $2->text, *$1 });
 
-        $$ = $1; delete $2; 
+        $$ = $1; 
     }
   ;
 
 //verificam daca id-ul nu a fost refolosit in scope-ul curent. adaugam un simbol specific clasei si intram in scope-ul ei. de asemenea salvam scope-ul
 class_def
   : CLASS ID '{' { 
-      if (scopeManager.currentScope->lookupCurrent(*$2)) {
-             yyerror("Semantic Error: Class redeclared."); 
+      if (ctx->scopes.currentScope->lookupCurrent($2->id)) {
+             ctx->error("Semantic Error: Class redeclared."); 
       }
-      scopeManager.currentScope->addSymbol(SymbolInfo(*$2, TypeInfo(*$2), "class"));
-      scopeManager.enterScope("class_" + *$2);
+      ctx->scopes.currentScope->addSymbol(SymbolInfo($2->text, TypeInfo($2->text), "class"));
+      ctx->scopes.enterScope("class_" + $2->text);
 
       //salvam scope-ul pentru a-l putea revizita, sa vedem daca o variabila exista in clasa. A x => nu vrem ca x sa fie redeclarat in alta clasa
 
-      scopeManager.saveClassScope(*$2);
+      ctx->scopes.saveClassScope($2->id);
     }
 
     //aici se proceseaza membrii/metodele clasei, iar dupa ce iesim din scope, creez obiectul din arborele sintactic care reprezinta clasa 
 
     class_member_list '}' ';' {
-      scopeManager.exitScope();
-      std::string cname = *$2;
-      delete $2;
-      $$ = new class_def_node(cname);
+      int fieldSlots = ctx->scopes.currentScope->getSlotCount();
+      ctx->scopes.exitScope();
+      std::string cname = $2->text;
+      class_def_node* c = arenaNew<class_def_node>(cname);
+      c->class_id = $2->id;
+      c->field_slots = fieldSlots;
+      c->members = std::move(*$5);
+      for (auto m : c->members)
+        if (m && m->kind == NODE_FUNC_DEF) static_cast<func_def_node*>(m)->owner = c;
+      $$ = c;
     }
   ;
 
 class_member_list
-  : /* empty */
-  | class_member_list var_decl ';'
-  | class_member_list func_def
+  : /* empty */ { $$ = arenaNew<node_list>(); }
+  | class_member_list var_decl ';' { if ($2) $1->push_back($2); $$ = $1; }
+  | class_member_list func_def { if ($2) $1->push_back($2); $$ = $1; }
   ;
 
 //construiește un vector<ast_node*> care ține pointeri către toate instrucțiunile din bloc.
 
 stmt_list
-: /* empty */ { $$ = new std::vector<ast_node*>(); }
+: /* empty */ { $$ = arenaNew<node_list>(); }
 | stmt_list statement { $1->push_back($2); $$ = $1; }
 | stmt_list var_decl ';' { $1->push_back($2); $$ = $1; }
 ;
 
 statement
 : expr ';'                    { $$ = $1; }
-| PRINT '(' expr ')' ';'      { $$ = new print_node($3); }
+| PRINT '(' expr ')' ';'      { $$ = arenaNew<print_node>($3); }
 | IF '(' bool_expr ')' '{' stmt_list '}' {
-    block_node* b = new block_node();
+    block_node* b = arenaNew<block_node>();
     for(auto s: *$6) if(s) b->addStatement(s);
-    delete $6;
-    $$ = new if_node($3, b);
+    $$ = arenaNew<if_node>($3, b);
 }
 | WHILE '(' bool_expr ')' '{' stmt_list '}' {
-    block_node* b = new block_node();
+    block_node* b = arenaNew<block_node>();
     for(auto s: *$6) if(s) b->addStatement(s);
-    delete $6;
-    $$ = new while_node($3, b);
+    $$ = arenaNew<while_node>($3, b);
 }
-| RETURN expr ';'             { $$ = new return_node($2); }
-| RETURN ';'                  { $$ = new return_node(nullptr); }
+| RETURN expr ';'             { $$ = arenaNew<return_node>($2); }
+| RETURN ';'                  { $$ = arenaNew<return_node>(nullptr); }
 ;
 
 
 bool_expr
   : expr {
-       TypeInfo t = inferType($1);
+       TypeInfo t = inferType(ctx, $1);
        if (t.type != TYPE_BOOL && t.type != TYPE_UNKNOWN) {
-           yyerror("Semantic Error: Condition must be boolean."); 
+           ctx->error("Semantic Error: Condition must be boolean."); 
        }
        $$ = $1;
     }
   ;
 
 expr
-  : INT_LITERAL       { $$ = new literal_node(to_string($1)); }
-  | FLOAT_LITERAL     { $$ = new literal_node(to_string($1)); }
-  | STRING_LITERAL    { $$ = new literal_node("\"" + *$1 + "\""); delete $1; }
-  | TRUE              { $$ = new literal_node("true"); }
-  | FALSE             { $$ = new literal_node("false"); }
-  | ID                { $$ = new id_node(*$1); delete $1; }
+  : INT_LITERAL       { $$ = arenaNew<literal_node>(Value($1), TYPE_INT); }
+  | FLOAT_LITERAL     { $$ = arenaNew<literal_node>(Value($1), TYPE_FLOAT); }
+  | STRING_LITERAL    { $$ = arenaNew<literal_node>(Value(*$1), TYPE_STRING); }
+  | TRUE              { $$ = arenaNew<literal_node>(Value(true), TYPE_BOOL); }
+  | FALSE             { $$ = arenaNew<literal_node>(Value(false), TYPE_BOOL); }
+  | ID                { $$ = annotateType(ctx, bindSlot(arenaNew<id_node>($1), ctx->scopes.currentScope->lookup($1->id))); }
   | ID '=' expr {
-    SymbolInfo* sym = scopeManager.currentScope->lookup(*$1);
+    SymbolInfo* sym = ctx->scopes.currentScope->lookup($1->id);
     
-    $$ = new assign_node(*$1, $3); 
+    $$ = annotateType(ctx, bindSlot(arenaNew<assign_node>($1, $3), sym)); 
 
     if (!sym) {
-        yyerror("Semantic Error: Variable not declared.");
+        ctx->error("Semantic Error: Variable not declared.");
     } 
     else {
         
-        TypeInfo r = inferType($3);
+        TypeInfo r = inferType(ctx, $3);
         
         // Verificam mismatch doar daca am reusit sa deducem tipul expresiei
         if (sym->type != r && r.type != TYPE_UNKNOWN) {
-            yyerror("Semantic Error: Type mismatch in assignment.");
+            ctx->error("Semantic Error: Type mismatch in assignment.");
         }
     }
-    delete $1;
 }
   | expr '.' ID '=' expr {
       //verificam daca membrul exista (folosim logica de la dot_node)
-      dot_node* tempDot = new dot_node($1, *$3);
-      TypeInfo memberType = inferType(tempDot);
-      delete tempDot; //curatam, a fost doar de test
+      dot_node tempDot($1, $3);
+      TypeInfo memberType = inferType(ctx, &tempDot); //nod temporar, doar pentru verificare
 
       if (memberType.type == TYPE_UNKNOWN) {
-          yyerror("Semantic Error: Invalid member access in assignment."); 
+          ctx->error("Semantic Error: Invalid member access in assignment."); 
       }
 
       //verificam daca valoarea atribuita are tipul corect
-      TypeInfo valType = inferType($5);
+      TypeInfo valType = inferType(ctx, $5);
       if (memberType != valType && valType.type != TYPE_UNKNOWN) {
-          yyerror("Semantic Error: Type mismatch in member assignment."); 
+          ctx->error("Semantic Error: Type mismatch in member assignment."); 
       }
 
-      $$ = new member_assign_node($1, *$3, $5);
-      delete $3;
+      $$ = annotateType(ctx, bindMember(ctx, arenaNew<member_assign_node>($1, $3, $5)));
   }
 
-  | expr '+' expr     { 
-       TypeInfo t1 = inferType($1); TypeInfo t2 = inferType($3);
-       if (t1 != t2) { yyerror("Semantic Error: Type mismatch (+)."); 
-       }
-       $$ = new binary_expr_node("+", $1, $3); 
-    }
-  | expr '-' expr     { 
-       TypeInfo t1 = inferType($1); TypeInfo t2 = inferType($3);
-       if (t1 != t2) { yyerror("Semantic Error: Type mismatch (-)."); 
-       }
-       $$ = new binary_expr_node("-", $1, $3); 
-    }
-  | expr '*' expr     { 
-       TypeInfo t1 = inferType($1); TypeInfo t2 = inferType($3);
-       if (t1 != t2) { yyerror("Semantic Error: Type mismatch (*)."); 
-       }
-       $$ = new binary_expr_node("*", $1, $3); 
-    }
-  | expr '/' expr     { 
-       TypeInfo t1 = inferType($1); TypeInfo t2 = inferType($3);
-       if (t1 != t2) { yyerror("Semantic Error: Type mismatch (/)."); 
-       }
-       $$ = new binary_expr_node("/", $1, $3); 
-    }
-  | expr AND expr     { $$ = new binary_expr_node("&&", $1, $3); }
-  | expr OR expr      { $$ = new binary_expr_node("||", $1, $3); }
-  | expr EQ expr      { $$ = new binary_expr_node("==", $1, $3); }
-  | expr NEQ expr     { $$ = new binary_expr_node("!=", $1, $3); }
-  | expr '<' expr     { $$ = new binary_expr_node("<", $1, $3); }
-  | expr '>' expr     { $$ = new binary_expr_node(">", $1, $3); }
-  | expr LE expr      { $$ = new binary_expr_node("<=", $1, $3); }
-  | expr GE expr      { $$ = new binary_expr_node(">=", $1, $3); }
-  | NOT expr          { $$ = new binary_expr_node("!", $2, nullptr); }
+  | expr '+' expr     { $$ = arithmetic(ctx, BIN_ADD, $1, $3); }
+  | expr '-' expr     { $$ = arithmetic(ctx, BIN_SUB, $1, $3); }
+  | expr '*' expr     { $$ = arithmetic(ctx, BIN_MUL, $1, $3); }
+  | expr '/' expr     { $$ = arithmetic(ctx, BIN_DIV, $1, $3); }
+  | expr AND expr     { $$ = annotateType(ctx, make_binary_node(BIN_AND, $1, $3, TYPE_BOOL)); }
+  | expr OR expr      { $$ = annotateType(ctx, make_binary_node(BIN_OR, $1, $3, TYPE_BOOL)); }
+  | expr EQ expr      { $$ = annotateType(ctx, make_binary_node(BIN_EQ, $1, $3, commonType(ctx, $1, $3))); }
+  | expr NEQ expr     { $$ = annotateType(ctx, make_binary_node(BIN_NE, $1, $3, commonType(ctx, $1, $3))); }
+  | expr '<' expr     { $$ = annotateType(ctx, make_binary_node(BIN_LT, $1, $3, commonType(ctx, $1, $3))); }
+  | expr '>' expr     { $$ = annotateType(ctx, make_binary_node(BIN_GT, $1, $3, commonType(ctx, $1, $3))); }
+  | expr LE expr      { $$ = annotateType(ctx, make_binary_node(BIN_LE, $1, $3, commonType(ctx, $1, $3))); }
+  | expr GE expr      { $$ = annotateType(ctx, make_binary_node(BIN_GE, $1, $3, commonType(ctx, $1, $3))); }
+  | NOT expr          { $$ = annotateType(ctx, make_binary_node(BIN_NOT, $2, nullptr, TYPE_BOOL)); }
   | '(' expr ')'      { $$ = $2; }
   | ID '(' arg_list_opt ')' {
-      SymbolInfo* f = scopeManager.currentScope->lookup(*$1);
+      SymbolInfo* f = ctx->scopes.currentScope->lookup($1->id);
 
       if (!f) { 
-        yyerror("Semantic Error: Function undefined.");  
+        ctx->error("Semantic Error: Function undefined.");  
+        //in locul apelului, un nod void de tip necunoscut (ca o variabila nedefinita)
+        $$ = arenaNew<literal_node>(Value(), TYPE_UNKNOWN);
       }
       else {
-        if (f->paramTypes.size() != $3->size()) { 
-          yyerror("Semantic Error: Arg count mismatch."); 
-        }
-        for(size_t i=0; i<$3->size() && i < f->paramTypes.size(); ++i) { 
+        checkCallArgs(ctx, f, $3);
 
-            TypeInfo argT = inferType((*$3)[i]);
-
-            if (argT.type != TYPE_UNKNOWN) {
-                bool match = false;
-
-                if (argT.type == TYPE_INT && f->paramTypes[i] == SYM_INT) match = true;
-
-                else if (argT.type == TYPE_FLOAT && f->paramTypes[i] == SYM_FLOAT) match = true;
-
-                else if (argT.type == TYPE_BOOL && f->paramTypes[i] == SYM_BOOL) match = true;
-
-                else if (argT.type == TYPE_STRING && f->paramTypes[i] == SYM_STRING) match = true;
-
-                else if (argT.type == TYPE_CLASS && f->paramTypes[i] == SYM_CLASS) match = true;
-
-                if(!match) { 
-                  yyerror("Semantic Error: Arg type mismatch."); 
-                }
-          }
-      }
-      
-      $$ = new call_node(*$1, *$3,f->type); delete $1; delete $3;
+      //metoda apelata din interiorul clasei ei: se cheama pe acelasi obiect
+      SymbolTable* owner = ctx->scopes.currentScope;
+      while (owner && !owner->lookupCurrent($1->id)) owner = owner->getParent();
+      $$ = annotateType(ctx, arenaNew<call_node>($1, std::move(*$3), f->type, ctx->scopes.classIdOf(owner)));
     }
   }
+  | expr '[' expr ']' {
+       checkIndex(ctx, $1, $3);
+       $$ = annotateType(ctx, arenaNew<index_node>($1, $3));
+    }
+  | expr '[' expr ']' '=' expr {
+       TypeInfo t = checkIndex(ctx, $1, $3);
+       TypeInfo v = inferType(ctx, $6);
+       if (t.type == TYPE_ARRAY && v != TypeInfo(t.element) && v.type != TYPE_UNKNOWN) {
+           ctx->error("Semantic Error: Type mismatch in element assignment.");
+       }
+       $$ = annotateType(ctx, arenaNew<index_assign_node>($1, $3, $6));
+    }
+  | INT '[' expr ']'      { $$ = newArrayNode(ctx, TYPE_INT, $3); }
+  | FLOAT '[' expr ']'    { $$ = newArrayNode(ctx, TYPE_FLOAT, $3); }
+  | BOOL '[' expr ']'     { $$ = newArrayNode(ctx, TYPE_BOOL, $3); }
+  | '[' arg_list ']'      { $$ = arrayLiteralNode(ctx, $2); }
   | expr '.' ID { 
-       dot_node* node = new dot_node($1, *$3);
-       TypeInfo t = inferType(node);
-       if (t.type == TYPE_UNKNOWN) { yyerror("Semantic Error: Invalid member access."); 
+       dot_node* node = bindMember(ctx, arenaNew<dot_node>($1, $3));
+       TypeInfo t = inferType(ctx, node);
+       if (t.type == TYPE_UNKNOWN) { ctx->error("Semantic Error: Invalid member access."); 
        }
-       $$ = node; delete $3; 
+       $$ = node; 
     }
   | expr '.' ID '(' arg_list_opt ')' {
-  //verifici că expr e obiect de clasă și metoda există
-  //verifici parametrii metodei
-  $$ = new method_call_node($1, *$3, *$5);
-  delete $3;
-  delete $5;
+  //metodele predefinite ale tablourilor
+  if (inferType(ctx, $1, false).type == TYPE_ARRAY) {
+    $$ = arrayCall(ctx, $1, $3, $5);
+  }
+  else {
+    //verifici că expr e obiect de clasă și metoda există
+    //verifici parametrii metodei
+    int classId = -1;
+    if ($1 && $1->kind == NODE_ID) {
+      SymbolInfo* o = ctx->scopes.currentScope->lookup(static_cast<id_node*>($1)->name_id);
+      if (o && o->type.type == TYPE_CLASS) {
+        classId = Interner::global().find(o->type.className);
+        SymbolInfo* m = ctx->scopes.lookupInClass(o->type.className, $3->id);
+        if (m && m->category == "function") checkCallArgs(ctx, m, $5);
+      }
+    }
+    $$ = annotateType(ctx, arenaNew<method_call_node>($1, $3, std::move(*$5), classId));
+  }
 }
 
 ;
 
 arg_list_opt
-  : /* empty */ { $$ = new std::vector<ast_node*>(); }
+  : /* empty */ { $$ = arenaNew<node_list>(); }
   | arg_list    { $$ = $1; }
   ;
 
 arg_list
-  : expr { $$ = new std::vector<ast_node*>(); $$->push_back($1); }
+  : expr { $$ = arenaNew<node_list>(); $$->push_back($1); }
   | arg_list ',' expr { $1->push_back($3); $$ = $1; }
   ;
 
 standard_type
-  : INT     { $$ = new TypeInfo(TYPE_INT); }
-  | FLOAT   { $$ = new TypeInfo(TYPE_FLOAT); }
-  | VOID    { $$ = new TypeInfo(TYPE_VOID); }
-  | BOOL    { $$ = new TypeInfo(TYPE_BOOL); }
-  | STRING  { $$ = new TypeInfo(TYPE_STRING); }
+  : INT     { $$ = arenaNew<TypeInfo>(TYPE_INT); }
+  | FLOAT   { $$ = arenaNew<TypeInfo>(TYPE_FLOAT); }
+  | VOID    { $$ = arenaNew<TypeInfo>(TYPE_VOID); }
+  | BOOL    { $$ = arenaNew<TypeInfo>(TYPE_BOOL); }
+  | STRING  { $$ = arenaNew<TypeInfo>(TYPE_STRING); }
+  | INT '[' ']'   { $$ = arenaNew<TypeInfo>(TypeInfo::arrayOf(TYPE_INT)); }
+  | FLOAT '[' ']' { $$ = arenaNew<TypeInfo>(TypeInfo::arrayOf(TYPE_FLOAT)); }
+  | BOOL '[' ']'  { $$ = arenaNew<TypeInfo>(TypeInfo::arrayOf(TYPE_BOOL)); }
   ;
 
 %%
 
-int main() {
-  if (yyparse() == 0) {
-    scopeManager.dumpAllScopes("tables.txt");
+//COMP_NO_MAIN: pentru binarele (benchmark-uri) care folosesc doar parserul si CompilationContext
+#ifndef COMP_NO_MAIN
+
+//tables.txt, ca in dumpAllScopes; acelasi continut fie din parser, fie din cache
+static void writeTables(const std::string& text) {
+  std::ofstream out("tables.txt");
+  if (!out.is_open()) return;
+  out << text;
+  out.close();
+  std::cout << "[Info] tabel simbol a fost aruncat in tables.txt" << std::endl;
+}
+
+//moduri de executie: --vm (implicit, bytecode) sau --tree (interpretorul pe arbore, pastrat ca referinta)
+int main(int argc, char** argv) {
+  bool useVM = true;
+  bool useIr = false;
+  IrPasses irPasses;
+  bool dumpIr = false;
+  bool dumpBytecode = false;
+  bool fold = true;
+  bool checkOnly = false;
+  bool batch = false;
+  BatchOptions batchOptions;
+  std::vector<std::string> batchInputs;
+  std::string inputPath; //gol = citim de la stdin
+  std::string cacheDir;  //gol = fara cache
+  bool showStats = false;
+  bool profile = false;
+  bool lineBuffered = false;
+  bool dumpTables = false;
+  std::string exportPath; //gol = fara export structurat
+  std::string aotPath;    //gol = executie in interpretor; altfel executabilul nativ construit cu g++
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--tree") { useVM = false; useIr = false; }
+    else if (arg == "--vm") { useVM = true; useIr = false; }
+    else if (arg == "--dump-bytecode") dumpBytecode = true;
+    else if (arg == "--ir") { useIr = true; useVM = true; } //VM, cu bytecode-ul produs din IR-ul SSA optimizat
+    else if (arg == "--dump-ir") { dumpIr = true; useIr = true; useVM = true; }
+    else if (arg == "--no-cse") irPasses.cse = false;
+    else if (arg == "--no-licm") irPasses.licm = false;
+    else if (arg == "--no-copyprop") irPasses.copyProp = false;
+    else if (arg == "--no-dse") irPasses.dse = false;
+    else if (arg == "--no-bounds-elim") irPasses.boundsElim = false;
+    else if (arg == "--no-inline") irPasses.inlineSize = 0;
+    else if (arg == "--inline-size" && i + 1 < argc) irPasses.inlineSize = std::atoi(argv[++i]); //0 sau negativ = oprit
+    else if (arg == "--no-fold") fold = false;
+    else if (arg == "--check") checkOnly = true;
+    else if (arg == "--stats") showStats = true;
+    else if (arg == "--line-buffered") lineBuffered = true;
+    else if (arg == "--tables") dumpTables = true;
+    else if (arg == "--export-symbols" && i + 1 < argc) exportPath = argv[++i];
+    else if (arg == "--aot" && i + 1 < argc) aotPath = argv[++i];
+    else if (arg == "--profile") { profile = true; useVM = false; } //profilul e pe nodurile arborelui, deci --tree
+    else if (arg == "--batch") batch = true;
+    else if (arg == "-j" && i + 1 < argc) batchOptions.jobs = std::atoi(argv[++i]);
+    else if (arg == "--out" && i + 1 < argc) batchOptions.outDir = argv[++i];
+    else if (arg == "--cache" && i + 1 < argc) cacheDir = argv[++i];
+    else if (batch && arg[0] != '-') batchInputs.push_back(arg);
+    else if (arg[0] != '-' && inputPath.empty()) inputPath = arg;
+    else {
+      std::cerr << "Usage: " << argv[0] << " [--vm | --tree | --ir] [--dump-bytecode] [--dump-ir] [--no-cse] [--no-licm] [--no-copyprop] [--no-dse] [--no-bounds-elim] [--no-inline] [--inline-size N] [--no-fold] [--check] [--stats] [--profile] [--line-buffered] [--tables] [--export-symbols FILE] [--aot EXE] [--cache DIR] [fisier | < program]" << std::endl;
+      std::cerr << "       " << argv[0] << " --batch [-j N] [--out DIR] fisier|director..." << std::endl;
+      return 1;
+    }
+  }
 
-    if (root && semantic_errors == 0) { 
-      SymTableStub runtime;
-      root->eval(&runtime);
+  //modul lot: doar compilare si verificare, in paralel, fara executie
+  if (batch) return runBatch(batchInputs, batchOptions);
+
+  //iesirea lui print: buffer mare, golit la final; linie cu linie pe terminal sau cu --line-buffered
+  OutputSink& out = standardOutput();
+  out.setLineBuffered(lineBuffered || isatty(STDOUT_FILENO));
+
+  //--stats: raportul se tipareste la stderr la iesire, pe orice ramura
+  Stats stats;
+  struct StatsReport {
+    Stats* stats;
+    ~StatsReport() { if (stats) stats->print(std::cerr); }
+  } statsReport{ showStats ? &stats : nullptr };
+  Stats::Scope statsScope(statsReport.stats);
+
+  //cu --cache, sursa e citita integral ca sa-i putem calcula cheia; un hit ruleaza direct bytecode-ul
+  bool useCache = !cacheDir.empty() && useVM && !useIr && !checkOnly && exportPath.empty() && aotPath.empty();
+  MappedSource source;
+  std::string stdinText;
+  if (!inputPath.empty() && !source.open(inputPath)) {
+    std::cerr << "Error: cannot open '" << inputPath << "': " << source.error() << std::endl;
+    return 1;
+  }
+  if (useCache && inputPath.empty()) {
+    std::ostringstream text;
+    text << std::cin.rdbuf();
+    stdinText = text.str();
+  }
+
+  ProgramCache cache(cacheDir);
+  uint64_t cacheKey = 0;
+  if (useCache) {
+    cacheKey = inputPath.empty() ? ProgramCache::key(stdinText.data(), stdinText.size(), fold)
+                                 : ProgramCache::key(source.data(), source.size(), fold);
+    CachedProgram cached;
+    bool hit;
+    {
+      PhaseTimer timer(statsReport.stats, "cache");
+      hit = cache.load(cacheKey, cached);
+    }
+    if (hit) {
+      if (dumpTables) writeTables(cached.tables);
+      if (dumpBytecode) cached.chunk.disassemble(std::cerr);
+      PhaseTimer timer(statsReport.stats, "run");
+      VM vm;
+      return vm.run(cached.chunk, out) ? 0 : 1;
+    }
+  }
+
+  //tot ce aloca parserul si lexerul (noduri, tipuri, siruri, liste) traieste in arena contextului si se elibereaza la final
+  CompilationContext ctx;
+  ctx.stats = statsReport.stats;
+  ctx.irPasses = irPasses;
+  ctx.dumpIr = dumpIr;
+
+  //--export-symbols: fiecare scope e scris in fisier in momentul in care parserul il inchide
+  std::ofstream exportFile;
+  JsonLinesExporter exporter(exportFile);
+  if (!exportPath.empty()) {
+    exportFile.open(exportPath);
+    if (!exportFile.is_open()) {
+      std::cerr << "Error: cannot write '" << exportPath << "'" << std::endl;
+      return 1;
+    }
+    ctx.scopes.listener = &exporter;
+  }
+
+  bool parsed;
+  bool completed = true; //false dupa o eroare la executie: codul de iesire e atunci 1
+  if (!inputPath.empty()) parsed = ctx.parse(source);
+  else if (useCache) parsed = ctx.parse(stdinText.data(), stdinText.size());
+  else parsed = ctx.parse(stdin); //pipe-uri si redirectari
+  source.close();
+  ctx.printDiagnostics(std::cerr);
+
+  if (parsed) {
+    //tables.txt doar la cerere (--tables); cache-ul are nevoie de text ca sa-l poata reface la un hit
+    std::ostringstream tables;
+    if (dumpTables || useCache) {
+      PhaseTimer timer(statsReport.stats, "dump");
+      ctx.scopes.dumpAllScopes(tables);
+      if (dumpTables) writeTables(tables.str());
+    }
+
+    if (checkOnly) {
+      if (ctx.semantic_errors) std::cerr << "Programul contine " << ctx.semantic_errors << " erori." << std::endl;
+      return ctx.semantic_errors ? 1 : 0;
+    }
+
+    //--aot: EXE.cpp + executabilul EXE; programul nu se mai ruleaza aici
+    if (ctx.ok() && !aotPath.empty()) {
+      std::string error;
+      if (!buildNative(ctx.emitCpp(fold), aotPath, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+      }
+      std::cerr << "[Info] executabilul a fost scris in " << aotPath << std::endl;
+    }
+    else if (ctx.ok() && useCache) {
+      Chunk chunk = ctx.lower(fold);
+      cache.store(cacheKey, chunk, tables.str());
+      if (dumpBytecode) chunk.disassemble(std::cerr);
+      PhaseTimer timer(statsReport.stats, "run");
+      VM vm;
+      completed = vm.run(chunk, out);
+    }
+    else if (ctx.ok() && profile) {
+      Profiler profiler;
+      ctx.profiler = &profiler;
+      completed = ctx.execute(EXEC_TREE, out, fold);
+      if (profiler.writeReport("profile.txt") && profiler.writeFolded("profile.folded"))
+        std::cerr << "[Info] profilul a fost scris in profile.txt si profile.folded" << std::endl;
+    }
+    else if (ctx.ok()) {
+      completed = ctx.execute(useIr ? EXEC_IR : useVM ? EXEC_VM : EXEC_TREE, out, fold, dumpBytecode);
     } 
     else {
-        std::cerr << "Programul contine " << semantic_errors << " erori. Executia a fost anulata." << std::endl;
+        std::cerr << "Programul contine " << ctx.semantic_errors << " erori. Executia a fost anulata." << std::endl;
     }
   }
-  return 0;
-}
\ No newline at end of file
+  return completed ? 0 : 1;
+}
+
+#endif
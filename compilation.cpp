@@ -0,0 +1,147 @@
+#include "compilation.h"
+#include "comp.tab.h"
+#include "vm.h"
+#include "fold.h"
+#include "aot.h"
+
+//interfata scannerului reentrant generat de flex (lex.yy.c)
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+int yylex_init_extra(CompilationContext* extra, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* in, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int len, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
+
+bool CompilationContext::runParser() {
+    Arena::Scope arenaScope(arena);
+    Stats::Scope statsScope(stats);
+    PhaseTimer timer(stats, "parse");
+    int rc = yyparse(scanner, this);
+    yylex_destroy(scanner);
+    scanner = nullptr;
+    return rc == 0;
+}
+
+bool CompilationContext::parse(FILE* in) {
+    yylex_init_extra(this, &scanner);
+    yyset_in(in, scanner);
+    return runParser();
+}
+
+bool CompilationContext::parse(const char* data, size_t size) {
+    yylex_init_extra(this, &scanner);
+    yy_scan_bytes(data, (int)size, scanner);
+    return runParser();
+}
+
+bool CompilationContext::parse(MappedSource& source) {
+    yylex_init_extra(this, &scanner);
+    yy_scan_buffer(source.data(), source.scanSize(), scanner); //scanerul citeste direct din mapare
+    return runParser();
+}
+
+void CompilationContext::error(const std::string& msg) {
+    int line = scanner ? yyget_lineno(scanner) : 0;
+    diagnostics.push_back("Error: " + msg + " at line " + std::to_string(line));
+    semantic_errors++;
+}
+
+void CompilationContext::printDiagnostics(std::ostream& out) const {
+    for (const auto& d : diagnostics) out << d << "\n";
+    out.flush();
+}
+
+Chunk CompilationContext::lower(bool fold) {
+    if (!ok()) return Chunk();
+    Arena::Scope arenaScope(arena);
+    Stats::Scope statsScope(stats);
+
+    if (fold) {
+        PhaseTimer timer(stats, "fold");
+        foldConstants(root);
+    }
+    PhaseTimer timer(stats, "lower");
+    BytecodeCompiler compiler;
+    return compiler.compile(root);
+}
+
+Chunk CompilationContext::lowerOptimized(bool fold) {
+    if (!ok()) return Chunk();
+    Arena::Scope arenaScope(arena);
+    Stats::Scope statsScope(stats);
+
+    if (fold) {
+        PhaseTimer timer(stats, "fold");
+        foldConstants(root);
+    }
+
+    IrFunction fn;
+    {
+        PhaseTimer timer(stats, "ir");
+        IrBuilder builder;
+        fn = builder.build(root, irPasses.inlineSize);
+    }
+    if (dumpIr) {
+        std::cerr << "; IR inainte de optimizare\n";
+        fn.dump(std::cerr);
+    }
+    {
+        PhaseTimer timer(stats, "optimize");
+        optimizeIr(fn, irPasses);
+    }
+    if (dumpIr) {
+        std::cerr << "; IR dupa optimizare (cse=" << irPasses.cse << " licm=" << irPasses.licm
+                  << " copyprop=" << irPasses.copyProp << " dse=" << irPasses.dse << " bounds=" << irPasses.boundsElim
+                  << " inline=" << irPasses.inlineSize << ")\n";
+        fn.dump(std::cerr);
+    }
+    PhaseTimer timer(stats, "lower");
+    return lowerIr(fn, root);
+}
+
+std::string CompilationContext::emitCpp(bool fold) {
+    if (!ok()) return std::string();
+    Arena::Scope arenaScope(arena);
+    Stats::Scope statsScope(stats);
+
+    if (fold) {
+        PhaseTimer timer(stats, "fold");
+        foldConstants(root);
+    }
+    PhaseTimer timer(stats, "emit");
+    CppEmitter emitter;
+    return emitter.emit(root);
+}
+
+bool CompilationContext::execute(ExecMode mode, OutputSink& out, bool fold, bool dumpBytecode) {
+    if (!ok()) return false;
+
+    if (mode == EXEC_VM || mode == EXEC_IR) {
+        Chunk chunk = mode == EXEC_IR ? lowerOptimized(fold) : lower(fold);
+        if (dumpBytecode) chunk.disassemble(std::cerr);
+        PhaseTimer timer(stats, "run");
+        VM vm;
+        return vm.run(chunk, out);
+    }
+    else {
+        Arena::Scope arenaScope(arena);
+        Stats::Scope statsScope(stats);
+        if (fold) {
+            PhaseTimer timer(stats, "fold");
+            foldConstants(root);
+        }
+        PhaseTimer timer(stats, "eval");
+        Profiler::Scope profilerScope(profiler);
+        SymTableStub runtime;
+        runtime.out = &out;
+        OutputSink::Scope outScope(&out);
+        root->eval(&runtime);
+        return runtime.completion != COMPLETION_ABORT;
+    }
+}
+
+bool CompilationContext::execute(ExecMode mode, std::ostream& out, bool fold, bool dumpBytecode) {
+    StreamSink sink(out);
+    return execute(mode, sink, fold, dumpBytecode);
+}
@@ -0,0 +1,75 @@
+#ifndef COMPILATION_H
+#define COMPILATION_H
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "arena.h"
+#include "symbol_table.h"
+#include "ast.h"
+#include "source_file.h"
+#include "bytecode.h"
+#include "ir.h"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+enum ExecMode {
+    EXEC_VM,
+    EXEC_TREE,
+    EXEC_IR    //VM, cu bytecode-ul obtinut din IR-ul SSA optimizat
+};
+
+//tot ce tine de o singura compilare: arena, scope-urile, AST-ul, erorile si scannerul.
+//Mai multe contexte pot fi folosite in paralel, pe thread-uri diferite.
+class CompilationContext {
+public:
+    Arena arena;
+    ScopeManager scopes; //retine scopeul global, curent, scope-ul clasei, toate scopurile prin care am trecut
+    program_node* root = nullptr;
+    int semantic_errors = 0;
+    std::vector<std::pair<std::string, TypeInfo>> currentParams; //parametrii functiei in curs de parsare
+    std::vector<std::string> diagnostics; //mesajele de eroare, in ordinea aparitiei
+    yyscan_t scanner = nullptr;
+    Stats* stats = nullptr; //--stats: timpii pe faze si contoarele acestei compilari
+    Profiler* profiler = nullptr; //--profile: masoara executia pe arbore
+    IrPasses irPasses;            //--ir: trecerile active
+    bool dumpIr = false;          //--dump-ir: IR-ul inainte si dupa optimizare, la stderr
+
+    CompilationContext() {}
+    CompilationContext(const CompilationContext&) = delete;
+    CompilationContext& operator=(const CompilationContext&) = delete;
+
+    //parseaza si verifica programul; false la eroare de sintaxa
+    bool parse(FILE* in);
+    bool parse(const char* data, size_t size);
+    bool parse(MappedSource& source); //fara copiere; sursa trebuie sa ramana mapata pe durata parsarii
+
+    //eroare semantica sau de sintaxa, cu linia curenta a scannerului
+    void error(const std::string& msg);
+    void printDiagnostics(std::ostream& out) const;
+
+    bool ok() const { return root && semantic_errors == 0; }
+
+    //coboara programul verificat in bytecode (cu folding optional)
+    Chunk lower(bool fold = true);
+    //acelasi program, trecut prin IR-ul SSA si trecerile din irPasses
+    Chunk lowerOptimized(bool fold = true);
+
+    //sursa C++ echivalenta pentru compilarea ahead-of-time (--aot)
+    std::string emitCpp(bool fold = true);
+
+    //ruleaza programul verificat; iesirea lui print merge in out. false daca nu a rulat (erori semantice)
+    //sau s-a oprit dintr-o eroare la executie
+    bool execute(ExecMode mode, OutputSink& out, bool fold = true, bool dumpBytecode = false);
+    bool execute(ExecMode mode, std::ostream& out, bool fold = true, bool dumpBytecode = false);
+
+private:
+    bool runParser();
+};
+
+#endif
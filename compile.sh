@@ -5,5 +5,13 @@ rm -f lex.yy.c
 rm -f $1.tab.c
 rm -f $1
 bison -d $1.y
-lex $1.l
-g++ lex.yy.c  $1.tab.c value.cpp -o $1
+#lexerul: implicit cel generat de flex din $1.l; LEXER=scanner foloseste scanner.cpp (scris de mana,
+#SSE2 sau AVX2 dupa CXXFLAGS, ex. CXXFLAGS="-O2 -mavx2"; -DSCANNER_NO_SIMD pentru varianta scalara).
+#Nucleele tablourilor (array.cpp) urmeaza aceleasi CXXFLAGS; -DARRAY_NO_SIMD pentru varianta scalara
+if [ "$LEXER" = "scanner" ]; then
+    LEXSRC=scanner.cpp
+else
+    lex $1.l
+    LEXSRC=lex.yy.c
+fi
+g++ $LEXSRC $1.tab.c value.cpp array.cpp bytecode.cpp vm.cpp fold.cpp ir.cpp ir_passes.cpp aot.cpp compilation.cpp batch.cpp source_file.cpp cache.cpp profiler.cpp output.cpp $CXXFLAGS -o $1
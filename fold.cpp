@@ -0,0 +1,208 @@
+#include "fold.h"
+
+namespace {
+
+struct Folder {
+    int rewrites = 0;
+
+    static TipBaza typeOf(const Value& v) {
+        switch (v.type) {
+            case VAL_INT: return TYPE_INT;
+            case VAL_FLOAT: return TYPE_FLOAT;
+            case VAL_BOOL: return TYPE_BOOL;
+            case VAL_STRING: return TYPE_STRING;
+            default: return TYPE_UNKNOWN;
+        }
+    }
+
+    //literalul ia locul lui `from` si ii pastreaza linia (pentru --profile si mesaje)
+    ast_node* literal(const Value& v, const ast_node* from) {
+        rewrites++;
+        ast_node* lit = arenaNew<literal_node>(v, typeOf(v));
+        lit->line = from->line;
+        return lit;
+    }
+
+    static literal_node* asLiteral(ast_node* node) {
+        return node && node->kind == NODE_LITERAL ? static_cast<literal_node*>(node) : nullptr;
+    }
+
+    ast_node* expr(ast_node* node) {
+        if (!node) return node;
+
+        switch (node->kind) {
+            case NODE_BINARY: {
+                binary_expr_node* bin = static_cast<binary_expr_node*>(node);
+                bin->left = expr(bin->left);
+                if (bin->right) bin->right = expr(bin->right);
+
+                literal_node* l = asLiteral(bin->left);
+                literal_node* r = asLiteral(bin->right);
+
+                if (bin->op == BIN_AND || bin->op == BIN_OR) {
+                    if (!l || l->val.type != VAL_BOOL) return node;
+                    bool decides = (bin->op == BIN_AND) ? !l->val.b : l->val.b;
+                    if (decides) return literal(l->val, node);
+                    if (r) return literal(Value(r->val.type == VAL_BOOL && r->val.b), node);
+                    return node;
+                }
+
+                if (!l || (bin->right && !r)) return node;
+
+                //operanzii sunt literali, deci eval nu are nevoie de cadrele de executie
+                Value v = bin->eval(nullptr);
+                if (v.type == VAL_VOID) return node; //de ex. impartire la zero, ramane pe seama executiei
+                return literal(v, node);
+            }
+
+            case NODE_ASSIGN: {
+                assign_node* a = static_cast<assign_node*>(node);
+                a->val = expr(a->val);
+                return node;
+            }
+
+            case NODE_MEMBER_ASSIGN: {
+                member_assign_node* ma = static_cast<member_assign_node*>(node);
+                ma->val = expr(ma->val);
+                return node;
+            }
+
+            case NODE_CALL:
+                for (auto& arg : static_cast<call_node*>(node)->args) arg = expr(arg);
+                return node;
+
+            case NODE_METHOD_CALL:
+                for (auto& arg : static_cast<method_call_node*>(node)->args) arg = expr(arg);
+                return node;
+
+            //tablourile se creeaza la executie: se pliaza doar subexpresiile
+            case NODE_ARRAY_NEW: {
+                array_new_node* a = static_cast<array_new_node*>(node);
+                a->size = expr(a->size);
+                return node;
+            }
+
+            case NODE_ARRAY_LITERAL:
+                for (auto& item : static_cast<array_literal_node*>(node)->items) item = expr(item);
+                return node;
+
+            case NODE_INDEX: {
+                index_node* ix = static_cast<index_node*>(node);
+                ix->arr = expr(ix->arr);
+                ix->index = expr(ix->index);
+                return node;
+            }
+
+            case NODE_INDEX_ASSIGN: {
+                index_assign_node* ia = static_cast<index_assign_node*>(node);
+                ia->arr = expr(ia->arr);
+                ia->index = expr(ia->index);
+                ia->val = expr(ia->val);
+                return node;
+            }
+
+            case NODE_ARRAY_CALL: {
+                array_call_node* ac = static_cast<array_call_node*>(node);
+                ac->arr = expr(ac->arr);
+                if (ac->arg) ac->arg = expr(ac->arg);
+                return node;
+            }
+
+            default:
+                return node;
+        }
+    }
+
+    void block(block_node* b) {
+        if (!b) return;
+        node_list kept(b->statements.get_allocator());
+        for (auto s : b->statements) {
+            ast_node* folded = stmt(s);
+            if (!folded) continue;
+            kept.push_back(folded);
+            if (folded->kind == NODE_RETURN) {
+                if (kept.size() < b->statements.size()) rewrites++;
+                break; //restul blocului nu mai e accesibil
+            }
+        }
+        b->statements = std::move(kept);
+    }
+
+    //returneaza nodul care inlocuieste instructiunea, sau nullptr daca ea dispare
+    ast_node* stmt(ast_node* node) {
+        if (!node) return node;
+
+        switch (node->kind) {
+            case NODE_BLOCK:
+                block(static_cast<block_node*>(node));
+                return node;
+
+            case NODE_IF: {
+                if_node* i = static_cast<if_node*>(node);
+                i->condition = expr(i->condition);
+                i->then_block = stmt(i->then_block);
+                if (literal_node* c = asLiteral(i->condition)) {
+                    rewrites++;
+                    if (c->val.type == VAL_BOOL && c->val.b) return i->then_block;
+                    return nullptr;
+                }
+                return node;
+            }
+
+            case NODE_WHILE: {
+                while_node* w = static_cast<while_node*>(node);
+                w->condition = expr(w->condition);
+                w->body = stmt(w->body);
+                literal_node* c = asLiteral(w->condition);
+                if (c && !(c->val.type == VAL_BOOL && c->val.b)) {
+                    rewrites++;
+                    return nullptr;
+                }
+                return node;
+            }
+
+            case NODE_VAR_DECL: {
+                var_decl_node* d = static_cast<var_decl_node*>(node);
+                d->init_val = expr(d->init_val);
+                return node;
+            }
+
+            case NODE_RETURN: {
+                return_node* r = static_cast<return_node*>(node);
+                r->expr = expr(r->expr);
+                return node;
+            }
+
+            case NODE_PRINT: {
+                print_node* p = static_cast<print_node*>(node);
+                p->expr = expr(p->expr);
+                return node;
+            }
+
+            case NODE_FUNC_DEF:
+                block(static_cast<func_def_node*>(node)->body);
+                return node;
+
+            case NODE_CLASS_DEF:
+                for (auto& m : static_cast<class_def_node*>(node)->members) m = stmt(m);
+                return node;
+
+            case NODE_MAIN:
+                block(static_cast<main_node*>(node)->body);
+                return node;
+
+            default:
+                return expr(node);
+        }
+    }
+};
+
+}
+
+int foldConstants(program_node* program) {
+    if (!program) return 0;
+    Folder folder;
+    for (auto& g : program->globals) g = folder.stmt(g);
+    folder.stmt(program->main_block);
+    return folder.rewrites;
+}
@@ -0,0 +1,11 @@
+#ifndef FOLD_H
+#define FOLD_H
+
+#include "ast.h"
+
+//trecere pe AST inainte de executie: pliaza expresiile constante (2 * 3 -> 6),
+//elimina ramurile moarte (if (false), while (false)) si instructiunile de dupa un return.
+//Returneaza numarul de rescrieri facute. Nodurile noi se aloca in arena curenta.
+int foldConstants(program_node* program);
+
+#endif
@@ -7,123 +7,171 @@
 #include "types.h"
 #include "ast.h"
 #include "symbol_table.h"
+#include "compilation.h"
 
 using namespace std;
 
-extern int semantic_errors;
+inline bool isLValue(ast_node* node) {
+    return node && (node->kind == NODE_ID || node->kind == NODE_DOT || node->kind == NODE_INDEX);
+}
 
-extern int yylineno;
+inline TypeInfo cachedType(CompilationContext* ctx, ast_node* node);
 
-inline void yyerror(const char* s) {
-    std::cerr << "Error: " << s << " at line " << yylineno << std::endl;
-    semantic_errors++;
-}
-extern ScopeManager scopeManager;
+//calculeaza tipul static al unui nod din tipurile deja memorate ale copiilor (O(1) per nod)
+inline TypeInfo computeType(CompilationContext* ctx, ast_node* node) {
+    switch (node->kind) {
+        case NODE_LITERAL:
+            return node->static_type;
 
-inline bool isLValue(ast_node* node) {
-    if (dynamic_cast<id_node*>(node)) return true;
-    if (dynamic_cast<dot_node*>(node)) return true;
-    return false;
-}
+        case NODE_ID: {
+            id_node* id = static_cast<id_node*>(node);
+            SymbolInfo* sym = ctx->scopes.currentScope->lookup(id->name_id);
+            if (!sym) {
+                node->unresolved = id;
+                return TypeInfo(TYPE_UNKNOWN);
+            }
+            return sym->type;
+        }
 
-inline TypeInfo inferType(ast_node* node) {
-    if (!node) return TypeInfo(TYPE_UNKNOWN);
+        case NODE_ASSIGN: {
+            assign_node* asgn = static_cast<assign_node*>(node);
+            SymbolInfo* sym = ctx->scopes.currentScope->lookup(asgn->name_id);
+            if (!sym) return TypeInfo(TYPE_UNKNOWN);
+            return sym->type;
+        }
 
-    if (dynamic_cast<literal_node*>(node)) {
-        literal_node* lit = dynamic_cast<literal_node*>(node);
-        if (lit->val.find("\"") != string::npos) return TypeInfo(TYPE_STRING);
-        if (lit->val == "true" || lit->val == "false") return TypeInfo(TYPE_BOOL);
-        if (lit->val.find(".") != string::npos) return TypeInfo(TYPE_FLOAT);
-        return TypeInfo(TYPE_INT); 
-    }
+        case NODE_BINARY: {
+            binary_expr_node* bin = static_cast<binary_expr_node*>(node);
+            TypeInfo leftT = cachedType(ctx, bin->left);
+            TypeInfo rightT = cachedType(ctx, bin->right);
+            node->unresolved = bin->left && bin->left->unresolved ? bin->left->unresolved
+                             : bin->right ? bin->right->unresolved : nullptr;
+            if (isBoolResultOp(bin->op)) 
+                return TypeInfo(TYPE_BOOL);
+            //tablou op tablou / scalar: tipul tabloului (compatibilitatea o verifica parserul)
+            if (bin->operand == VAL_ARRAY) return leftT.type == TYPE_ARRAY ? leftT : rightT;
+
+            // Propagare eroare
+            if (leftT.type == TYPE_UNKNOWN || rightT.type == TYPE_UNKNOWN) return TypeInfo(TYPE_UNKNOWN);
+
+            if (leftT != rightT) return TypeInfo(TYPE_UNKNOWN);
+            return leftT; 
+        }
+
+        case NODE_CALL: {
+            call_node* call = static_cast<call_node*>(node);
+            SymbolInfo* sym = ctx->scopes.currentScope->lookup(call->func_id);
+            if (sym) return sym->type; 
+            return TypeInfo(TYPE_UNKNOWN);
+        }
 
-    if (dynamic_cast<id_node*>(node)) {
-        id_node* id = dynamic_cast<id_node*>(node);
-        SymbolInfo* sym = scopeManager.currentScope->lookup(id->name);
-        
-        if (!sym) { 
-            string err = "Semantic Error: Variable '" + id->name + "' undefined.";
-            yyerror(err.c_str()); 
+        case NODE_DOT: {
+            dot_node* dot = static_cast<dot_node*>(node);
+            if (dot->obj && dot->obj->kind == NODE_ID) {
+                id_node* idObj = static_cast<id_node*>(dot->obj);
+
+                SymbolInfo* symObj = ctx->scopes.currentScope->lookup(idObj->name_id);
+                
+                if (!symObj) {
+                    return TypeInfo(TYPE_UNKNOWN);
+                }
+
+                if (symObj->type.type == TYPE_CLASS) {
+                    SymbolInfo* memberSym = ctx->scopes.lookupInClass(symObj->type.className, dot->member_id);
+                    if (memberSym) return memberSym->type;
+                }
+                
+                if (ctx->scopes.isClass(idObj->name_id)) {
+                    SymbolInfo* memberSym = ctx->scopes.lookupInClass(idObj->name_id, dot->member_id);
+                    if (memberSym) return memberSym->type;
+                }
+            }
             return TypeInfo(TYPE_UNKNOWN); 
-        } 
-        return sym->type;
-    }
+        }
 
-    if (dynamic_cast<assign_node*>(node)) {
-        assign_node* asgn = dynamic_cast<assign_node*>(node);
-        SymbolInfo* sym = scopeManager.currentScope->lookup(asgn->name);
-        if (!sym) return TypeInfo(TYPE_UNKNOWN);
-        return sym->type;
-    }
+        case NODE_MEMBER_ASSIGN: {
+            member_assign_node* ma = static_cast<member_assign_node*>(node);
+            if (ma->val) node->unresolved = ma->val->unresolved;
+            return cachedType(ctx, ma->val);
+        }
 
-    if (dynamic_cast<binary_expr_node*>(node)) {
-        binary_expr_node* bin = dynamic_cast<binary_expr_node*>(node);
-        TypeInfo leftT = inferType(bin->left);
-        TypeInfo rightT = inferType(bin->right);
-        string op = bin->op;
-        
-        if (op == "==" || op == "!=" || op == "<" || op == ">" || op == "<=" || op == ">=" ||
-            op == "&&" || op == "||" || op == "!") 
-            return TypeInfo(TYPE_BOOL);
-        
-        // Propagare eroare
-        if (leftT.type == TYPE_UNKNOWN || rightT.type == TYPE_UNKNOWN) return TypeInfo(TYPE_UNKNOWN);
-
-        if (leftT != rightT) return TypeInfo(TYPE_UNKNOWN);
-        return leftT; 
-    }
-    
-    if (dynamic_cast<call_node*>(node)) {
-        call_node* call = dynamic_cast<call_node*>(node);
-        SymbolInfo* sym = scopeManager.currentScope->lookup(call->func_name);
-        if (sym) return sym->type; 
-        return TypeInfo(TYPE_UNKNOWN);
-    }
-    
-    if (dynamic_cast<dot_node*>(node)) {
-        dot_node* dot = dynamic_cast<dot_node*>(node);
-        if (dynamic_cast<id_node*>(dot->obj)) {
-            id_node* idObj = dynamic_cast<id_node*>(dot->obj);
-
-            SymbolInfo* symObj = scopeManager.currentScope->lookup(idObj->name);
-            
-            if (!symObj) {
-                return TypeInfo(TYPE_UNKNOWN);
-            }
+        case NODE_METHOD_CALL: {
+            method_call_node* mc = static_cast<method_call_node*>(node);
+            if (mc->obj && mc->obj->kind == NODE_ID) {
+                id_node* idObj = static_cast<id_node*>(mc->obj);
+                SymbolInfo* symObj = ctx->scopes.currentScope->lookup(idObj->name_id);
+                if (!symObj || symObj->type.type != TYPE_CLASS) return TypeInfo(TYPE_UNKNOWN);
 
-            if (symObj->type.type == TYPE_CLASS) {
-                SymbolInfo* memberSym = scopeManager.lookupInClass(symObj->type.className, dot->member);
-                if (memberSym) return memberSym->type;
-            }
-            
-            if (scopeManager.classScopes.count(idObj->name)) {
-                SymbolInfo* memberSym = scopeManager.lookupInClass(idObj->name, dot->member);
-                if (memberSym) return memberSym->type;
+                SymbolInfo* m = ctx->scopes.lookupInClass(symObj->type.className, mc->method_id);
+                if (!m || m->category != "function") return TypeInfo(TYPE_UNKNOWN);
+
+                return m->type; 
             }
+            return TypeInfo(TYPE_UNKNOWN);
         }
-        return TypeInfo(TYPE_UNKNOWN); 
-    }
-    
-    if (dynamic_cast<member_assign_node*>(node)) {
-        member_assign_node* ma = dynamic_cast<member_assign_node*>(node);
-        return inferType(ma->val);
-    }
 
-    if (dynamic_cast<method_call_node*>(node)) {
-        auto* mc = dynamic_cast<method_call_node*>(node);
-        if (auto* idObj = dynamic_cast<id_node*>(mc->obj)) {
-            SymbolInfo* symObj = scopeManager.currentScope->lookup(idObj->name);
-            if (!symObj || symObj->type.type != TYPE_CLASS) return TypeInfo(TYPE_UNKNOWN);
+        case NODE_ARRAY_NEW:
+            return TypeInfo::arrayOf(static_cast<array_new_node*>(node)->element);
+
+        case NODE_ARRAY_LITERAL:
+            return TypeInfo::arrayOf(static_cast<array_literal_node*>(node)->element);
 
-            SymbolInfo* m = scopeManager.lookupInClass(symObj->type.className, mc->method);
-            if (!m || m->category != "function") return TypeInfo(TYPE_UNKNOWN);
+        case NODE_INDEX: {
+            index_node* ix = static_cast<index_node*>(node);
+            TypeInfo t = cachedType(ctx, ix->arr);
+            cachedType(ctx, ix->index);
+            node->unresolved = ix->arr->unresolved ? ix->arr->unresolved : ix->index->unresolved;
+            if (t.type != TYPE_ARRAY) return TypeInfo(TYPE_UNKNOWN);
+            return TypeInfo(t.element);
+        }
+
+        case NODE_INDEX_ASSIGN: {
+            index_assign_node* ia = static_cast<index_assign_node*>(node);
+            if (ia->val) node->unresolved = ia->val->unresolved;
+            return cachedType(ctx, ia->val);
+        }
 
-            return m->type; 
+        //length e int; celelalte au tipul elementelor unui int[] / float[]
+        case NODE_ARRAY_CALL: {
+            array_call_node* ac = static_cast<array_call_node*>(node);
+            TypeInfo t = cachedType(ctx, ac->arr);
+            node->unresolved = ac->arr->unresolved;
+            if (t.type != TYPE_ARRAY) return TypeInfo(TYPE_UNKNOWN);
+            if (ac->fn == ARRAY_LENGTH) return TypeInfo(TYPE_INT);
+            if (t.element != TYPE_INT && t.element != TYPE_FLOAT) return TypeInfo(TYPE_UNKNOWN);
+            return TypeInfo(t.element);
         }
-        return TypeInfo(TYPE_UNKNOWN);
+
+        default:
+            return TypeInfo(TYPE_UNKNOWN);
     }
+}
+
+//memoreaza tipul in nod; parserul il apeleaza pe fiecare expresie imediat dupa constructie
+template <typename Node>
+inline Node* annotateType(CompilationContext* ctx, Node* node) {
+    if (node && !node->typed) node->setType(computeType(ctx, node));
+    return node;
+}
+
+inline TypeInfo cachedType(CompilationContext* ctx, ast_node* node) {
+    if (!node) return TypeInfo(TYPE_UNKNOWN);
+    annotateType(ctx, node);
+    return node->static_type;
+}
 
-    return TypeInfo(TYPE_UNKNOWN);
+//report = false: doar interogheaza tipul, fara sa raporteze variabile nedeclarate
+inline TypeInfo inferType(CompilationContext* ctx, ast_node* node, bool report = true) {
+    STAT_INC(inferTypeCalls);
+    if (!node) return TypeInfo(TYPE_UNKNOWN);
+    annotateType(ctx, node);
+
+    if (report && node->unresolved && !node->unresolved->reported) {
+        node->unresolved->reported = true;
+        string err = "Semantic Error: Variable '" + node->unresolved->name + "' undefined.";
+        ctx->error(err);
+    }
+    return node->static_type;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,106 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+//un identificator internat: id dens (0, 1, 2, ...) + textul lui, stabil in memorie
+struct InternedName {
+    int id;
+    uint32_t hash;
+    std::string text;
+};
+
+//tabela globala de identificatori, alimentata de lexer. Fiecare nume distinct primeste un id dens,
+//folosit apoi drept cheie in tabelele de simboluri (adresare deschisa, fara comparatii de siruri).
+class Interner {
+    std::deque<InternedName> names; //deque: adresele raman valide la inserare
+    std::vector<InternedName*> table; //adresare deschisa, sondare liniara; dimensiune putere a lui 2
+    mutable std::shared_mutex mutex; //internerul e global si e folosit din mai multe compilari in paralel
+
+    static uint32_t hashOf(const char* s, size_t n) {
+        uint32_t h = 2166136261u; //FNV-1a
+        for (size_t i = 0; i < n; i++) {
+            h ^= (unsigned char)s[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    size_t probe(const char* s, size_t n, uint32_t h) const {
+        size_t mask = table.size() - 1;
+        size_t i = h & mask;
+        while (table[i]) {
+            const InternedName* e = table[i];
+            if (e->hash == h && e->text.size() == n && std::memcmp(e->text.data(), s, n) == 0) break;
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        std::vector<InternedName*> old(table.size() * 2, nullptr);
+        old.swap(table);
+        size_t mask = table.size() - 1;
+        for (InternedName* e : old) {
+            if (!e) continue;
+            size_t i = e->hash & mask;
+            while (table[i]) i = (i + 1) & mask;
+            table[i] = e;
+        }
+    }
+
+public:
+    Interner() : table(256, nullptr) {}
+
+    const InternedName* intern(const char* s, size_t n) {
+        uint32_t h = hashOf(s, n);
+        {
+            //cazul des intalnit: numele exista deja, ajunge blocarea partajata
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            size_t i = probe(s, n, h);
+            if (table[i]) return table[i];
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        size_t i = probe(s, n, h); //alt thread poate sa-l fi inserat intre timp
+        if (table[i]) return table[i];
+
+        names.push_back({ (int)names.size(), h, std::string(s, n) });
+        InternedName* e = &names.back();
+        table[i] = e;
+        if (names.size() * 2 > table.size()) grow();
+        return e;
+    }
+
+    const InternedName* intern(const std::string& s) { return intern(s.data(), s.size()); }
+
+    //id-ul unui nume deja internat, sau -1 (nu insereaza)
+    int find(const std::string& s) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        size_t i = probe(s.data(), s.size(), hashOf(s.data(), s.size()));
+        return table[i] ? table[i]->id : -1;
+    }
+
+    const std::string& name(int id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return names[id].text;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return names.size();
+    }
+
+    static Interner& global() {
+        static Interner instance;
+        return instance;
+    }
+};
+
+#endif
@@ -0,0 +1,1184 @@
+#include "ir.h"
+#include <algorithm>
+
+namespace {
+
+//&& / || cu atribuiri, apeluri sau operatii pe tablouri (pot opri programul) in dreapta au nevoie de ramificare;
+//altfel dreapta e pura si devine IR_LOGIC
+bool hasEffects(ast_node* node) {
+    if (!node) return false;
+    switch (node->kind) {
+        case NODE_ASSIGN:
+        case NODE_MEMBER_ASSIGN:
+        case NODE_CALL:
+        case NODE_METHOD_CALL:
+        case NODE_ARRAY_NEW:
+        case NODE_ARRAY_LITERAL:
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGN:
+        case NODE_ARRAY_CALL:
+            return true;
+        case NODE_BINARY: {
+            binary_expr_node* bin = static_cast<binary_expr_node*>(node);
+            return bin->operand == VAL_ARRAY || hasEffects(bin->left) || hasEffects(bin->right);
+        }
+        default:
+            return false;
+    }
+}
+
+//sloturile globale (depth 0) pe care le atinge un corp de functie sau initializarea unui camp
+void collectGlobals(ast_node* node, std::vector<bool>& used) {
+    if (!node) return;
+    auto mark = [&](int depth, int slot) {
+        if (depth == 0 && slot >= 0 && slot < (int)used.size()) used[slot] = true;
+    };
+    switch (node->kind) {
+        case NODE_BLOCK:
+            for (auto s : static_cast<block_node*>(node)->statements) collectGlobals(s, used);
+            return;
+        case NODE_VAR_DECL:
+            collectGlobals(static_cast<var_decl_node*>(node)->init_val, used);
+            return;
+        case NODE_IF:
+            collectGlobals(static_cast<if_node*>(node)->condition, used);
+            collectGlobals(static_cast<if_node*>(node)->then_block, used);
+            return;
+        case NODE_WHILE:
+            collectGlobals(static_cast<while_node*>(node)->condition, used);
+            collectGlobals(static_cast<while_node*>(node)->body, used);
+            return;
+        case NODE_RETURN:
+            collectGlobals(static_cast<return_node*>(node)->expr, used);
+            return;
+        case NODE_PRINT:
+            collectGlobals(static_cast<print_node*>(node)->expr, used);
+            return;
+        case NODE_ID:
+            mark(static_cast<id_node*>(node)->depth, static_cast<id_node*>(node)->slot);
+            return;
+        case NODE_ASSIGN: {
+            assign_node* a = static_cast<assign_node*>(node);
+            mark(a->depth, a->slot);
+            collectGlobals(a->val, used);
+            return;
+        }
+        case NODE_MEMBER_ASSIGN:
+            collectGlobals(static_cast<member_assign_node*>(node)->obj, used);
+            collectGlobals(static_cast<member_assign_node*>(node)->val, used);
+            return;
+        case NODE_DOT:
+            collectGlobals(static_cast<dot_node*>(node)->obj, used);
+            return;
+        case NODE_BINARY:
+            collectGlobals(static_cast<binary_expr_node*>(node)->left, used);
+            collectGlobals(static_cast<binary_expr_node*>(node)->right, used);
+            return;
+        case NODE_CALL:
+            for (auto a : static_cast<call_node*>(node)->args) collectGlobals(a, used);
+            return;
+        case NODE_METHOD_CALL:
+            collectGlobals(static_cast<method_call_node*>(node)->obj, used);
+            for (auto a : static_cast<method_call_node*>(node)->args) collectGlobals(a, used);
+            return;
+        case NODE_ARRAY_NEW:
+            collectGlobals(static_cast<array_new_node*>(node)->size, used);
+            return;
+        case NODE_ARRAY_LITERAL:
+            for (auto i : static_cast<array_literal_node*>(node)->items) collectGlobals(i, used);
+            return;
+        case NODE_INDEX:
+            collectGlobals(static_cast<index_node*>(node)->arr, used);
+            collectGlobals(static_cast<index_node*>(node)->index, used);
+            return;
+        case NODE_INDEX_ASSIGN:
+            collectGlobals(static_cast<index_assign_node*>(node)->arr, used);
+            collectGlobals(static_cast<index_assign_node*>(node)->index, used);
+            collectGlobals(static_cast<index_assign_node*>(node)->val, used);
+            return;
+        case NODE_ARRAY_CALL:
+            collectGlobals(static_cast<array_call_node*>(node)->arr, used);
+            collectGlobals(static_cast<array_call_node*>(node)->arg, used);
+            return;
+        default:
+            return;
+    }
+}
+
+//declaratiile si atribuirile localelor lui main (depth 1)
+void collectStores(ast_node* node, std::vector<ast_node*>& stores) {
+    if (!node) return;
+    switch (node->kind) {
+        case NODE_BLOCK:
+            for (auto s : static_cast<block_node*>(node)->statements) collectStores(s, stores);
+            return;
+        case NODE_VAR_DECL:
+            if (static_cast<var_decl_node*>(node)->depth == 1) stores.push_back(node);
+            collectStores(static_cast<var_decl_node*>(node)->init_val, stores);
+            return;
+        case NODE_IF:
+            collectStores(static_cast<if_node*>(node)->condition, stores);
+            collectStores(static_cast<if_node*>(node)->then_block, stores);
+            return;
+        case NODE_WHILE:
+            collectStores(static_cast<while_node*>(node)->condition, stores);
+            collectStores(static_cast<while_node*>(node)->body, stores);
+            return;
+        case NODE_RETURN:
+            collectStores(static_cast<return_node*>(node)->expr, stores);
+            return;
+        case NODE_PRINT:
+            collectStores(static_cast<print_node*>(node)->expr, stores);
+            return;
+        case NODE_ASSIGN:
+            if (static_cast<assign_node*>(node)->depth == 1) stores.push_back(node);
+            collectStores(static_cast<assign_node*>(node)->val, stores);
+            return;
+        case NODE_MEMBER_ASSIGN:
+            collectStores(static_cast<member_assign_node*>(node)->obj, stores);
+            collectStores(static_cast<member_assign_node*>(node)->val, stores);
+            return;
+        case NODE_DOT:
+            collectStores(static_cast<dot_node*>(node)->obj, stores);
+            return;
+        case NODE_BINARY:
+            collectStores(static_cast<binary_expr_node*>(node)->left, stores);
+            collectStores(static_cast<binary_expr_node*>(node)->right, stores);
+            return;
+        case NODE_CALL:
+            for (auto a : static_cast<call_node*>(node)->args) collectStores(a, stores);
+            return;
+        case NODE_METHOD_CALL:
+            collectStores(static_cast<method_call_node*>(node)->obj, stores);
+            for (auto a : static_cast<method_call_node*>(node)->args) collectStores(a, stores);
+            return;
+        case NODE_ARRAY_NEW:
+            collectStores(static_cast<array_new_node*>(node)->size, stores);
+            return;
+        case NODE_ARRAY_LITERAL:
+            for (auto i : static_cast<array_literal_node*>(node)->items) collectStores(i, stores);
+            return;
+        case NODE_INDEX:
+            collectStores(static_cast<index_node*>(node)->arr, stores);
+            collectStores(static_cast<index_node*>(node)->index, stores);
+            return;
+        case NODE_INDEX_ASSIGN:
+            collectStores(static_cast<index_assign_node*>(node)->arr, stores);
+            collectStores(static_cast<index_assign_node*>(node)->index, stores);
+            collectStores(static_cast<index_assign_node*>(node)->val, stores);
+            return;
+        case NODE_ARRAY_CALL:
+            collectStores(static_cast<array_call_node*>(node)->arr, stores);
+            collectStores(static_cast<array_call_node*>(node)->arg, stores);
+            return;
+        default:
+            return;
+    }
+}
+
+}
+
+std::vector<int> IrFunction::successors(int block) const {
+    const IrBlock& b = blocks[block];
+    if (b.insts.empty()) return {};
+    const IrInst& last = insts[b.insts.back()];
+    if (last.op == IR_JUMP) return { last.targets[0] };
+    if (last.op == IR_BRANCH) return { last.targets[0], last.targets[1] };
+    return {};
+}
+
+void IrFunction::compact() {
+    for (auto& inst : insts) {
+        if (inst.removed) continue;
+        for (auto& a : inst.args) a = resolve(a);
+    }
+    for (auto& b : blocks) {
+        b.insts.erase(std::remove_if(b.insts.begin(), b.insts.end(), [&](int i) { return insts[i].removed; }), b.insts.end());
+    }
+}
+
+void IrFunction::dump(std::ostream& out) const {
+    for (size_t b = 0; b < blocks.size(); b++) {
+        if (blocks[b].removed) continue;
+        out << "b" << b << ":";
+        if (!blocks[b].preds.empty()) {
+            out << "  ; preds";
+            for (int p : blocks[b].preds) out << " b" << p;
+        }
+        for (const auto& loop : loops)
+            if (loop.header == (int)b) out << "  ; loop b" << loop.header << "..b" << loop.last;
+        out << "\n";
+
+        for (int id : blocks[b].insts) {
+            const IrInst& in = insts[id];
+            out << "    ";
+            if (!in.isTerminator() && in.op != IR_PRINT && in.op != IR_STORE_GLOBAL && in.op != IR_SET_FIELD)
+                out << "v" << id << " = ";
+            switch (in.op) {
+                case IR_CONST:
+                    out << "const ";
+                    if (in.constant.type == VAL_STRING) out << "\"" << in.constant.s() << "\"";
+                    else out << in.constant.toString();
+                    break;
+                case IR_PHI:
+                    out << "phi";
+                    for (size_t k = 0; k < in.args.size(); k++)
+                        out << (k ? ", " : " ") << "v" << in.args[k] << " [b" << blocks[b].preds[k] << "]";
+                    break;
+                case IR_COPY: out << "copy v" << in.args[0]; break;
+                case IR_OP:
+                case IR_LOGIC:
+                    out << (in.op == IR_LOGIC ? (in.code == OP_AND_JUMP ? "AND" : "OR") : opName(in.code));
+                    for (size_t k = 0; k < in.args.size(); k++) out << (k ? ", v" : " v") << in.args[k];
+                    break;
+                case IR_PRINT: out << "print v" << in.args[0]; break;
+                case IR_CALL:
+                    out << (in.code == OP_NEW ? "new " : in.code == OP_CALL_METHOD ? "call_method " : "call ") << in.index;
+                    for (int a : in.args) out << ", v" << a;
+                    break;
+                case IR_LOAD_GLOBAL: out << "load_global " << in.index; break;
+                case IR_STORE_GLOBAL: out << "store_global " << in.index << ", v" << in.args[0]; break;
+                case IR_GET_FIELD: out << "get_field v" << in.args[0] << ", " << in.index; break;
+                case IR_SET_FIELD: out << "set_field v" << in.args[0] << ", " << in.index << ", v" << in.args[1]; break;
+                case IR_ARRAY:
+                    out << opName(in.code);
+                    if (in.code == OP_ARRAY_REDUCE) out << " " << arrayFnName((ArrayFn)in.index);
+                    else if (in.index >= 0) out << " " << in.index;
+                    for (size_t k = 0; k < in.args.size(); k++) out << (k || in.index >= 0 ? ", v" : " v") << in.args[k];
+                    break;
+                case IR_JUMP: out << "jump b" << in.targets[0]; break;
+                case IR_BRANCH: out << "br v" << in.args[0] << ", b" << in.targets[0] << ", b" << in.targets[1]; break;
+                case IR_HALT: out << "halt"; break;
+            }
+            if (!in.var.empty()) out << "  ; " << in.var;
+            out << "\n";
+        }
+    }
+}
+
+int IrBuilder::newBlock() {
+    fn->blocks.emplace_back();
+    sealed.push_back(false);
+    return (int)fn->blocks.size() - 1;
+}
+
+int IrBuilder::add(IrInst inst) {
+    int id = (int)fn->insts.size();
+    inst.block = current;
+    fn->insts.push_back(std::move(inst));
+    fn->forward.push_back(id);
+    fn->blocks[current].insts.push_back(id);
+    return id;
+}
+
+int IrBuilder::constant(const Value& v) {
+    IrInst inst(IR_CONST);
+    inst.constant = v;
+    return add(std::move(inst));
+}
+
+int IrBuilder::op(OpCode code, int a, int b) {
+    IrInst inst(IR_OP);
+    inst.code = code;
+    inst.args.push_back(a);
+    if (b >= 0) inst.args.push_back(b);
+    return add(std::move(inst));
+}
+
+void IrBuilder::link(int inst, int which, int target) {
+    fn->insts[inst].targets[which] = target;
+    fn->blocks[target].preds.push_back(fn->insts[inst].block);
+}
+
+int IrBuilder::array(OpCode code, int arg, std::vector<int> args) {
+    IrInst inst(IR_ARRAY);
+    inst.code = code;
+    inst.index = arg;
+    inst.args = std::move(args);
+    return add(std::move(inst));
+}
+
+int IrBuilder::jump() {
+    return add(IrInst(IR_JUMP));
+}
+
+int IrBuilder::branch(int cond) {
+    IrInst inst(IR_BRANCH);
+    inst.args.push_back(cond);
+    return add(std::move(inst));
+}
+
+//phi-urile stau la inceputul blocului, in ordinea crearii
+int IrBuilder::addPhi(int block, const std::string& var) {
+    int id = (int)fn->insts.size();
+    IrInst inst(IR_PHI);
+    inst.block = block;
+    inst.var = var;
+    fn->insts.push_back(std::move(inst));
+    fn->forward.push_back(id);
+    auto& list = fn->blocks[block].insts;
+    auto at = list.begin();
+    while (at != list.end() && fn->insts[*at].op == IR_PHI) ++at;
+    list.insert(at, id);
+    return id;
+}
+
+void IrBuilder::seal(int block) {
+    auto it = incompletePhis.find(block);
+    if (it != incompletePhis.end()) {
+        for (auto& entry : it->second) addPhiOperands(entry.first, entry.second);
+        incompletePhis.erase(it);
+    }
+    sealed[block] = true;
+}
+
+void IrBuilder::writeVariable(long var, int block, int value) {
+    currentDef[var][block] = value;
+}
+
+int IrBuilder::readVariable(long var, int block) {
+    auto& defs = currentDef[var];
+    auto it = defs.find(block);
+    if (it != defs.end()) return it->second;
+
+    int value;
+    const std::vector<int>& preds = fn->blocks[block].preds;
+    if (!sealed[block]) {
+        //predecesorii nu sunt inca toti cunoscuti (antetul unei bucle): operanzii se completeaza la sigilare
+        value = addPhi(block, names[var]);
+        incompletePhis[block][var] = value;
+    }
+    else if (preds.size() == 1) {
+        value = readVariable(var, preds[0]);
+    }
+    else if (preds.empty()) {
+        //citire inainte de orice atribuire (sau bloc de dupa return): slotul ar fi void.
+        //Constanta sta la inceputul blocului de intrare, care domina tot
+        value = (int)fn->insts.size();
+        IrInst inst(IR_CONST);
+        inst.block = 0;
+        fn->insts.push_back(std::move(inst));
+        fn->forward.push_back(value);
+        fn->blocks[0].insts.insert(fn->blocks[0].insts.begin(), value);
+    }
+    else {
+        value = addPhi(block, names[var]);
+        writeVariable(var, block, value);
+        value = addPhiOperands(var, value);
+    }
+    writeVariable(var, block, value);
+    return value;
+}
+
+int IrBuilder::addPhiOperands(long var, int phi) {
+    int block = fn->insts[phi].block;
+    std::vector<int> preds = fn->blocks[block].preds;
+    for (int p : preds) {
+        int v = readVariable(var, p);
+        fn->insts[phi].args.push_back(v);
+    }
+    return phi;
+}
+
+//(depth, slot) vazut din corpul curent: in main e variabila SSA ca atare; intr-un corp inliniat cadrul functiei
+//e variabila apelului, iar depth 1 al unei metode e campul obiectului
+int IrBuilder::load(int depth, int slot, const std::string& name) {
+    if (slot < 0) return constant(Value());
+    if (depth != 0 && !inlined.empty()) {
+        const Inlined& in = inlined.back();
+        if (in.f->owner && depth == 1) {
+            IrInst inst(IR_GET_FIELD);
+            inst.index = slot;
+            inst.args = { in.receiver };
+            inst.var = name;
+            return add(std::move(inst));
+        }
+        depth = in.frame;
+    }
+    long var = key(depth, slot);
+    if (!names.count(var)) names[var] = name;
+    return readVariable(var, current);
+}
+
+int IrBuilder::store(int depth, int slot, const std::string& name, int value) {
+    if (slot < 0) return value;
+    if (depth != 0 && !inlined.empty()) {
+        const Inlined& in = inlined.back();
+        if (in.f->owner && depth == 1) {
+            IrInst inst(IR_SET_FIELD);
+            inst.index = slot;
+            inst.args = { in.receiver, value };
+            inst.var = name;
+            add(std::move(inst));
+            return value;
+        }
+        depth = in.frame;
+    }
+    return assign(depth, slot, name, value);
+}
+
+//atribuirea pastreaza o copie cu numele variabilei; propagarea copiilor o elimina
+int IrBuilder::assign(int depth, int slot, const std::string& name, int value) {
+    if (slot < 0) return value;
+    long var = key(depth, slot);
+    names[var] = name;
+    IrInst inst(IR_COPY);
+    inst.args.push_back(value);
+    inst.var = name;
+    int copy = add(std::move(inst));
+    writeVariable(var, current, copy);
+    return copy;
+}
+
+void IrBuilder::stmt(ast_node* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case NODE_BLOCK:
+            for (auto s : static_cast<block_node*>(node)->statements) stmt(s);
+            return;
+
+        case NODE_MAIN:
+            stmt(static_cast<main_node*>(node)->body);
+            return;
+
+        case NODE_VAR_DECL: {
+            var_decl_node* d = static_cast<var_decl_node*>(node);
+            int cls = d->init_val ? -1 : table.findClass(d->class_id);
+            int v;
+            if (d->init_val) v = expr(d->init_val);
+            else if (cls < 0) v = constant(defaultValue(d->type));
+            else {
+                IrInst inst(IR_CALL);
+                inst.code = OP_NEW;
+                inst.index = cls;
+                inst.var = table.classAt(cls)->name;
+                //campurile constante nu ruleaza cod: globalele nu trebuie sincronizate
+                v = table.classAt(cls)->hasConstantFields() ? add(std::move(inst)) : effect(std::move(inst));
+            }
+            store(d->depth, d->slot, d->name, v);
+            return;
+        }
+
+        //functiile si clasele nu se executa la definire
+        case NODE_FUNC_DEF:
+        case NODE_CLASS_DEF:
+            return;
+
+        //cond -> then | else (gol) -> join; blocul else evita muchiile critice
+        case NODE_IF: {
+            if_node* i = static_cast<if_node*>(node);
+            int br = branch(expr(i->condition));
+
+            int then = newBlock();
+            link(br, 0, then);
+            seal(then);
+            current = then;
+            stmt(i->then_block);
+            int thenJump = jump();
+
+            int otherwise = newBlock();
+            link(br, 1, otherwise);
+            seal(otherwise);
+            current = otherwise;
+            int elseJump = jump();
+
+            int join = newBlock();
+            link(thenJump, 0, join);
+            link(elseJump, 0, join);
+            seal(join);
+            current = join;
+            return;
+        }
+
+        //preheader -> header (cond) -> body ... -> header | exit; headerul se sigileaza dupa corp
+        case NODE_WHILE: {
+            while_node* w = static_cast<while_node*>(node);
+            int preheader = current;
+            int header = newBlock();
+            link(jump(), 0, header);
+            current = header;
+            int br = branch(expr(w->condition));
+
+            int body = newBlock();
+            link(br, 0, body);
+            seal(body);
+            current = body;
+            stmt(w->body);
+            link(jump(), 0, header);
+            int last = (int)fn->blocks.size() - 1;
+            seal(header);
+
+            int exit = newBlock();
+            link(br, 1, exit);
+            seal(exit);
+            current = exit;
+            fn->loops.push_back({ preheader, header, last });
+            return;
+        }
+
+        //in main, return opreste programul; ce urmeaza e inaccesibil
+        case NODE_RETURN: {
+            return_node* r = static_cast<return_node*>(node);
+            if (r->expr) expr(r->expr);
+            add(IrInst(IR_HALT));
+            current = newBlock();
+            seal(current);
+            return;
+        }
+
+        case NODE_PRINT: {
+            IrInst inst(IR_PRINT);
+            inst.args.push_back(expr(static_cast<print_node*>(node)->expr));
+            add(std::move(inst));
+            return;
+        }
+
+        default:
+            expr(node);
+            return;
+    }
+}
+
+int IrBuilder::expr(ast_node* node) {
+    if (!node) return constant(Value());
+
+    switch (node->kind) {
+        case NODE_LITERAL:
+            return constant(static_cast<literal_node*>(node)->val);
+
+        case NODE_ID: {
+            id_node* id = static_cast<id_node*>(node);
+            return load(id->depth, id->slot, id->name);
+        }
+
+        case NODE_ASSIGN: {
+            assign_node* a = static_cast<assign_node*>(node);
+            return store(a->depth, a->slot, a->name, expr(a->val));
+        }
+
+        case NODE_MEMBER_ASSIGN: {
+            member_assign_node* m = static_cast<member_assign_node*>(node);
+            int o = expr(m->obj);
+            int v = expr(m->val);
+            if (m->slot < 0) return v;
+            IrInst inst(IR_SET_FIELD);
+            inst.index = m->slot;
+            inst.args = { o, v };
+            inst.var = m->member;
+            add(std::move(inst));
+            return v;
+        }
+
+        case NODE_DOT: {
+            dot_node* d = static_cast<dot_node*>(node);
+            int o = expr(d->obj);
+            if (d->slot < 0) return constant(Value());
+            IrInst inst(IR_GET_FIELD);
+            inst.index = d->slot;
+            inst.args = { o };
+            inst.var = d->member;
+            return add(std::move(inst));
+        }
+
+        case NODE_BINARY:
+            return binary(static_cast<binary_expr_node*>(node));
+
+        case NODE_CALL: {
+            call_node* c = static_cast<call_node*>(node);
+            return call(table.find(c->class_id, c->func_id), OP_CALL, nullptr, c->args);
+        }
+
+        case NODE_METHOD_CALL: {
+            method_call_node* m = static_cast<method_call_node*>(node);
+            return call(m->class_id < 0 ? -1 : table.find(m->class_id, m->method_id), OP_CALL_METHOD, m->obj, m->args);
+        }
+
+        //aceleasi opcoduri ca BytecodeCompiler::compileExpr; doar lungimea e un calcul pur
+        case NODE_ARRAY_NEW: {
+            array_new_node* a = static_cast<array_new_node*>(node);
+            return array(OP_NEW_ARRAY, elementValueType(a->element), { expr(a->size) });
+        }
+
+        case NODE_ARRAY_LITERAL: {
+            array_literal_node* a = static_cast<array_literal_node*>(node);
+            std::vector<int> items;
+            for (auto i : a->items) items.push_back(expr(i));
+            return array(OP_ARRAY_LITERAL, (int)a->items.size() << 2 | elementValueType(a->element), std::move(items));
+        }
+
+        case NODE_INDEX: {
+            index_node* ix = static_cast<index_node*>(node);
+            int a = expr(ix->arr);
+            return array(OP_INDEX, -1, { a, expr(ix->index) });
+        }
+
+        case NODE_INDEX_ASSIGN: {
+            index_assign_node* ia = static_cast<index_assign_node*>(node);
+            int a = expr(ia->arr);
+            int i = expr(ia->index);
+            return array(OP_SET_INDEX, -1, { a, i, expr(ia->val) });
+        }
+
+        case NODE_ARRAY_CALL: {
+            array_call_node* ac = static_cast<array_call_node*>(node);
+            int a = expr(ac->arr);
+            if (ac->fn == ARRAY_LENGTH) return op(OP_ARRAY_LEN, a);
+            std::vector<int> args = { a };
+            if (ac->fn == ARRAY_DOT) args.push_back(expr(ac->arg));
+            return array(OP_ARRAY_REDUCE, ac->fn, std::move(args));
+        }
+
+        default:
+            return constant(Value());
+    }
+}
+
+//argumentele se ajusteaza ca in BytecodeCompiler::compileCall; obiectul metodei e primul.
+//O metoda se inliniaza doar pe un obiect sigur (pe void nu s-ar executa); apelata fara obiect din corpul
+//inliniat al altei metode, primeste obiectul acesteia
+int IrBuilder::call(int function, OpCode code, ast_node* receiver, const node_list& args) {
+    if (function < 0) return constant(Value());
+    func_def_node* f = table.at(function);
+    int self = receiver ? expr(receiver) : -1;
+    if (!receiver && f->owner && !inlined.empty()) self = inlined.back().receiver;
+    if (inlineSize > 0 && cost(function) >= 0 && (!f->owner || (self >= 0 && (!receiver || isObject(receiver, self)))))
+        return inlineCall(function, self, args);
+
+    IrInst inst(IR_CALL);
+    inst.code = code;
+    inst.index = function;
+    inst.var = f->name;
+    if (receiver) inst.args.push_back(self);
+    size_t params = f->param_names.size();
+    for (size_t i = 0; i < args.size(); i++) {
+        int v = expr(args[i]);
+        if (i < params) inst.args.push_back(v);
+    }
+    for (size_t i = args.size(); i < params; i++) inst.args.push_back(constant(Value()));
+    return effect(std::move(inst));
+}
+
+//noduri executate de o instructiune din corpul unei functii inliniate; -1 pentru ramificari, bucle
+//si apeluri care nu se pot inlinia
+int IrBuilder::cost(ast_node* node) {
+    if (!node) return 0;
+    int total = 1;
+    auto add = [&](ast_node* child) {
+        int c = cost(child);
+        total = total < 0 || c < 0 ? -1 : total + c;
+    };
+    switch (node->kind) {
+        case NODE_LITERAL:
+        case NODE_ID:
+            break;
+        case NODE_VAR_DECL: add(static_cast<var_decl_node*>(node)->init_val); break;
+        case NODE_PRINT: add(static_cast<print_node*>(node)->expr); break;
+        case NODE_RETURN: add(static_cast<return_node*>(node)->expr); break;
+        case NODE_ASSIGN: add(static_cast<assign_node*>(node)->val); break;
+        case NODE_DOT: add(static_cast<dot_node*>(node)->obj); break;
+        case NODE_MEMBER_ASSIGN:
+            add(static_cast<member_assign_node*>(node)->obj);
+            add(static_cast<member_assign_node*>(node)->val);
+            break;
+        case NODE_BINARY:
+            add(static_cast<binary_expr_node*>(node)->left);
+            add(static_cast<binary_expr_node*>(node)->right);
+            break;
+        case NODE_ARRAY_NEW: add(static_cast<array_new_node*>(node)->size); break;
+        case NODE_ARRAY_LITERAL:
+            for (auto i : static_cast<array_literal_node*>(node)->items) add(i);
+            break;
+        case NODE_INDEX:
+            add(static_cast<index_node*>(node)->arr);
+            add(static_cast<index_node*>(node)->index);
+            break;
+        case NODE_INDEX_ASSIGN:
+            add(static_cast<index_assign_node*>(node)->arr);
+            add(static_cast<index_assign_node*>(node)->index);
+            add(static_cast<index_assign_node*>(node)->val);
+            break;
+        case NODE_ARRAY_CALL:
+            add(static_cast<array_call_node*>(node)->arr);
+            add(static_cast<array_call_node*>(node)->arg);
+            break;
+        //un apel fara tinta e void, fara argumente evaluate
+        case NODE_CALL: {
+            call_node* c = static_cast<call_node*>(node);
+            int f = table.find(c->class_id, c->func_id);
+            if (f < 0) break;
+            int body = cost(f);
+            if (body < 0) return -1;
+            total += body;
+            for (auto a : c->args) add(a);
+            break;
+        }
+        case NODE_METHOD_CALL: {
+            method_call_node* m = static_cast<method_call_node*>(node);
+            int f = m->class_id < 0 ? -1 : table.find(m->class_id, m->method_id);
+            if (f < 0) break;
+            int body = cost(f);
+            if (body < 0) return -1;
+            total += body;
+            add(m->obj);
+            for (auto a : m->args) add(a);
+            break;
+        }
+        default:
+            return -1;
+    }
+    return total;
+}
+
+//corpul functiei pana la primul return, cu apelurile lui inliniate; -1 daca e recursiva (apelul ajunge la o
+//functie inca in calcul) sau depaseste pragul
+int IrBuilder::cost(int function) {
+    if (costs[function] != -2) return costs[function];
+    costs[function] = -1;
+    int total = 0;
+    for (auto s : table.at(function)->body->statements) {
+        int c = cost(s);
+        if (c < 0) {
+            total = -1;
+            break;
+        }
+        total += c;
+        if (s && s->kind == NODE_RETURN) break;
+    }
+    costs[function] = total > inlineSize ? -1 : total;
+    return costs[function];
+}
+
+//obiectul unei metode nu poate fi void: o locala din objectSlots sau o valoare creata de new
+bool IrBuilder::isObject(ast_node* receiver, int value) const {
+    if (inlined.empty() && receiver->kind == NODE_ID) {
+        id_node* id = static_cast<id_node*>(receiver);
+        if (id->depth == 1 && id->slot >= 0 && id->slot < (int)objectSlots.size() && objectSlots[id->slot]) return true;
+    }
+    for (int v = fn->resolve(value);; v = fn->resolve(fn->insts[v].args[0])) {
+        const IrInst& in = fn->insts[v];
+        if (in.op == IR_CALL) return in.code == OP_NEW;
+        if (in.op != IR_COPY) return false;
+    }
+}
+
+//corpul functiei in locul apelului, ca func_def_node::invoke: argumentele se evalueaza in ordine (cele in plus
+//doar pentru efecte), cadrul porneste cu parametrii si restul void, rezultatul e al primului return sau valoarea
+//implicita. Corpul nu are apeluri care sa nu se inlinieze, deci nu poate atinge adancimea maxima de apeluri
+int IrBuilder::inlineCall(int function, int receiver, const node_list& args) {
+    func_def_node* f = table.at(function);
+    size_t params = f->param_names.size();
+    std::vector<int> values;
+    for (size_t i = 0; i < args.size(); i++) {
+        int v = expr(args[i]);
+        if (i < params) values.push_back(v);
+    }
+
+    inlined.push_back({ f, INLINE_FRAMES + inlineCount++, receiver });
+    for (int s = 0; s < f->frame_slots; s++) {
+        std::string name = f->name + "." + (s < (int)params ? f->param_names[s] : std::to_string(s));
+        store(f->depth, s, name, s < (int)values.size() ? values[s] : constant(Value()));
+    }
+    int result = -1;
+    for (auto s : f->body->statements) {
+        if (s && s->kind == NODE_RETURN) {
+            result = expr(static_cast<return_node*>(s)->expr);
+            break;
+        }
+        stmt(s);
+    }
+    if (result < 0) result = constant(f->defaultResult());
+    inlined.pop_back();
+    return result;
+}
+
+//un apel (sau initializarea unui obiect) ruleaza cod din afara IR-ului: globalele folosite de functii se scriu
+//in sloturile VM-ului inainte (daca nu sunt deja acolo) si se recitesc dupa, ca definitii noi
+int IrBuilder::effect(IrInst inst) {
+    for (int g : sharedGlobals) {
+        long var = key(0, g);
+        int v = readVariable(var, current);
+        const IrInst& def = fn->insts[v];
+        if (def.op == IR_LOAD_GLOBAL && def.index == g) continue; //nicio atribuire de la ultimul apel
+        IrInst store(IR_STORE_GLOBAL);
+        store.index = g;
+        store.args.push_back(v);
+        store.var = names[var];
+        add(std::move(store));
+    }
+    int result = add(std::move(inst));
+    for (int g : sharedGlobals) {
+        long var = key(0, g);
+        IrInst load(IR_LOAD_GLOBAL);
+        load.index = g;
+        load.var = names[var];
+        writeVariable(var, current, add(std::move(load)));
+    }
+    return result;
+}
+
+//aceleasi opcoduri ca BytecodeCompiler::compileBinary
+int IrBuilder::binary(binary_expr_node* bin) {
+    int l = expr(bin->left);
+    if (bin->op == BIN_NOT || !bin->right) return op(OP_NOT, l);
+
+    if (bin->op == BIN_AND || bin->op == BIN_OR) {
+        OpCode code = bin->op == BIN_AND ? OP_AND_JUMP : OP_OR_JUMP;
+        if (!hasEffects(bin->right)) {
+            IrInst inst(IR_LOGIC);
+            inst.code = code;
+            inst.args = { l, expr(bin->right) };
+            return add(std::move(inst));
+        }
+
+        //dreapta se evalueaza doar daca stanga nu decide: pentru && stanga true, pentru || stanga false
+        int needsRight = bin->op == BIN_AND ? op(OP_TO_BOOL, l) : op(OP_TO_BOOL, op(OP_NOT, l));
+        int br = branch(needsRight);
+
+        int rhs = newBlock();
+        link(br, 0, rhs);
+        seal(rhs);
+        current = rhs;
+        int r = op(OP_TO_BOOL, expr(bin->right));
+        int rhsJump = jump();
+
+        int skip = newBlock();
+        link(br, 1, skip);
+        seal(skip);
+        current = skip;
+        IrInst shortcut(IR_LOGIC);
+        shortcut.code = code;
+        shortcut.args = { l, constant(Value()) };
+        int s = add(std::move(shortcut));
+        int skipJump = jump();
+
+        int join = newBlock();
+        link(rhsJump, 0, join);
+        link(skipJump, 0, join);
+        seal(join);
+        current = join;
+        int phi = addPhi(join, "");
+        fn->insts[phi].args = { r, s };
+        return phi;
+    }
+
+    int r = expr(bin->right);
+    int code = bin->op;
+    switch (bin->operand) {
+        case VAL_INT: return op((OpCode)(OP_ADD_I + code), l, r);
+        case VAL_FLOAT: return op((OpCode)(OP_ADD_F + code), l, r);
+        case VAL_STRING:
+            if (bin->op == BIN_ADD) return op(OP_CONCAT, l, r);
+            if (bin->op == BIN_EQ) return op(OP_EQ_S, l, r);
+            if (bin->op == BIN_NE) return op(OP_NE_S, l, r);
+            break;
+        case VAL_BOOL:
+            if (bin->op == BIN_EQ) return op(OP_EQ_B, l, r);
+            if (bin->op == BIN_NE) return op(OP_NE_B, l, r);
+            break;
+        case VAL_ARRAY: return array(OP_ARRAY_ARITH, code, { l, r });
+        default:
+            break;
+    }
+    return op((OpCode)(OP_ADD + code), l, r);
+}
+
+//blocurile de dupa un return nu au predecesori; le scoatem, impreuna cu muchiile spre blocurile vii
+void IrBuilder::removeUnreachable() {
+    std::vector<bool> reachable(fn->blocks.size(), false);
+    std::vector<int> work = { 0 };
+    reachable[0] = true;
+    while (!work.empty()) {
+        int b = work.back();
+        work.pop_back();
+        for (int s : fn->successors(b)) {
+            if (!reachable[s]) {
+                reachable[s] = true;
+                work.push_back(s);
+            }
+        }
+    }
+
+    for (size_t b = 0; b < fn->blocks.size(); b++) {
+        IrBlock& block = fn->blocks[b];
+        if (!reachable[b]) {
+            block.removed = true;
+            for (int i : block.insts) fn->insts[i].removed = true;
+            block.insts.clear();
+            block.preds.clear();
+            continue;
+        }
+        for (size_t k = block.preds.size(); k-- > 0;) {
+            if (reachable[block.preds[k]]) continue;
+            block.preds.erase(block.preds.begin() + k);
+            for (int i : block.insts)
+                if (fn->insts[i].op == IR_PHI) fn->insts[i].args.erase(fn->insts[i].args.begin() + k);
+        }
+    }
+}
+
+IrFunction IrBuilder::build(program_node* program, int inlineSize) {
+    IrFunction result;
+    fn = &result;
+    currentDef.clear();
+    incompletePhis.clear();
+    sealed.clear();
+    names.clear();
+
+    table = FunctionTable();
+    sharedGlobals.clear();
+    this->inlineSize = inlineSize;
+    inlined.clear();
+    inlineCount = 0;
+    objectSlots.clear();
+    current = newBlock();
+    seal(current);
+    if (program) {
+        table.collect(program);
+        costs.assign(table.size(), -2);
+
+        //localele lui main care tin mereu un obiect: create de declaratie sau copiate din alta astfel de locala,
+        //la fiecare declaratie si atribuire (punct fix, ca la CppEmitter::refine)
+        std::vector<ast_node*> stores;
+        collectStores(program->main_block ? static_cast<main_node*>(program->main_block)->body : nullptr, stores);
+        std::vector<bool> declared;
+        for (auto n : stores) {
+            if (n->kind != NODE_VAR_DECL) continue;
+            var_decl_node* d = static_cast<var_decl_node*>(n);
+            if (d->slot < 0) continue;
+            if ((int)objectSlots.size() <= d->slot) {
+                objectSlots.resize(d->slot + 1, false);
+                declared.resize(d->slot + 1, false);
+            }
+            bool object = d->type && d->type->type == TYPE_CLASS && (d->init_val || table.findClass(d->class_id) >= 0);
+            objectSlots[d->slot] = object && (!declared[d->slot] || objectSlots[d->slot]);
+            declared[d->slot] = true;
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto n : stores) {
+                int slot = n->kind == NODE_VAR_DECL ? static_cast<var_decl_node*>(n)->slot : static_cast<assign_node*>(n)->slot;
+                ast_node* value = n->kind == NODE_VAR_DECL ? static_cast<var_decl_node*>(n)->init_val : static_cast<assign_node*>(n)->val;
+                if (slot < 0 || slot >= (int)objectSlots.size() || !objectSlots[slot] || (n->kind == NODE_VAR_DECL && !value)) continue;
+                id_node* id = value && value->kind == NODE_ID ? static_cast<id_node*>(value) : nullptr;
+                if (id && id->depth == 1 && id->slot >= 0 && id->slot < (int)objectSlots.size() && objectSlots[id->slot] &&
+                    (n->kind == NODE_ASSIGN || id->slot != slot)) continue;
+                objectSlots[slot] = false;
+                changed = true;
+            }
+        }
+
+        std::vector<bool> used(program->global_slots, false);
+        for (int i = 0; i < table.size(); i++) collectGlobals(table.at(i)->body, used);
+        for (int i = 0; i < table.classCount(); i++)
+            for (auto m : table.classAt(i)->members)
+                if (m && m->kind == NODE_VAR_DECL) collectGlobals(m, used);
+        for (int g = 0; g < (int)used.size(); g++)
+            if (used[g]) sharedGlobals.push_back(g);
+        for (auto g : program->globals)
+            if (g && g->kind == NODE_VAR_DECL) {
+                var_decl_node* d = static_cast<var_decl_node*>(g);
+                if (d->slot >= 0) names[key(0, d->slot)] = d->name;
+            }
+        for (auto g : program->globals) stmt(g);
+        stmt(program->main_block);
+    }
+    add(IrInst(IR_HALT));
+    removeUnreachable();
+    fn = nullptr;
+    return result;
+}
+
+namespace {
+
+class IrLowering {
+    const IrFunction& fn;
+    Chunk chunk;
+    std::vector<int> uses, userBlock, slot;
+    std::vector<bool> inlined;
+    std::vector<int> blockStart;
+    std::vector<std::pair<int, int>> fixups; //instructiunea de salt -> blocul tinta
+
+    int addConstant(const Value& v) {
+        chunk.constants.push_back(v);
+        return (int)chunk.constants.size() - 1;
+    }
+
+    void value(int v) {
+        v = fn.resolve(v);
+        const IrInst& in = fn.insts[v];
+        if (in.op == IR_CONST) chunk.emit(OP_CONST, addConstant(in.constant));
+        else if (inlined[v]) compute(v);
+        else chunk.emit(OP_LOAD_LOCAL, slot[v]);
+    }
+
+    void compute(int v) {
+        const IrInst& in = fn.insts[v];
+        switch (in.op) {
+            case IR_CONST: chunk.emit(OP_CONST, addConstant(in.constant)); return;
+            case IR_COPY: value(in.args[0]); return;
+            case IR_OP:
+                for (int a : in.args) value(a);
+                chunk.emit(in.code);
+                return;
+            case IR_LOGIC: {
+                value(in.args[0]);
+                int j = chunk.emit(in.code);
+                value(in.args[1]);
+                chunk.emit(OP_TO_BOOL);
+                chunk.patch(j, chunk.here());
+                return;
+            }
+            case IR_CALL:
+                for (int a : in.args) value(a);
+                chunk.emit(in.code, in.index);
+                return;
+            case IR_LOAD_GLOBAL:
+                chunk.emit(OP_LOAD_GLOBAL, in.index);
+                return;
+            case IR_GET_FIELD:
+                value(in.args[0]);
+                chunk.emit(OP_GET_FIELD, in.index);
+                return;
+            case IR_ARRAY:
+                for (int a : in.args) value(a);
+                chunk.emit(in.code, in.index < 0 ? 0 : in.index);
+                return;
+            default:
+                return;
+        }
+    }
+
+    void jumpTo(OpCode op, int block) {
+        fixups.push_back({ chunk.emit(op), block });
+    }
+
+    //copiile paralele pe muchia from -> to: intai toate valorile pe stiva, apoi scrierile in ordine inversa
+    void phiCopies(int from, int to) {
+        const IrBlock& target = fn.blocks[to];
+        size_t k = std::find(target.preds.begin(), target.preds.end(), from) - target.preds.begin();
+        std::vector<int> phis;
+        for (int i : target.insts) {
+            const IrInst& in = fn.insts[i];
+            if (in.op != IR_PHI) break;
+            if (k < in.args.size() && fn.resolve(in.args[k]) != i) phis.push_back(i);
+        }
+        for (int p : phis) value(fn.insts[p].args[k]);
+        for (size_t i = phis.size(); i-- > 0;) {
+            chunk.emit(OP_STORE_LOCAL, slot[phis[i]]);
+            chunk.emit(OP_POP);
+        }
+    }
+
+    void root(int id, int next) {
+        const IrInst& in = fn.insts[id];
+        switch (in.op) {
+            case IR_CONST:
+            case IR_PHI:
+                return;
+            case IR_COPY:
+            case IR_OP:
+            case IR_LOGIC:
+            case IR_CALL:
+            case IR_LOAD_GLOBAL:
+            case IR_GET_FIELD:
+            case IR_ARRAY:
+                if (inlined[id]) return;
+                compute(id);
+                if (slot[id] >= 0) chunk.emit(OP_STORE_LOCAL, slot[id]);
+                chunk.emit(OP_POP);
+                return;
+            case IR_STORE_GLOBAL:
+                value(in.args[0]);
+                chunk.emit(OP_STORE_GLOBAL, in.index);
+                chunk.emit(OP_POP);
+                return;
+            case IR_SET_FIELD:
+                value(in.args[0]);
+                value(in.args[1]);
+                chunk.emit(OP_SET_FIELD, in.index);
+                chunk.emit(OP_POP);
+                return;
+            case IR_PRINT:
+                value(in.args[0]);
+                chunk.emit(OP_PRINT);
+                return;
+            case IR_JUMP:
+                phiCopies(in.block, in.targets[0]);
+                if (in.targets[0] != next) jumpTo(OP_JUMP, in.targets[0]);
+                return;
+            case IR_BRANCH:
+                value(in.args[0]);
+                jumpTo(OP_JUMP_IF_FALSE, in.targets[1]);
+                if (in.targets[0] != next) jumpTo(OP_JUMP, in.targets[0]);
+                return;
+            case IR_HALT:
+                chunk.emit(OP_HALT);
+                return;
+        }
+    }
+
+public:
+    explicit IrLowering(const IrFunction& f) : fn(f) {}
+
+    Chunk lower() {
+        size_t n = fn.insts.size();
+        uses.assign(n, 0);
+        userBlock.assign(n, -1);
+        slot.assign(n, -1);
+        inlined.assign(n, false);
+
+        //un operand de phi e folosit la finalul predecesorului respectiv, unde se fac copiile
+        for (size_t i = 0; i < n; i++) {
+            const IrInst& in = fn.insts[i];
+            if (in.removed) continue;
+            for (size_t k = 0; k < in.args.size(); k++) {
+                int a = fn.resolve(in.args[k]);
+                uses[a]++;
+                userBlock[a] = in.op == IR_PHI ? fn.blocks[in.block].preds[k] : in.block;
+            }
+        }
+
+        //o valoare folosita o singura data, mai jos in acelasi bloc, se calculeaza direct la locul folosirii.
+        //Apelurile, citirile globalelor sau ale campurilor si operatiile pe tablouri raman la locul lor (ordinea fata de
+        //apeluri si scrieri conteaza)
+        int slots = 0;
+        for (size_t i = 0; i < n; i++) {
+            const IrInst& in = fn.insts[i];
+            if (in.removed) continue;
+            bool computed = in.op == IR_COPY || in.op == IR_OP || in.op == IR_LOGIC;
+            bool ordered = in.op == IR_CALL || in.op == IR_LOAD_GLOBAL || in.op == IR_GET_FIELD || in.op == IR_ARRAY;
+            if (computed && uses[i] == 1 && userBlock[i] == in.block) inlined[i] = true;
+            else if (in.op == IR_PHI || ((computed || ordered) && uses[i] > 0)) slot[i] = slots++;
+        }
+        chunk.localCount = slots;
+
+        std::vector<int> order;
+        for (size_t b = 0; b < fn.blocks.size(); b++)
+            if (!fn.blocks[b].removed) order.push_back((int)b);
+
+        blockStart.assign(fn.blocks.size(), 0);
+        for (size_t k = 0; k < order.size(); k++) {
+            int b = order[k];
+            int next = k + 1 < order.size() ? order[k + 1] : -1;
+            blockStart[b] = chunk.here();
+            for (int id : fn.blocks[b].insts) root(id, next);
+        }
+        chunk.emit(OP_HALT);
+
+        for (auto& f : fixups) chunk.patch(f.first, blockStart[f.second]);
+        return std::move(chunk);
+    }
+};
+
+}
+
+Chunk lowerIr(const IrFunction& fn, program_node* program) {
+    IrLowering lowering(fn);
+    Chunk chunk = lowering.lower();
+    if (program) {
+        chunk.globalCount = program->global_slots;
+        BytecodeCompiler().compileFunctions(program, chunk);
+    }
+    return chunk;
+}
@@ -0,0 +1,174 @@
+#ifndef IR_H
+#define IR_H
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "value.h"
+#include "ast.h"
+#include "bytecode.h"
+
+//reprezentarea intermediara in forma SSA: blocuri de baza cu instructiuni care produc fiecare o valoare
+//(identificata prin indexul instructiunii). Variabilele programului (globale si locale din main) nu au
+//sloturi aici: fiecare atribuire creeaza o valoare noua, iar la jonctiuni apar phi-uri.
+//Operatiile sunt cele ale VM-ului, deci semantica e aceeasi cu bytecode-ul; la final IR-ul se coboara intr-un Chunk.
+//Doar main e in IR; functiile apelate vad globalele prin sloturile VM-ului, asa ca globalele pe care le folosesc
+//se scriu inainte de fiecare apel si se recitesc dupa el. Campurile obiectelor nu sunt valori SSA: citirile si
+//scrierile lor raman in ordinea din program. Functiile si metodele mici se inliniaza: corpul lor intra in IR-ul
+//lui main, cu parametrii si localele ca variabile proprii fiecarui apel.
+enum IrOp {
+    IR_CONST,   // constant
+    IR_PHI,     // args[k] vine din blocks[block].preds[k]
+    IR_COPY,    // args[0], pastrat sub numele variabilei (vezi var)
+    IR_OP,      // operatia VM code aplicata pe args (1 sau 2)
+    IR_LOGIC,   // && / || (code = OP_AND_JUMP / OP_OR_JUMP) pe args[0], args[1]; dreapta e pura
+    IR_PRINT,   // afiseaza args[0]
+    IR_CALL,    // functions[index] (code = OP_CALL / OP_CALL_METHOD, obiectul e args[0]) cu argumentele args,
+                // sau un obiect nou din classes[index] (code = OP_NEW)
+    IR_LOAD_GLOBAL,   // globals[index]
+    IR_STORE_GLOBAL,  // globals[index] = args[0]
+    IR_GET_FIELD,     // campul index al obiectului args[0]
+    IR_SET_FIELD,     // campul index al obiectului args[0] = args[1]
+    IR_ARRAY,   // operatia pe tablouri code (OP_NEW_ARRAY ... OP_ARRAY_ARITH, fara OP_ARRAY_LEN) pe args, cu argumentul
+                // index; poate opri programul si citeste elemente care se schimba, deci ramane in ordine
+    IR_JUMP,    // -> targets[0]
+    IR_BRANCH,  // args[0] bool true ? targets[0] : targets[1]
+    IR_HALT
+};
+
+struct IrInst {
+    IrOp op;
+    OpCode code = OP_HALT;
+    std::vector<int> args;
+    Value constant;
+    int targets[2] = { -1, -1 };
+    int index = -1; //functia apelata, clasa, slotul global sau campul
+    int block = -1;
+    std::string var; //variabila din sursa sau functia apelata (doar pentru dump)
+    bool removed = false;
+
+    explicit IrInst(IrOp o) : op(o) {}
+
+    bool isTerminator() const { return op == IR_JUMP || op == IR_BRANCH || op == IR_HALT; }
+    //fara efecte si fara capcane: poate fi eliminata, mutata sau reutilizata
+    bool isPure() const { return op == IR_CONST || op == IR_COPY || op == IR_OP || op == IR_LOGIC || op == IR_PHI; }
+    //fara efecte, dar legata de pozitia ei fata de apeluri si scrieri: poate doar fi eliminata
+    bool isRemovable() const {
+        return isPure() || op == IR_LOAD_GLOBAL || op == IR_GET_FIELD || (op == IR_ARRAY && code == OP_INDEX_UNCHECKED);
+    }
+};
+
+struct IrBlock {
+    std::vector<int> insts;
+    std::vector<int> preds;
+    bool removed = false;
+};
+
+//bucla while: blocurile [header, last] (construite consecutiv), intrarea vine din preheader
+struct IrLoop {
+    int preheader, header, last;
+};
+
+struct IrFunction {
+    std::vector<IrInst> insts;
+    std::vector<IrBlock> blocks;
+    std::vector<IrLoop> loops;
+    std::vector<int> forward; //valoare inlocuita -> inlocuitor (vezi resolve)
+
+    int resolve(int v) const {
+        while (forward[v] != v) v = forward[v];
+        return v;
+    }
+    void replace(int from, int to) { forward[from] = to; }
+
+    std::vector<int> successors(int block) const;
+    //rescrie argumentele prin forward si scoate instructiunile eliminate din blocuri
+    void compact();
+    void dump(std::ostream& out) const;
+};
+
+//trecerile de optimizare; fiecare poate fi oprita din linia de comanda
+struct IrPasses {
+    bool cse = true;       // eliminarea subexpresiilor comune (pe arborele de dominatori)
+    bool licm = true;      // scoaterea calculelor invariante din bucle
+    bool copyProp = true;  // propagarea copiilor si a phi-urilor triviale
+    bool dse = true;       // eliminarea atribuirilor (valorilor) nefolosite
+    bool boundsElim = true; // indexarile a[i] din bucle cu conditia i < a.length() nu mai verifica limitele
+    int inlineSize = 32;   // inlining-ul functiilor nerecursive de cel mult atatea noduri (0 = oprit)
+};
+
+//construieste IR-ul din programul verificat (constructia SSA a lui Braun et al., fara tabele de dominanta)
+class IrBuilder {
+    IrFunction* fn;
+    int current;
+    std::map<long, std::map<int, int>> currentDef;         //variabila -> bloc -> valoare
+    std::map<int, std::map<long, int>> incompletePhis;     //bloc nesigilat -> variabila -> phi
+    std::vector<bool> sealed;
+    std::map<long, std::string> names;
+    FunctionTable table;
+    std::vector<int> sharedGlobals; //sloturile globale citite sau scrise de functii
+
+    //un apel inliniat: cadrul functiei e la adancimea frame (peste orice scope real, unica pe apel),
+    //iar intr-o metoda depth 1 sunt campurile lui receiver
+    struct Inlined {
+        func_def_node* f;
+        int frame;
+        int receiver;
+    };
+    static const int INLINE_FRAMES = 1 << 16;
+    int inlineSize = 0;
+    std::vector<int> costs;         //marimea corpului fiecarei functii, cu apelurile inliniate (-1: nu se inliniaza)
+    std::vector<Inlined> inlined;
+    int inlineCount = 0;
+    std::vector<bool> objectSlots;  //localele lui main care tin mereu un obiect
+
+    static long key(int depth, int slot) { return (long)depth << 32 | (unsigned)slot; }
+
+    int newBlock();
+    void seal(int block);
+    int add(IrInst inst);
+    int constant(const Value& v);
+    int op(OpCode code, int a, int b = -1);
+    int array(OpCode code, int arg, std::vector<int> args);
+    int jump();
+    int branch(int cond);
+    void link(int inst, int which, int target); //tinta saltului + predecesorul blocului tinta
+    int addPhi(int block, const std::string& var);
+
+    void writeVariable(long var, int block, int value);
+    int readVariable(long var, int block);
+    int addPhiOperands(long var, int phi);
+    int assign(int depth, int slot, const std::string& name, int value);
+    int load(int depth, int slot, const std::string& name);
+    int store(int depth, int slot, const std::string& name, int value);
+
+    void stmt(ast_node* node);
+    int expr(ast_node* node);
+    int binary(binary_expr_node* bin);
+    int call(int function, OpCode code, ast_node* receiver, const node_list& args);
+    int effect(IrInst inst);
+    void removeUnreachable();
+
+    int cost(int function);
+    int cost(ast_node* node);
+    bool isObject(ast_node* receiver, int value) const;
+    int inlineCall(int function, int receiver, const node_list& args);
+
+public:
+    IrFunction build(program_node* program, int inlineSize = IrPasses().inlineSize);
+};
+
+void eliminateCommonSubexpressions(IrFunction& fn);
+void hoistLoopInvariants(IrFunction& fn);
+void propagateCopies(IrFunction& fn);
+void eliminateDeadStores(IrFunction& fn);
+void eliminateBoundsChecks(IrFunction& fn);
+void optimizeIr(IrFunction& fn, const IrPasses& passes);
+
+//scoate IR-ul din SSA: fiecare valoare folosita in alt bloc sau de mai multe ori primeste un slot local,
+//cele folosite o singura data, imediat, raman pe stiva ca in bytecode-ul facut direct din arbore.
+//Functiile si metodele programului se adauga dupa main, compilate direct din arbore
+Chunk lowerIr(const IrFunction& fn, program_node* program);
+
+#endif
@@ -0,0 +1,263 @@
+#include "ir.h"
+#include <algorithm>
+
+namespace {
+
+//dominatorii imediati (Cooper, Harvey, Kennedy) pe ordinea postordine inversa
+std::vector<int> immediateDominators(const IrFunction& fn, std::vector<int>& rpo) {
+    size_t n = fn.blocks.size();
+    std::vector<int> post;
+    std::vector<bool> seen(n, false);
+    std::vector<std::pair<int, size_t>> stack = { { 0, 0 } };
+    seen[0] = true;
+    while (!stack.empty()) {
+        int b = stack.back().first;
+        std::vector<int> succ = fn.successors(b);
+        if (stack.back().second < succ.size()) {
+            int s = succ[stack.back().second++];
+            if (!seen[s]) {
+                seen[s] = true;
+                stack.push_back({ s, 0 });
+            }
+            continue;
+        }
+        post.push_back(b);
+        stack.pop_back();
+    }
+    rpo.assign(post.rbegin(), post.rend());
+
+    std::vector<int> order(n, -1);
+    for (size_t i = 0; i < rpo.size(); i++) order[rpo[i]] = (int)i;
+
+    std::vector<int> idom(n, -1);
+    idom[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < rpo.size(); i++) {
+            int b = rpo[i];
+            int dom = -1;
+            for (int p : fn.blocks[b].preds) {
+                if (idom[p] < 0) continue;
+                if (dom < 0) { dom = p; continue; }
+                int x = p, y = dom;
+                while (x != y) {
+                    while (order[x] > order[y]) x = idom[x];
+                    while (order[y] > order[x]) y = idom[y];
+                }
+                dom = x;
+            }
+            if (dom >= 0 && idom[b] != dom) {
+                idom[b] = dom;
+                changed = true;
+            }
+        }
+    }
+    return idom;
+}
+
+}
+
+//doua calcule pure cu aceeasi operatie si aceleasi argumente: al doilea foloseste rezultatul primului,
+//daca primul il domina. Tabela e cu domenii: ce se adauga intr-un bloc e vizibil doar in subarborele lui.
+void eliminateCommonSubexpressions(IrFunction& fn) {
+    std::vector<int> rpo;
+    std::vector<int> idom = immediateDominators(fn, rpo);
+    std::vector<std::vector<int>> children(fn.blocks.size());
+    for (int b : rpo)
+        if (b != 0) children[idom[b]].push_back(b);
+
+    std::map<std::vector<int>, int> available;
+    std::vector<std::pair<int, std::vector<std::vector<int>>>> stack; //blocul si cheile adaugate de el
+    stack.push_back({ 0, {} });
+    std::vector<size_t> next(fn.blocks.size(), 0);
+    bool entered = false;
+
+    while (!stack.empty()) {
+        int b = stack.back().first;
+        if (!entered) {
+            for (int id : fn.blocks[b].insts) {
+                IrInst& in = fn.insts[id];
+                if (in.op != IR_OP && in.op != IR_LOGIC) continue;
+                std::vector<int> key = { in.op, in.code };
+                for (auto& a : in.args) {
+                    a = fn.resolve(a);
+                    key.push_back(a);
+                }
+                auto it = available.find(key);
+                if (it != available.end()) {
+                    fn.replace(id, it->second);
+                    in.removed = true;
+                }
+                else {
+                    available[key] = id;
+                    stack.back().second.push_back(key);
+                }
+            }
+        }
+        if (next[b] < children[b].size()) {
+            stack.push_back({ children[b][next[b]++], {} });
+            entered = false;
+            continue;
+        }
+        for (auto& key : stack.back().second) available.erase(key);
+        stack.pop_back();
+        entered = true;
+    }
+    fn.compact();
+}
+
+//calculele pure din bucla ale caror argumente sunt definite in afara ei se muta la finalul preheaderului.
+//Buclele interioare (construite mai tarziu) se trateaza primele, ca valorile sa poata urca mai multe niveluri.
+void hoistLoopInvariants(IrFunction& fn) {
+    for (size_t k = fn.loops.size(); k-- > 0;) {
+        const IrLoop& loop = fn.loops[k];
+        if (fn.blocks[loop.header].removed || fn.blocks[loop.preheader].removed) continue;
+        auto inLoop = [&](int block) { return block >= loop.header && block <= loop.last; };
+
+        std::vector<int>& pre = fn.blocks[loop.preheader].insts;
+        for (int b = loop.header; b <= loop.last; b++) {
+            std::vector<int>& list = fn.blocks[b].insts;
+            for (size_t i = 0; i < list.size();) {
+                IrInst& in = fn.insts[list[i]];
+                bool candidate = in.op == IR_CONST || in.op == IR_OP || in.op == IR_LOGIC || in.op == IR_COPY;
+                for (auto& a : in.args) {
+                    a = fn.resolve(a);
+                    if (inLoop(fn.insts[a].block)) candidate = false;
+                }
+                if (!candidate) { i++; continue; }
+
+                in.block = loop.preheader;
+                pre.insert(pre.end() - 1, list[i]); //inaintea saltului spre header
+                list.erase(list.begin() + i);
+            }
+        }
+    }
+}
+
+//copiile dispar (folosirile trec direct la sursa), la fel phi-urile ale caror operanzi sunt toti aceeasi valoare
+void propagateCopies(IrFunction& fn) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t id = 0; id < fn.insts.size(); id++) {
+            IrInst& in = fn.insts[id];
+            if (in.removed) continue;
+            if (in.op == IR_COPY) {
+                fn.replace((int)id, fn.resolve(in.args[0]));
+                in.removed = true;
+                changed = true;
+            }
+            else if (in.op == IR_PHI) {
+                int same = -1;
+                bool trivial = true;
+                for (int a : in.args) {
+                    a = fn.resolve(a);
+                    if (a == (int)id || a == same) continue;
+                    if (same >= 0) { trivial = false; break; }
+                    same = a;
+                }
+                if (trivial && same >= 0) {
+                    fn.replace((int)id, same);
+                    in.removed = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+    fn.compact();
+}
+
+//in SSA o atribuire e o valoare; cea pe care nu o mai citeste nimic (nici print, nici o conditie, nici un apel)
+//se elimina, iar odata cu ea si calculele care o produceau
+void eliminateDeadStores(IrFunction& fn) {
+    std::vector<int> uses(fn.insts.size(), 0);
+    for (size_t id = 0; id < fn.insts.size(); id++) {
+        const IrInst& in = fn.insts[id];
+        if (in.removed) continue;
+        for (int a : in.args) {
+            a = fn.resolve(a);
+            if (a != (int)id) uses[a]++; //phi-ul care se foloseste doar pe sine e tot mort
+        }
+    }
+
+    std::vector<int> work;
+    for (size_t id = 0; id < fn.insts.size(); id++)
+        if (!fn.insts[id].removed && fn.insts[id].isRemovable() && uses[id] == 0) work.push_back((int)id);
+
+    while (!work.empty()) {
+        int id = work.back();
+        work.pop_back();
+        IrInst& in = fn.insts[id];
+        if (in.removed) continue;
+        in.removed = true;
+        for (int a : in.args) {
+            a = fn.resolve(a);
+            if (a == id) continue;
+            if (--uses[a] == 0 && fn.insts[a].isRemovable()) work.push_back(a);
+        }
+    }
+    fn.compact();
+}
+
+//bucla while cu conditia i < a.length() (sau a.length() > i), unde i e un phi din header care porneste de la o
+//constanta >= 0 si creste pe fiecare muchie de intoarcere cu o constanta pozitiva: in corp 0 <= i < lungime, deci
+//a[i] si a[i] = v nu mai verifica limitele. Lungimea unui tablou nu se schimba, iar i + pas nu depaseste int
+//(lungimea e cel mult MAX_ARRAY_LENGTH). Un tablou void are lungimea void: LT_I o citeste ca 0, GT_I cu ea in
+//stanga da void, deci corpul nu ruleaza.
+void eliminateBoundsChecks(IrFunction& fn) {
+    auto intConst = [&](int v, int& out) {
+        const IrInst& in = fn.insts[fn.resolve(v)];
+        if (in.op != IR_CONST || in.constant.type != VAL_INT) return false;
+        out = in.constant.i;
+        return true;
+    };
+
+    for (const IrLoop& loop : fn.loops) {
+        const IrBlock& header = fn.blocks[loop.header];
+        if (header.removed || header.insts.empty()) continue;
+        const IrInst& br = fn.insts[header.insts.back()];
+        if (br.op != IR_BRANCH || br.targets[0] != loop.header + 1) continue;
+        const IrInst& cond = fn.insts[fn.resolve(br.args[0])];
+        if (cond.op != IR_OP || (cond.code != OP_LT_I && cond.code != OP_GT_I)) continue;
+        int counter = fn.resolve(cond.args[cond.code == OP_LT_I ? 0 : 1]);
+        const IrInst& length = fn.insts[fn.resolve(cond.args[cond.code == OP_LT_I ? 1 : 0])];
+        if (length.op != IR_OP || length.code != OP_ARRAY_LEN) continue;
+        int array = fn.resolve(length.args[0]);
+
+        const IrInst& phi = fn.insts[counter];
+        if (phi.op != IR_PHI || phi.block != loop.header) continue;
+        bool counts = true;
+        for (size_t k = 0; k < phi.args.size() && counts; k++) {
+            int start, step;
+            if (header.preds[k] == loop.preheader) {
+                counts = intConst(phi.args[k], start) && start >= 0;
+                continue;
+            }
+            const IrInst& next = fn.insts[fn.resolve(phi.args[k])];
+            counts = next.op == IR_OP && next.code == OP_ADD_I;
+            if (!counts) break;
+            int l = fn.resolve(next.args[0]), r = fn.resolve(next.args[1]);
+            counts = ((l == counter && intConst(r, step)) || (r == counter && intConst(l, step))) &&
+                     step > 0 && step <= 1 << 30;
+        }
+        if (!counts) continue;
+
+        for (int b = loop.header + 1; b <= loop.last; b++) {
+            for (int id : fn.blocks[b].insts) {
+                IrInst& in = fn.insts[id];
+                if (in.op != IR_ARRAY || (in.code != OP_INDEX && in.code != OP_SET_INDEX)) continue;
+                if (fn.resolve(in.args[0]) != array || fn.resolve(in.args[1]) != counter) continue;
+                in.code = in.code == OP_INDEX ? OP_INDEX_UNCHECKED : OP_SET_INDEX_UNCHECKED;
+            }
+        }
+    }
+}
+
+void optimizeIr(IrFunction& fn, const IrPasses& passes) {
+    if (passes.copyProp) propagateCopies(fn);
+    if (passes.cse) eliminateCommonSubexpressions(fn);
+    if (passes.licm) hoistLoopInvariants(fn);
+    if (passes.boundsElim) eliminateBoundsChecks(fn);
+    if (passes.dse) eliminateDeadStores(fn);
+}
@@ -0,0 +1,72 @@
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+#include "value.h"
+
+//inregistrarile de aceeasi marime (antet + fieldCount valori) se aloca in blocuri si se refolosesc
+//printr-o lista libera: un obiect creat intr-o bucla ia inapoi inregistrarea celui eliberat la pasul anterior.
+//Clasele cu acelasi numar de campuri impart pool-ul. Un pool apartine firului care executa programul.
+class ObjectPool {
+    int fieldCount;
+    size_t recordSize;
+    size_t nextChunk = 16; //inregistrari in urmatorul bloc; se dubleaza pana la 4096
+    std::vector<Object*> freeList;
+    std::vector<void*> chunks;
+
+    void grow() {
+        char* chunk = static_cast<char*>(std::malloc(recordSize * nextChunk));
+        if (!chunk) throw std::bad_alloc();
+        chunks.push_back(chunk);
+        for (size_t k = nextChunk; k-- > 0;) freeList.push_back(reinterpret_cast<Object*>(chunk + k * recordSize));
+        if (nextChunk < 4096) nextChunk *= 2;
+    }
+
+public:
+    explicit ObjectPool(int fields) : fieldCount(fields), recordSize(sizeof(Object) + fields * sizeof(Value)) {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    //obiectele ramase in viata (cicluri de referinte) nu se mai distrug, doar memoria lor se elibereaza
+    ~ObjectPool() {
+        for (void* c : chunks) std::free(c);
+    }
+
+    //campurile pornesc void; cine creeaza obiectul le initializeaza
+    Object* allocate() {
+        if (freeList.empty()) grow();
+        Object* o = freeList.back();
+        freeList.pop_back();
+        o->refs = 0;
+        o->pool = this;
+        Value* f = o->fields();
+        for (int k = 0; k < fieldCount; k++) new (f + k) Value();
+        return o;
+    }
+
+    void recycle(Object* o) {
+        Value* f = o->fields();
+        for (int k = 0; k < fieldCount; k++) f[k].~Value();
+        freeList.push_back(o);
+    }
+
+    int fields() const { return fieldCount; }
+
+    //pool-ul firului curent pentru inregistrarile cu fields campuri
+    static ObjectPool& forFields(int fields) {
+        thread_local std::vector<std::unique_ptr<ObjectPool>> pools;
+        if ((int)pools.size() <= fields) pools.resize(fields + 1);
+        if (!pools[fields]) pools[fields].reset(new ObjectPool(fields));
+        return *pools[fields];
+    }
+};
+
+//un obiect nou cu campurile void
+inline Value newObject(int fields) {
+    return Value(ObjectPool::forFields(fields).allocate());
+}
+
+#endif
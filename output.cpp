@@ -0,0 +1,50 @@
+#include "output.h"
+#include <cerrno>
+#include <iostream>
+#include <unistd.h>
+
+void OutputSink::printLine(const Value& v) {
+    if (v.type == VAL_STRING) {
+        write(v.s());
+    }
+    else if (v.type == VAL_ARRAY) {
+        write(v.toString());
+    }
+    else if (buffer.size() - used >= Value::FORMAT_CHARS) {
+        used += v.formatScalar(buffer.data() + used);
+    }
+    else {
+        char buf[Value::FORMAT_CHARS];
+        write(buf, v.formatScalar(buf));
+    }
+
+    if (used == buffer.size()) flush();
+    buffer[used++] = '\n';
+    if (lineBuffered) flush();
+}
+
+void FdSink::writeOut(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return; //iesirea a fost inchisa (de ex. pipe spart); restul se pierde, ca la cout
+        }
+        data += n;
+        size -= n;
+    }
+}
+
+bool FdSink::isTerminal() const {
+    return isatty(fd) == 1;
+}
+
+OutputSink& standardOutput() {
+    static FdSink sink(STDOUT_FILENO);
+    return sink;
+}
+
+void runtimeError(const std::string& message) {
+    if (OutputSink* out = OutputSink::current()) out->flush();
+    std::cerr << "Error: " << message << std::endl;
+}
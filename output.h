@@ -0,0 +1,93 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "value.h"
+
+//destinatia lui print: un buffer mare golit cand se umple, la flush() si la distrugere.
+//In modul linie cu linie (terminal) se goleste dupa fiecare '\n'. Backend-ul scrie efectiv octetii.
+class OutputSink {
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool lineBuffered = false;
+
+protected:
+    virtual void writeOut(const char* data, size_t size) = 0;
+
+public:
+    explicit OutputSink(size_t capacity = 1 << 16) : buffer(capacity) {}
+    virtual ~OutputSink() {}
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    void setLineBuffered(bool on) { lineBuffered = on; }
+    bool isLineBuffered() const { return lineBuffered; }
+
+    void write(const char* data, size_t size) {
+        if (size > buffer.size() - used) {
+            flush();
+            if (size >= buffer.size()) { //mai mare decat bufferul: direct
+                writeOut(data, size);
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+    }
+    void write(std::string_view s) { write(s.data(), s.size()); }
+
+    void flush() {
+        if (used) writeOut(buffer.data(), used);
+        used = 0;
+    }
+
+    //valoarea formatata direct in buffer (fara std::string temporar), urmata de '\n'
+    void printLine(const Value& v);
+
+    //iesirea programului care ruleaza pe thread-ul curent (ca Stats::current), golita de runtimeError
+    inline static thread_local OutputSink* active = nullptr;
+    static OutputSink* current() { return active; }
+
+    class Scope {
+        OutputSink* previous;
+    public:
+        explicit Scope(OutputSink* s) : previous(active) { active = s; }
+        ~Scope() { active = previous; }
+    };
+};
+
+//scrie intr-un descriptor de fisier cu write(2); golit la distrugere
+class FdSink : public OutputSink {
+    int fd;
+protected:
+    void writeOut(const char* data, size_t size) override;
+public:
+    explicit FdSink(int descriptor, size_t capacity = 1 << 16) : OutputSink(capacity), fd(descriptor) {}
+    ~FdSink() override { flush(); }
+
+    bool isTerminal() const;
+};
+
+//scrie intr-un std::ostream (fisiere, ostringstream in benchmark-uri si in compilarile paralele)
+class StreamSink : public OutputSink {
+    std::ostream& out;
+protected:
+    void writeOut(const char* data, size_t size) override { out.write(data, size); }
+public:
+    explicit StreamSink(std::ostream& o, size_t capacity = 1 << 16) : OutputSink(capacity), out(o) {}
+    ~StreamSink() override { flush(); out.flush(); }
+};
+
+//stdout-ul procesului; golit la iesire (destructor static)
+OutputSink& standardOutput();
+
+//o eroare la executie ("Error: <message>" la stderr); intai se goleste ce a afisat programul pana atunci,
+//ca mesajul sa apara dupa el si cand stdout si stderr merg in acelasi fisier
+void runtimeError(const std::string& message);
+
+#endif
@@ -0,0 +1,101 @@
+#include "profiler.h"
+#include "ast.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+//eticheta unui cadru: tipul nodului (si operatorul/numele, unde ajuta) + linia; fara spatii si ';'
+static std::string frameLabel(const ast_node* node) {
+    std::string label = nodeKindName(node->kind);
+    switch (node->kind) {
+        case NODE_BINARY:
+            label += binOpSymbol(static_cast<const binary_expr_node*>(node)->op);
+            break;
+        case NODE_ASSIGN:
+            label += ":" + static_cast<const assign_node*>(node)->name;
+            break;
+        case NODE_ID:
+            label += ":" + static_cast<const id_node*>(node)->name;
+            break;
+        case NODE_CALL:
+            label += ":" + static_cast<const call_node*>(node)->func_name;
+            break;
+        case NODE_METHOD_CALL:
+            label += ":" + static_cast<const method_call_node*>(node)->method;
+            break;
+        default:
+            break;
+    }
+    return label + "@" + std::to_string(node->line);
+}
+
+static double ms(uint64_t ns) { return ns / 1e6; }
+
+bool Profiler::writeReport(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    uint64_t total = 0;
+    std::map<int, NodeProfile> lines;
+    std::vector<const NodeProfile*> sorted;
+    for (const auto& entry : nodes) {
+        const NodeProfile& p = entry.second;
+        total += p.selfNs;
+        NodeProfile& l = lines[p.node->line];
+        l.visits += p.visits;
+        l.selfNs += p.selfNs;
+        sorted.push_back(&p);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const NodeProfile* a, const NodeProfile* b) { return a->selfNs > b->selfNs; });
+
+    std::vector<std::pair<int, const NodeProfile*>> byLine;
+    for (const auto& l : lines) byLine.push_back({ l.first, &l.second });
+    std::sort(byLine.begin(), byLine.end(), [](const auto& a, const auto& b) { return a.second->selfNs > b.second->selfNs; });
+
+    char buf[256];
+    out << "== linii (dupa timpul propriu) ==\n";
+    std::snprintf(buf, sizeof(buf), "%6s %12s %12s %7s\n", "linie", "vizite", "propriu ms", "%");
+    out << buf;
+    for (const auto& l : byLine) {
+        std::snprintf(buf, sizeof(buf), "%6d %12llu %12.3f %6.2f%%\n", l.first, (unsigned long long)l.second->visits,
+                      ms(l.second->selfNs), total ? 100.0 * l.second->selfNs / total : 0.0);
+        out << buf;
+    }
+
+    out << "\n== noduri (dupa timpul propriu) ==\n";
+    std::snprintf(buf, sizeof(buf), "%-28s %12s %12s %12s\n", "nod", "vizite", "propriu ms", "total ms");
+    out << buf;
+    for (const NodeProfile* p : sorted) {
+        std::snprintf(buf, sizeof(buf), "%-28s %12llu %12.3f %12.3f\n", frameLabel(p->node).c_str(),
+                      (unsigned long long)p->visits, ms(p->selfNs), ms(p->totalNs));
+        out << buf;
+    }
+    return true;
+}
+
+bool Profiler::writeFolded(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    //un rand pe stiva distincta: cadrele de la radacina la nod, apoi timpul propriu in microsecunde.
+    //Parcurgere in adancime cu un singur sir pentru cale (lanturile binare pot fi foarte adanci)
+    std::vector<std::vector<size_t>> children(frames.size());
+    for (size_t i = 1; i < frames.size(); i++) children[frames[i].parent].push_back(i);
+
+    std::string stack;
+    std::vector<std::pair<size_t, size_t>> todo; //(cadru, lungimea caii parintelui)
+    for (auto it = children[0].rbegin(); it != children[0].rend(); ++it) todo.push_back({ *it, 0 });
+    while (!todo.empty()) {
+        auto [frame, prefix] = todo.back();
+        todo.pop_back();
+        stack.resize(prefix);
+        if (prefix) stack += ';';
+        stack += frameLabel(frames[frame].node);
+
+        uint64_t us = frames[frame].selfNs / 1000;
+        if (us) out << stack << " " << us << "\n";
+        for (auto it = children[frame].rbegin(); it != children[frame].rend(); ++it) todo.push_back({ *it, stack.size() });
+    }
+    return true;
+}
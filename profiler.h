@@ -0,0 +1,113 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ast_node;
+
+//profilerul interpretorului pe arbore (--profile): vizite si timp pe nod, pe linie de sursa si pe
+//stiva de noduri (while -> bloc -> atribuire -> expresie binara ...). Activ doar pe thread-ul pe
+//care a fost instalat cu Profiler::Scope; altfel ProfileScope se reduce la un test de pointer nul.
+class Profiler {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    struct NodeProfile {
+        const ast_node* node;
+        uint64_t visits = 0;
+        uint64_t selfNs = 0;
+        uint64_t totalNs = 0;   //inclusiv copiii; recursivitatea nu e numarata de doua ori
+        int onStack = 0;
+    };
+
+    inline static thread_local Profiler* active = nullptr;
+    static Profiler* current() { return active; }
+
+    class Scope {
+        Profiler* previous;
+    public:
+        explicit Scope(Profiler* p) : previous(active) { active = p; }
+        ~Scope() { active = previous; }
+    };
+
+    void enter(const ast_node* node) {
+        size_t parent = stack.empty() ? 0 : stack.back().frame;
+        stack.push_back({ child(parent, node), clock::now(), 0 });
+        frames[stack.back().frame].profile->onStack++;
+    }
+
+    void leave() {
+        Active top = stack.back();
+        stack.pop_back();
+        uint64_t elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - top.start).count();
+        uint64_t self = elapsed > top.childNs ? elapsed - top.childNs : 0;
+        if (!stack.empty()) stack.back().childNs += elapsed;
+
+        Frame& f = frames[top.frame];
+        f.selfNs += self;
+        NodeProfile* p = f.profile;
+        p->visits++;
+        p->selfNs += self;
+        if (--p->onStack == 0) p->totalNs += elapsed;
+    }
+
+    //profile.txt: nodurile si liniile sortate dupa timpul propriu; <folded>: stive pentru flamegraph.pl
+    bool writeReport(const std::string& path) const;
+    bool writeFolded(const std::string& path) const;
+
+    Profiler() { frames.push_back({ 0, nullptr, nullptr, 0 }); } //radacina arborelui de stive
+
+private:
+    //un nod din arborele de apeluri (trie de stive); frames[0] e radacina
+    struct Frame {
+        size_t parent;
+        const ast_node* node;
+        NodeProfile* profile;
+        uint64_t selfNs;
+    };
+
+    struct Active {
+        size_t frame;
+        clock::time_point start;
+        uint64_t childNs;
+    };
+
+    struct EdgeHash {
+        size_t operator()(const std::pair<size_t, const ast_node*>& e) const {
+            return std::hash<const void*>()(e.second) ^ (e.first * 0x9e3779b97f4a7c15ull);
+        }
+    };
+
+    std::vector<Frame> frames;
+    std::unordered_map<std::pair<size_t, const ast_node*>, size_t, EdgeHash> edges;
+    std::unordered_map<const ast_node*, NodeProfile> nodes;
+    std::vector<Active> stack;
+
+    size_t child(size_t parent, const ast_node* node) {
+        auto it = edges.find({ parent, node });
+        if (it != edges.end()) return it->second;
+        NodeProfile& p = nodes[node];
+        p.node = node;
+        frames.push_back({ parent, node, &p, 0 });
+        edges.emplace(std::make_pair(parent, node), frames.size() - 1);
+        return frames.size() - 1;
+    }
+};
+
+//cronometreaza un apel eval; pus la inceputul fiecarui eval prin EVAL_ENTER
+class ProfileScope {
+    Profiler* profiler;
+public:
+    explicit ProfileScope(const ast_node* node) : profiler(Profiler::current()) {
+        if (__builtin_expect(profiler != nullptr, 0)) profiler->enter(node);
+    }
+    ~ProfileScope() {
+        if (__builtin_expect(profiler != nullptr, 0)) profiler->leave();
+    }
+};
+
+#endif
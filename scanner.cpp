@@ -0,0 +1,306 @@
+#include "compilation.h"
+#include "comp.tab.h"
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+//scanner scris de mana, inlocuitor pentru lex.yy.c (se alege la link, vezi compile.sh): aceeasi interfata
+//reentranta ca flex si acelasi sir de tokeni ca regulile din comp.l. Spatiile, comentariile, identificatorii
+//si cifrele se parcurg cate 32 (AVX2) sau 16 (SSE2) octeti odata; cuvintele cheie se recunosc printr-un hash perfect.
+//SCANNER_NO_SIMD forteaza varianta scalara.
+#if !defined(SCANNER_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define SCANNER_AVX2
+#elif !defined(SCANNER_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define SCANNER_SSE2
+#endif
+
+namespace {
+
+struct Scanner {
+    CompilationContext* extra;
+    std::string owned;          //copia sursei pentru FILE* si yy_scan_bytes (terminata cu 0)
+    const char* pos = nullptr;
+    const char* end = nullptr;  //*end e mereu 0
+    int line = 1;
+
+    void assign(const char* data, size_t size) {
+        owned.assign(data, size);
+        pos = owned.data();
+        end = pos + size;
+    }
+};
+
+#if defined(SCANNER_AVX2)
+typedef __m256i Block;
+const int WIDTH = 32;
+inline Block load(const char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+inline Block splat(char c) { return _mm256_set1_epi8(c); }
+inline uint32_t maskOf(Block b) { return (uint32_t)_mm256_movemask_epi8(b); }
+inline Block eq(Block a, Block b) { return _mm256_cmpeq_epi8(a, b); }
+inline Block gt(Block a, Block b) { return _mm256_cmpgt_epi8(a, b); }
+inline Block either(Block a, Block b) { return _mm256_or_si256(a, b); }
+inline Block both(Block a, Block b) { return _mm256_and_si256(a, b); }
+#elif defined(SCANNER_SSE2)
+typedef __m128i Block;
+const int WIDTH = 16;
+inline Block load(const char* p) { return _mm_loadu_si128((const __m128i*)p); }
+inline Block splat(char c) { return _mm_set1_epi8(c); }
+inline uint32_t maskOf(Block b) { return (uint32_t)_mm_movemask_epi8(b); }
+inline Block eq(Block a, Block b) { return _mm_cmpeq_epi8(a, b); }
+inline Block gt(Block a, Block b) { return _mm_cmpgt_epi8(a, b); }
+inline Block either(Block a, Block b) { return _mm_or_si128(a, b); }
+inline Block both(Block a, Block b) { return _mm_and_si128(a, b); }
+#endif
+
+#ifdef WIDTH
+const uint32_t ALL = (uint32_t)(~0ull >> (64 - WIDTH));
+
+//octetii din [lo, hi]; comparatiile sunt cu semn, deci octetii >= 0x80 (negativi) nu intra niciodata
+inline Block inRange(Block b, char lo, char hi) { return both(gt(b, splat(lo - 1)), gt(splat(hi + 1), b)); }
+
+//liniile noi dintre inceputul blocului si pozitia k (k < WIDTH)
+inline int newlinesBefore(uint32_t newlines, uint32_t k) { return __builtin_popcount(newlines & ((1u << k) - 1)); }
+#endif
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isLetter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+inline bool isIdent(char c) { return isLetter(c) || isDigit(c) || c == '_'; }
+
+//[ \t\n\r]*; numara liniile trecute
+const char* skipSpace(const char* p, const char* end, int& line) {
+#ifdef WIDTH
+    while (end - p >= WIDTH) {
+        Block b = load(p);
+        uint32_t newlines = maskOf(eq(b, splat('\n')));
+        uint32_t space = newlines | maskOf(either(either(eq(b, splat(' ')), eq(b, splat('\t'))), eq(b, splat('\r'))));
+        uint32_t other = ~space & ALL;
+        if (other) {
+            uint32_t k = __builtin_ctz(other);
+            line += newlinesBefore(newlines, k);
+            return p + k;
+        }
+        line += __builtin_popcount(newlines);
+        p += WIDTH;
+    }
+#endif
+    for (; p < end && isSpace(*p); p++)
+        if (*p == '\n') line++;
+    return p;
+}
+
+//[a-zA-Z0-9_]*
+const char* skipIdent(const char* p, const char* end) {
+#ifdef WIDTH
+    while (end - p >= WIDTH) {
+        Block b = load(p);
+        Block lower = either(b, splat(0x20)); //litera mare -> mica; '_' | 0x20 e tot '_' (0x7f nu e litera)
+        Block ident = either(either(inRange(lower, 'a', 'z'), inRange(b, '0', '9')), eq(b, splat('_')));
+        uint32_t other = ~maskOf(ident) & ALL;
+        if (other) return p + __builtin_ctz(other);
+        p += WIDTH;
+    }
+#endif
+    while (p < end && isIdent(*p)) p++;
+    return p;
+}
+
+//[0-9]*
+const char* skipDigits(const char* p, const char* end) {
+#ifdef WIDTH
+    while (end - p >= WIDTH) {
+        uint32_t other = ~maskOf(inRange(load(p), '0', '9')) & ALL;
+        if (other) return p + __builtin_ctz(other);
+        p += WIDTH;
+    }
+#endif
+    while (p < end && isDigit(*p)) p++;
+    return p;
+}
+
+//prima aparitie a lui c (sau end); numara liniile de pana la ea
+const char* find(const char* p, const char* end, char c, int& line) {
+#ifdef WIDTH
+    while (end - p >= WIDTH) {
+        Block b = load(p);
+        uint32_t newlines = maskOf(eq(b, splat('\n')));
+        uint32_t found = maskOf(eq(b, splat(c)));
+        if (found) {
+            uint32_t k = __builtin_ctz(found);
+            line += newlinesBefore(newlines, k);
+            return p + k;
+        }
+        line += __builtin_popcount(newlines);
+        p += WIDTH;
+    }
+#endif
+    for (; p < end && *p != c; p++)
+        if (*p == '\n') line++;
+    return p;
+}
+
+//hash perfect peste cuvintele cheie din comp.l: (prima litera + ultima + 6 * lungime) & 63 nu are coliziuni
+struct Keyword {
+    const char* text;
+    int length;
+    int token;
+};
+
+const Keyword* keyword(const char* s, size_t n) {
+    static Keyword table[64];
+    static bool ready = [] {
+        static const Keyword all[] = {
+            { "int", 3, INT }, { "float", 5, FLOAT }, { "string", 6, STRING }, { "bool", 4, BOOL },
+            { "void", 4, VOID }, { "class", 5, CLASS }, { "main", 4, MAIN }, { "return", 6, RETURN },
+            { "if", 2, IF }, { "while", 5, WHILE }, { "print", 5, PRINT }, { "Print", 5, PRINT },
+            { "true", 4, TRUE }, { "false", 5, FALSE },
+        };
+        for (const Keyword& k : all)
+            table[((unsigned char)k.text[0] + (unsigned char)k.text[k.length - 1] + 6 * k.length) & 63] = k;
+        return true;
+    }();
+    (void)ready;
+    if (n > 6) return nullptr;
+    const Keyword& k = table[((unsigned char)s[0] + (unsigned char)s[n - 1] + 6 * n) & 63];
+    if (k.length == (int)n && std::memcmp(k.text, s, n) == 0) return &k;
+    return nullptr;
+}
+
+int scan(Scanner& s, YYSTYPE* lval) {
+    const char* end = s.end;
+    for (;;) {
+        const char* p = skipSpace(s.pos, end, s.line);
+        s.pos = p;
+        if (p == end) return 0;
+        char c = *p;
+
+        if (isLetter(c)) {
+            const char* q = skipIdent(p + 1, end);
+            s.pos = q;
+            if (const Keyword* k = keyword(p, q - p)) return k->token;
+            lval->Name = Interner::global().intern(p, q - p);
+            return ID;
+        }
+
+        if (isDigit(c)) {
+            const char* q = skipDigits(p + 1, end);
+            if (q + 1 < end && *q == '.' && isDigit(q[1])) {
+                q = skipDigits(q + 2, end);
+                double d = 0;
+                std::from_chars(p, q, d); //acelasi rezultat ca atof pe textul tokenului (rotunjire corecta)
+                lval->Float = d;
+                s.pos = q;
+                return FLOAT_LITERAL;
+            }
+            if (q - p <= 9) {
+                int v = 0;
+                for (const char* d = p; d < q; d++) v = v * 10 + (*d - '0');
+                lval->Int = v;
+            }
+            else lval->Int = std::atoi(std::string(p, q).c_str()); //depasirea se trateaza ca in comp.l
+            s.pos = q;
+            return INT_LITERAL;
+        }
+
+        if (c == '"') {
+            int line = s.line;
+            const char* q = find(p + 1, end, '"', line);
+            if (q == end) { //fara ghilimele de inchidere: ramane caracterul '"' singur, ca regula "." din comp.l
+                s.pos = p + 1;
+                return c;
+            }
+            s.line = line;
+            s.pos = q + 1;
+            lval->String = s.extra->arena.make<std::string>(p + 1, q - p - 1);
+            return STRING_LITERAL;
+        }
+
+        char n = p + 1 < end ? p[1] : 0;
+        if (c == '/' && n == '/') {
+            int ignored = 0;
+            s.pos = find(p + 2, end, '\n', ignored);
+            continue;
+        }
+        if (c == '/' && n == '*') {
+            const char* q = p + 2;
+            for (;;) {
+                q = find(q, end, '*', s.line);
+                if (q == end || (q + 1 < end && q[1] == '/')) break;
+                q++;
+            }
+            if (q == end) { //comentariu neinchis: se termina sursa
+                s.pos = end;
+                return 0;
+            }
+            s.pos = q + 2;
+            continue;
+        }
+
+        s.pos = p + 1;
+        switch (c) {
+        case '=': if (n == '=') { s.pos++; return EQ; } break;
+        case '!': if (n == '=') { s.pos++; return NEQ; } return NOT;
+        case '<': if (n == '=') { s.pos++; return LE; } break;
+        case '>': if (n == '=') { s.pos++; return GE; } break;
+        case '&': if (n == '&') { s.pos++; return AND; } break;
+        case '|': if (n == '|') { s.pos++; return OR; } break;
+        }
+        return c;
+    }
+}
+
+}
+
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+
+int yylex_init_extra(CompilationContext* extra, yyscan_t* scanner) {
+    Scanner* s = new Scanner;
+    s->extra = extra;
+    s->assign("", 0);
+    *scanner = s;
+    return 0;
+}
+
+int yylex_destroy(yyscan_t scanner) {
+    delete (Scanner*)scanner;
+    return 0;
+}
+
+//flex citeste din FILE* pe bucati; aici sursa se citeste toata de la inceput
+void yyset_in(FILE* in, yyscan_t scanner) {
+    std::string data;
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof buffer, in)) > 0) data.append(buffer, n);
+    ((Scanner*)scanner)->assign(data.data(), data.size());
+}
+
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int len, yyscan_t scanner) {
+    ((Scanner*)scanner)->assign(bytes, len);
+    return nullptr;
+}
+
+//ca la flex: ultimii doi octeti sunt terminatorii 0; continutul se citeste pe loc, fara copiere
+YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, yyscan_t scanner) {
+    Scanner* s = (Scanner*)scanner;
+    s->owned.clear();
+    s->pos = base;
+    s->end = base + size - 2;
+    return nullptr;
+}
+
+int yyget_lineno(yyscan_t scanner) {
+    return ((Scanner*)scanner)->line;
+}
+
+int yylex(YYSTYPE* lval, YYLTYPE* lloc, yyscan_t scanner) {
+    Scanner& s = *(Scanner*)scanner;
+    int token = scan(s, lval);
+    lloc->first_line = lloc->last_line = s.line; //ca YY_USER_ACTION: linia de dupa tokenul potrivit
+    if (token) STAT_INC(tokens);
+    return token;
+}
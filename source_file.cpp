@@ -0,0 +1,60 @@
+#include "source_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool MappedSource::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        lastError = std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        lastError = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        lastError = "nu este un fisier obisnuit";
+        ::close(fd);
+        return false;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (size_t)st.st_size;
+    size_t total = (size + 2 + page - 1) / page * page;
+
+    //rezervam intai o zona anonima (plina de 0) si mapam fisierul peste inceputul ei;
+    //asa terminatorii exista si cand fisierul se termina exact la granita unei pagini
+    void* region = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        lastError = std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (size > 0 && mmap(region, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        lastError = std::strerror(errno);
+        munmap(region, total);
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    madvise(region, total, MADV_SEQUENTIAL); //lexerul citeste o singura data, de la inceput la sfarsit
+    base = static_cast<char*>(region);
+    length = size;
+    mapped = total;
+    return true;
+}
+
+void MappedSource::close() {
+    if (base) munmap(base, mapped);
+    base = nullptr;
+    length = mapped = 0;
+}
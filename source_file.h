@@ -0,0 +1,36 @@
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <cstddef>
+#include <string>
+
+//fisier sursa mapat in memorie, pregatit pentru yy_scan_buffer: dupa continut urmeaza
+//doi octeti 0 (YY_END_OF_BUFFER_CHAR), fara nicio copiere a fisierului.
+//Maparea e privata si scriibila: flex scrie temporar un '\0' dupa yytext (copy-on-write).
+class MappedSource {
+    char* base = nullptr;
+    size_t length = 0;   //dimensiunea fisierului
+    size_t mapped = 0;   //dimensiunea maparii (pagini intregi, cu cel putin 2 octeti in plus)
+
+public:
+    MappedSource() {}
+    ~MappedSource() { close(); }
+    MappedSource(const MappedSource&) = delete;
+    MappedSource& operator=(const MappedSource&) = delete;
+
+    //false daca fisierul nu poate fi deschis sau mapat; error() spune de ce
+    bool open(const std::string& path);
+    void close();
+
+    char* data() const { return base; }
+    size_t size() const { return length; }
+    //dimensiunea de dat lui yy_scan_buffer (continut + cei doi terminatori)
+    size_t scanSize() const { return length + 2; }
+
+    const std::string& error() const { return lastError; }
+
+private:
+    std::string lastError;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+//statisticile modului --stats. Timpii si memoria pe faze se masoara mereu (cateva apeluri pe rulare);
+//contoarele de pe caile fierbinti sunt mereu compilate, dar fara --stats (Stats::current() == nullptr)
+//STAT_INC/STAT_ADD se reduc la un test de pointer nul, ca ProfileScope.
+struct Stats {
+    struct Phase {
+        std::string name;
+        double millis;
+        long peakRssKb; //varful RSS al procesului la sfarsitul fazei
+    };
+    std::vector<Phase> phases;
+
+    uint64_t tokens = 0;
+    uint64_t nodes = 0;
+    uint64_t inferTypeCalls = 0;
+    uint64_t lookups = 0;
+    uint64_t scopesWalked = 0;   //cate tabele au fost parcurse de lookup, in total
+    uint64_t stubReads = 0;
+    uint64_t stubWrites = 0;
+    uint64_t evalVisits = 0;
+
+    //statisticile compilarii care ruleaza pe thread-ul curent (ca Arena::current)
+    inline static thread_local Stats* active = nullptr;
+    static Stats* current() { return active; }
+
+    class Scope {
+        Stats* previous;
+    public:
+        explicit Scope(Stats* s) : previous(active) { active = s; }
+        ~Scope() { active = previous; }
+    };
+
+    static long peakRssKb() {
+        struct rusage usage;
+        return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+    }
+
+    void print(std::ostream& out) const {
+        out << "== stats ==\n";
+        double total = 0;
+        for (const auto& p : phases) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "  %-10s %10.3f ms   peak RSS %8ld KB\n", p.name.c_str(), p.millis, p.peakRssKb);
+            out << line;
+            total += p.millis;
+        }
+        char line[64];
+        std::snprintf(line, sizeof(line), "  %-10s %10.3f ms\n", "total", total);
+        out << line;
+        out << "  tokens          " << tokens << "\n"
+            << "  ast nodes       " << nodes << "\n"
+            << "  inferType       " << inferTypeCalls << "\n"
+            << "  lookups         " << lookups << " (scopes walked " << scopesWalked << ")\n"
+            << "  stub reads      " << stubReads << "\n"
+            << "  stub writes     " << stubWrites << "\n"
+            << "  eval visits     " << evalVisits << "\n";
+        out.flush();
+    }
+};
+
+//cronometreaza o faza si o adauga in stats la iesirea din bloc; nu face nimic cu stats == nullptr
+class PhaseTimer {
+    Stats* stats;
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    PhaseTimer(Stats* s, const char* n) : stats(s), name(n) {
+        if (stats) start = std::chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if (!stats) return;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        stats->phases.push_back({ name, ms, Stats::peakRssKb() });
+    }
+};
+
+#define STAT_ADD(field, n) \
+    do { \
+        if (Stats* stats_ = Stats::current(); __builtin_expect(stats_ != nullptr, 0)) stats_->field += (n); \
+    } while (0)
+#define STAT_INC(field) STAT_ADD(field, 1)
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SYMBOL_EXPORT_H
+#define SYMBOL_EXPORT_H
+
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include "symbol_table.h"
+
+//exportul tabelelor de simboluri ca JSON lines (--export-symbols): o linie per scope, scrisa
+//cand scope-ul se inchide, cu simbolurile in ordinea declararii. Fara flush pe linie.
+class JsonLinesExporter : public ScopeListener {
+    ostream& out;
+
+    static void str(ostream& o, const string& s) {
+        o << '"';
+        for (char c : s) {
+            switch (c) {
+                case '"': o << "\\\""; break;
+                case '\\': o << "\\\\"; break;
+                case '\n': o << "\\n"; break;
+                case '\t': o << "\\t"; break;
+                default:
+                    if ((unsigned char)c < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        o << buf;
+                    }
+                    else o << c;
+            }
+        }
+        o << '"';
+    }
+
+public:
+    explicit JsonLinesExporter(ostream& o) : out(o) {}
+
+    void scopeClosed(const SymbolTable& scope) override {
+        out << "{\"scope\":";
+        str(out, scope.getScopeName());
+        out << ",\"parent\":";
+        if (scope.getParent()) str(out, scope.getParent()->getScopeName());
+        else out << "null";
+        out << ",\"depth\":" << scope.getDepth() << ",\"slots\":" << scope.getSlotCount() << ",\"symbols\":[";
+
+        bool first = true;
+        for (const SymbolInfo& s : scope.getSymbols()) {
+            if (!first) out << ',';
+            first = false;
+            out << "{\"name\":";
+            str(out, s.name);
+            out << ",\"category\":";
+            str(out, s.category);
+            out << ",\"type\":";
+            str(out, s.type.typeToString());
+            out << ",\"size\":" << s.size << ",\"offset\":" << s.offset;
+            if (s.slot >= 0) out << ",\"slot\":" << s.slot;
+            if (!s.value.empty()) {
+                out << ",\"value\":";
+                str(out, s.value);
+            }
+            if (s.category == "function") {
+                out << ",\"params\":[";
+                for (size_t i = 0; i < s.paramTypes.size(); i++) {
+                    if (i) out << ',';
+                    str(out, typeToString(s.paramTypes[i]));
+                }
+                out << ']';
+            }
+            out << '}';
+        }
+        out << "]}\n";
+    }
+};
+
+#endif
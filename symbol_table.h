@@ -3,16 +3,19 @@
 
 #include <iostream>
 #include <string>
-#include <map>
 #include <vector>
 #include <fstream>
+#include <deque>
+#include <algorithm>
 #include "types.h"
+#include "interner.h"
+#include "stats.h"
 
 using namespace std;
 
-enum SymbolType { SYM_INT, SYM_FLOAT, SYM_STRING, SYM_BOOL, SYM_CHAR, SYM_VOID, SYM_CLASS, SYM_UNKNOWN };
+enum SymbolType { SYM_INT, SYM_FLOAT, SYM_STRING, SYM_BOOL, SYM_CHAR, SYM_VOID, SYM_CLASS, SYM_ARRAY, SYM_UNKNOWN };
 
-static string typeToString(SymbolType t) {
+inline string typeToString(SymbolType t) {
     switch(t) {
         case SYM_INT: return "int";
         case SYM_FLOAT: return "float";
@@ -20,16 +23,18 @@ static string typeToString(SymbolType t) {
         case SYM_BOOL: return "bool";
         case SYM_VOID: return "void";
         case SYM_CLASS: return "class";
+        case SYM_ARRAY: return "array";
         default: return "unknown";
     }
 }
 
-static int getTypeSize(SymbolType t) {
+inline int getTypeSize(SymbolType t) {
     switch(t) {
         case SYM_INT: return 4;
         case SYM_FLOAT: return 8;
         case SYM_BOOL: return 1;
         case SYM_STRING: return 256; 
+        case SYM_ARRAY: return 8; //referinta la elemente
         default: return 0;
     }
 }
@@ -37,92 +42,145 @@ static int getTypeSize(SymbolType t) {
 class SymbolInfo {
 public:
     string name; //id
+    int nameId; //id-ul numelui in Interner::global()
     TypeInfo type; //tip
     string category; //functie, clasa, varibila 
     string className; //nume clasa 
     string value; //valoare
     int size; int offset;
+    int depth; int slot; //adancimea scope-ului si indexul in cadrul de executie (doar variabile si parametri)
     vector<SymbolType> paramTypes; //(int, float, ...) 
+    vector<TypeInfo> paramInfo; //aceiasi parametri cu tipul complet (elementul tablourilor), pentru verificarea apelurilor
 
-    SymbolInfo() : size(0), offset(0) {}
-    SymbolInfo(string n, TypeInfo t, string cat) : name(n), type(t), category(cat) {
+    SymbolInfo() : nameId(-1), size(0), offset(0), depth(-1), slot(-1) {}
+    SymbolInfo(const string& n, const TypeInfo& t, const string& cat)
+        : name(n), nameId(Interner::global().intern(n)->id), type(t), category(cat), depth(-1), slot(-1) {
         SymbolType st = SYM_UNKNOWN;
         if(t.type == TYPE_INT) st = SYM_INT;
         else if(t.type == TYPE_FLOAT) st = SYM_FLOAT;
         else if(t.type == TYPE_BOOL) st = SYM_BOOL;
         else if(t.type == TYPE_STRING) st = SYM_STRING;
         else if(t.type == TYPE_CLASS) st = SYM_CLASS;
+        else if(t.type == TYPE_ARRAY) st = SYM_ARRAY;
         size = getTypeSize(st);
         offset = 0;
     }
 };
 //definierea unui singur scope - if, while
+//Simbolurile sunt indexate dupa id-ul internat al numelui, intr-o tabela cu adresare deschisa.
 class SymbolTable {
-    map<string, SymbolInfo> symbols; //{id, symbolInfo}
+    deque<SymbolInfo> symbols; //in ordinea declararii; deque pastreaza adresele valide
+    vector<int> index; //pozitii in symbols, -1 = liber; dimensiune putere a lui 2
     SymbolTable* parent; 
     string scopeName; //"global", "func_main", etc. cand apelez dumpAllScopes, acesta este inclus in tables.txt
     int currentMemoryOffset; 
+    int depth; //0 pentru global
+    int slotCount; //cate sloturi ocupa variabilele scope-ului in cadrul de executie
+
+    size_t probe(int nameId) const {
+        size_t mask = index.size() - 1;
+        size_t i = ((uint32_t)nameId * 2654435761u) & mask;
+        while (index[i] >= 0 && symbols[index[i]].nameId != nameId) i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow() {
+        vector<int> old(index.size() * 2, -1);
+        old.swap(index);
+        for (int e : old) if (e >= 0) index[probe(symbols[e].nameId)] = e;
+    }
+
 public:
 
-    SymbolTable(SymbolTable* p, string name) : parent(p), scopeName(name), currentMemoryOffset(0) {}
+    SymbolTable(SymbolTable* p, const string& name) : index(8, -1), parent(p), scopeName(name), currentMemoryOffset(0),
+        depth(p ? p->depth + 1 : 0), slotCount(0) {}
 
     bool addSymbol(SymbolInfo sym) {
-        if (symbols.count(sym.name)) return false;
+        size_t i = probe(sym.nameId);
+        if (index[i] >= 0) return false;
         sym.offset = currentMemoryOffset;
         currentMemoryOffset += sym.size;
-        symbols[sym.name] = sym;
+        if (sym.category == "variable" || sym.category == "parameter") {
+            sym.depth = depth;
+            sym.slot = slotCount++;
+        }
+        index[i] = (int)symbols.size();
+        symbols.push_back(std::move(sym));
+        if (symbols.size() * 2 > index.size()) grow();
         return true;
     }
 
     //actulizam semnatura functiei, adaugand tipurile parametrilor, pentru ca apoi sa comparam cu variabilele pasate la apel de functie 
-    bool updateFunctionParams(string name, vector<TypeInfo> params) {
-        if (symbols.count(name)) {
-            for(auto p : params) {
-                if(p.type == TYPE_INT) symbols[name].paramTypes.push_back(SYM_INT);
-                else if(p.type == TYPE_FLOAT) symbols[name].paramTypes.push_back(SYM_FLOAT);
-                else if(p.type == TYPE_BOOL) symbols[name].paramTypes.push_back(SYM_BOOL);
-                else if(p.type == TYPE_STRING) symbols[name].paramTypes.push_back(SYM_STRING);
+    bool updateFunctionParams(const string& name, const vector<TypeInfo>& params) {
+        SymbolInfo* s = lookupCurrent(name);
+        if (s) {
+            for(const auto& p : params) {
+                s->paramInfo.push_back(p);
+                if(p.type == TYPE_INT) s->paramTypes.push_back(SYM_INT);
+                else if(p.type == TYPE_FLOAT) s->paramTypes.push_back(SYM_FLOAT);
+                else if(p.type == TYPE_BOOL) s->paramTypes.push_back(SYM_BOOL);
+                else if(p.type == TYPE_STRING) s->paramTypes.push_back(SYM_STRING);
+                else if(p.type == TYPE_ARRAY) s->paramTypes.push_back(SYM_ARRAY);
             }
             return true;
         }
         return false;
     }
 
-    string getScopeName() { return scopeName; }
+    const string& getScopeName() const { return scopeName; }
+    int getDepth() const { return depth; }
+    int getSlotCount() const { return slotCount; }
     
     //ne uitam daca exista variabila
-    SymbolInfo* lookup(string name) {
-        if (symbols.count(name)) return &symbols[name];
-        return parent ? parent->lookup(name) : NULL;
+    SymbolInfo* lookup(int nameId) {
+        STAT_INC(lookups);
+        for (SymbolTable* t = this; t; t = t->parent) {
+            STAT_INC(scopesWalked);
+            if (SymbolInfo* s = t->lookupCurrent(nameId)) return s;
+        }
+        return NULL;
     }
 
-    SymbolInfo* lookupCurrent(string name) {
-        return symbols.count(name) ? &symbols[name] : NULL;
+    SymbolInfo* lookupCurrent(int nameId) {
+        if (nameId < 0) return NULL;
+        int e = index[probe(nameId)];
+        return e >= 0 ? &symbols[e] : NULL;
     }
 
+    SymbolInfo* lookup(const string& name) { return lookup(Interner::global().find(name)); }
+    SymbolInfo* lookupCurrent(const string& name) { return lookupCurrent(Interner::global().find(name)); }
+
     SymbolTable* getParent() { 
         return parent; 
     }
+    const SymbolTable* getParent() const { return parent; }
+    const deque<SymbolInfo>& getSymbols() const { return symbols; }
+
     //inregistram stats despre scope-ul la care ne aflam
-    void dump(ofstream& out) {
-        if (!out.is_open()) return;
+    void dump(ostream& out) {
+        if (!out) return;
 
-        out << "\n=== Scope: " << scopeName << " ===" << endl;
+        out << "\n=== Scope: " << scopeName << " ===\n";
     
         if (parent != nullptr) 
-            out << "Parinte: " << parent->getScopeName() << endl;
+            out << "Parinte: " << parent->getScopeName() << "\n";
         else 
-            out << "Parinte: Global" << endl;
+            out << "Parinte: Global\n";
 
-        out << "Simboluri:" << endl;
+        out << "Simboluri:\n";
 
         if (symbols.empty()) {
-            out << "  (gol)" << endl;
+            out << "  (gol)\n";
             return;
         }
 
-        for (auto& entry : symbols) {
-            SymbolInfo& s = entry.second; 
+        //ordinea alfabetica, ca sa nu depinda de ordinea declararii
+        vector<const SymbolInfo*> sorted;
+        for (const auto& sym : symbols) sorted.push_back(&sym);
+        sort(sorted.begin(), sorted.end(), [](const SymbolInfo* a, const SymbolInfo* b) { return a->name < b->name; });
+
+        for (const SymbolInfo* sp : sorted) {
+            const SymbolInfo& s = *sp; 
             out << "  " << s.name << " : " << s.type.typeToString();
             out << " [" << s.category << "]";
 
@@ -133,16 +191,25 @@ public:
                 out << " (argumente: " << s.paramTypes.size() << ")";
             }
         
-            out << endl;
+            out << "\n";
         }
     }
 };
 
+//primeste fiecare scope in momentul in care se inchide (exportul structurat al tabelelor)
+class ScopeListener {
+public:
+    virtual ~ScopeListener() {}
+    virtual void scopeClosed(const SymbolTable& scope) = 0;
+};
+
 class ScopeManager {
 public:
+    ScopeListener* listener = NULL; //optional; vezi closeGlobal pentru scope-ul global
+
     SymbolTable *currentScope, *globalScope;
 
-    map<string, SymbolTable*> classScopes;
+    vector<SymbolTable*> classScopes; //indexat dupa id-ul internat al numelui clasei
 
     vector<SymbolTable*> allScopes;
     
@@ -157,27 +224,59 @@ public:
         for(auto s : allScopes) delete s;
     }
     
-    void enterScope(string name) { 
+    void enterScope(const string& name) { 
         currentScope = new SymbolTable(currentScope, name); 
         allScopes.push_back(currentScope);
     }
 
     void exitScope() { 
-        if(currentScope->getParent()) currentScope = currentScope->getParent(); 
+        if(currentScope->getParent()) {
+            if (listener) listener->scopeClosed(*currentScope);
+            currentScope = currentScope->getParent(); 
+        }
+    }
+
+    //scope-ul global se inchide la sfarsitul programului
+    void closeGlobal() {
+        if (listener) listener->scopeClosed(*globalScope);
+    }
+
+    void saveClassScope(int classId) { 
+        if ((int)classScopes.size() <= classId) classScopes.resize(classId + 1, NULL);
+        classScopes[classId] = currentScope; 
+    }
+
+    SymbolTable* classScope(int classId) {
+        return classId >= 0 && classId < (int)classScopes.size() ? classScopes[classId] : NULL;
     }
+    SymbolTable* classScope(const string& className) { return classScope(Interner::global().find(className)); }
 
-    void saveClassScope(string className) { 
-        classScopes[className] = currentScope; 
+    bool isClass(int classId) { return classScope(classId) != NULL; }
+
+    //id-ul clasei al carei scope este scope ("class_" + nume, vezi class_def), sau -1
+    int classIdOf(const SymbolTable* scope) {
+        if (!scope || scope->getScopeName().compare(0, 6, "class_") != 0) return -1;
+        int id = Interner::global().find(scope->getScopeName().substr(6));
+        return classScope(id) == scope ? id : -1;
     }
+
     //cauta daca avem o clasa definita cu numele clasei date. daca da, cautam membrul dorit
-    SymbolInfo* lookupInClass(string className, string memberName) { 
-        return classScopes.count(className) ? classScopes[className]->lookupCurrent(memberName) : NULL; 
+    SymbolInfo* lookupInClass(int classId, int memberId) { 
+        SymbolTable* c = classScope(classId);
+        return c ? c->lookupCurrent(memberId) : NULL; 
+    }
+    SymbolInfo* lookupInClass(const string& className, int memberId) { 
+        return lookupInClass(Interner::global().find(className), memberId); 
+    }
+
+    void dumpAllScopes(ostream& out) {
+        for(auto s : allScopes) s->dump(out);
     }
 
     void dumpAllScopes(const string& filename) {
         ofstream out(filename);
         if(!out.is_open()) return;
-        for(auto s : allScopes) s->dump(out);
+        dumpAllScopes(out);
         out.close();
         cout << "[Info] tabel simbol a fost aruncat in " << filename << endl;
     }
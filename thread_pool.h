@@ -0,0 +1,70 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//pool de thread-uri cu furt de lucru, pentru loturi de sarcini cunoscute dinainte.
+//Fiecare worker are coada lui: ia de la capatul propriu, iar cand ramane fara
+//lucru fura de la inceputul cozii altui worker.
+class WorkStealingPool {
+    struct Queue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<Queue> queues;
+    size_t next = 0;
+
+    bool popLocal(size_t w, std::function<void()>& task) {
+        Queue& q = queues[w];
+        std::lock_guard<std::mutex> lock(q.m);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t w, std::function<void()>& task) {
+        for (size_t k = 1; k < queues.size(); k++) {
+            Queue& q = queues[(w + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.m);
+            if (q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t w) {
+        std::function<void()> task;
+        //sarcinile nu creeaza alte sarcini, deci cand toate cozile sunt goale am terminat
+        while (popLocal(w, task) || steal(w, task)) task();
+    }
+
+public:
+    explicit WorkStealingPool(unsigned workers)
+        : queues(workers ? workers : 1) {}
+
+    size_t size() const { return queues.size(); }
+
+    //imparte sarcinile round-robin; inainte de run(), nu e nevoie de blocare
+    void submit(std::function<void()> task) {
+        queues[next].tasks.push_back(std::move(task));
+        next = (next + 1) % queues.size();
+    }
+
+    //ruleaza toate sarcinile si asteapta terminarea lor; threadul apelant e workerul 0
+    void run() {
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < queues.size(); w++) threads.emplace_back(&WorkStealingPool::work, this, w);
+        work(0);
+        for (auto& t : threads) t.join();
+    }
+};
+
+#endif
@@ -10,6 +10,7 @@ enum TipBaza {
     TYPE_BOOL,
     TYPE_VOID,
     TYPE_CLASS,    
+    TYPE_ARRAY,    //int[], float[], bool[]: tipul elementelor e in element
     TYPE_UNKNOWN
 };
 
@@ -17,14 +18,22 @@ enum TipBaza {
 struct TypeInfo {
     TipBaza type;
     std::string className;
+    TipBaza element; //doar TYPE_ARRAY
 
-    TypeInfo(TipBaza t) : type(t), className("") {}
-    TypeInfo(std::string name) : type(TYPE_CLASS), className(name) {}
-    TypeInfo() : type(TYPE_UNKNOWN), className("") {}
+    TypeInfo(TipBaza t) : type(t), className(""), element(TYPE_UNKNOWN) {}
+    TypeInfo(std::string name) : type(TYPE_CLASS), className(name), element(TYPE_UNKNOWN) {}
+    TypeInfo() : type(TYPE_UNKNOWN), className(""), element(TYPE_UNKNOWN) {}
+
+    static TypeInfo arrayOf(TipBaza elem) {
+        TypeInfo t(TYPE_ARRAY);
+        t.element = elem;
+        return t;
+    }
 
     bool operator==(const TypeInfo& other) const {
         if (type != other.type) return false;
         if (type == TYPE_CLASS) return className == other.className;
+        if (type == TYPE_ARRAY) return element == other.element;
         return true;
     }
     bool operator!=(const TypeInfo& other) const {
@@ -38,6 +47,7 @@ struct TypeInfo {
             case TYPE_BOOL: return "bool";
             case TYPE_VOID: return "void";
             case TYPE_CLASS: return "class " + className;
+            case TYPE_ARRAY: return TypeInfo(element).typeToString() + "[]";
             default: return "unknown";
         }
     }
@@ -1,65 +1,81 @@
 #include "value.h"
-#include <sstream>
+#include "object.h"
+#include "array.h"
+#include <charconv>
+#include <cstring>
 
-Value::Value() {
-    type = VAL_VOID;
-    i = 0;
-    f = 0.0f;
-    b = false;
-    s = "";
-    hasReturn = false;
-}
+size_t Value::formatScalar(char* buf) const {
+    char* end = buf + FORMAT_CHARS;
+    switch (type) {
+        case VAL_INT:
+            return std::to_chars(buf, end, i).ptr - buf;
 
-Value::Value(int v) {
-    type = VAL_INT;
-    i = v;
-    f = 0.0f;
-    b = false;
-    s = "";
-    hasReturn = false;
-}
+        case VAL_FLOAT:
+            //ca ostream << float: %g cu 6 cifre semnificative
+            return std::to_chars(buf, end, f, std::chars_format::general, 6).ptr - buf;
 
-Value::Value(float v) {
-    type = VAL_FLOAT;
-    f = v;
-    i = 0;
-    b = false;
-    s = "";
-    hasReturn = false;
-}
+        case VAL_BOOL:
+            std::memcpy(buf, b ? "true" : "false", b ? 4 : 5);
+            return b ? 4 : 5;
 
-Value::Value(bool v) {
-    type = VAL_BOOL;
-    b = v;
-    i = 0;
-    f = 0.0f;
-    s = "";
-    hasReturn = false;
-}
+        case VAL_VOID:
+            std::memcpy(buf, "void", 4);
+            return 4;
 
-Value::Value(const std::string& v) {
-    type = VAL_STRING;
-    s = v;
-    i = 0;
-    f = 0.0f;
-    b = false;
-    hasReturn = false;
+        case VAL_OBJECT:
+            std::memcpy(buf, "object", 6);
+            return 6;
+
+        default:
+            return 0;
+    }
 }
 
-std::string Value::toString() const {
-    if (type == VAL_INT) return std::to_string(i);
+Value Value::concat(const Value& a, const Value& b) {
+    std::string_view left = a.s(), right = b.s();
+    size_t total = left.size() + right.size();
 
-    if (type == VAL_FLOAT) {
-        std::ostringstream oss;
-        oss << f;
-        return oss.str();
-    }
+    Value result;
+    result.type = VAL_STRING;
+    result.len = (uint32_t)total;
 
-    if (type == VAL_BOOL) return b ? "true" : "false";
+    if (total <= SMALL_CHARS) {
+        std::memcpy(result.small, left.data(), left.size());
+        std::memcpy(result.small + left.size(), right.data(), right.size());
+    }
+    else if (a.isHeapString() && a.len == a.str->data.size()) {
+        //a e cea mai lunga vedere a bufferului: adaugam in loc; vederile existente (mai scurte) raman neschimbate
+        StringObj* buf = a.str;
+        if (b.isHeapString() && b.str == buf) buf->data.append(std::string(right)); //b e in acelasi buffer
+        else buf->data.append(right.data(), right.size());
+        buf->refs++;
+        result.str = buf;
+    }
+    else {
+        std::string data;
+        data.reserve(total + total / 2); //loc pentru urmatoarele concatenari
+        data.append(left.data(), left.size());
+        data.append(right.data(), right.size());
+        result.str = new StringObj(std::move(data));
+    }
+    return result;
+}
 
-    if (type == VAL_STRING) return s;
+std::string Value::toString() const {
+    if (type == VAL_STRING) return std::string(s());
 
-    if (type == VAL_VOID) return "void";
+    char buf[FORMAT_CHARS];
+    if (type == VAL_ARRAY) {
+        std::string text = "[";
+        for (int k = 0; k < arr->length; k++) {
+            if (k) text += ", ";
+            text.append(buf, arrayElement(arr, k).formatScalar(buf));
+        }
+        return text + "]";
+    }
+    return std::string(buf, formatScalar(buf));
+}
 
-    return "";
+void releaseObject(Object* o) {
+    o->pool->recycle(o);
 }
@@ -2,33 +2,174 @@
 #define VALUE_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
 
-enum ValueType {
+enum ValueType : uint8_t {
     VAL_INT,
     VAL_FLOAT,
     VAL_BOOL,
     VAL_STRING,
-    VAL_VOID
+    VAL_VOID,
+    VAL_OBJECT,
+    VAL_ARRAY
 };
 
+//bufferul unui sir lung, partajat prin numarare de referinte. Continutul existent nu se modifica
+//niciodata; un sir e o vedere (buffer, lungime), iar concatenarea poate doar adauga la final.
+struct StringObj {
+    int refs;
+    std::string data;
+
+    explicit StringObj(std::string_view s) : refs(1), data(s) {}
+    explicit StringObj(std::string&& s) : refs(1), data(std::move(s)) {}
+};
+
+class Value;
+class ObjectPool;
+
+//instanta unei clase: antetul e urmat direct de campuri, in ordinea sloturilor din scope-ul clasei
+//(fixate la parsare in SymbolInfo), deci un acces a.x e fields()[slot]. Memoria vine din ObjectPool (object.h).
+struct Object {
+    int refs;
+    ObjectPool* pool;
+
+    Value* fields() { return reinterpret_cast<Value*>(this + 1); }
+};
+
+//ultima referinta a disparut: campurile se distrug, iar inregistrarea se intoarce in pool
+void releaseObject(Object* o);
+
+//tablou int[], float[] sau bool[]: antetul e urmat direct de elemente, contigue si fara etichete
+//(int, float, respectiv un octet per bool), aliniate la 32 de octeti pentru nucleele SIMD din array.cpp.
+//Lungimea se fixeaza la creare. Operatiile sunt in array.h.
+struct alignas(32) Array {
+    int refs;
+    ValueType elem;
+    int length;
+
+    int* ints() { return reinterpret_cast<int*>(this + 1); }
+    float* floats() { return reinterpret_cast<float*>(this + 1); }
+    bool* bools() { return reinterpret_cast<bool*>(this + 1); }
+};
+
+void releaseArray(Array* a);
+
+//valoare etichetata de 16 octeti: tag + lungime + union. Copierea unui scalar nu atinge heap-ul.
+//Sirurile de cel mult SMALL_CHARS caractere stau direct in valoare; cele lungi sunt vederi
+//imutabile (StringObj*, len) asupra unui buffer partajat. Obiectele si tablourile sunt referinte numarate.
 class Value {
 public:
+    static const uint32_t SMALL_CHARS = 8;
+
     ValueType type;
+    uint32_t len; //lungimea sirului (doar VAL_STRING)
+    union {
+        int i;
+        float f;
+        bool b;
+        StringObj* str;              //len > SMALL_CHARS
+        Object* obj;                 //VAL_OBJECT
+        Array* arr;                  //VAL_ARRAY
+        char small[SMALL_CHARS];     //len <= SMALL_CHARS
+    };
+
+    Value() : type(VAL_VOID), len(0), str(nullptr) {}
+    Value(int v) : type(VAL_INT), len(0), str(nullptr) { i = v; }
+    Value(float v) : type(VAL_FLOAT), len(0), str(nullptr) { f = v; }
+    Value(bool v) : type(VAL_BOOL), len(0), str(nullptr) { b = v; }
+    Value(std::string_view v) : type(VAL_STRING), len((uint32_t)v.size()), str(nullptr) {
+        if (isSmall()) std::memcpy(small, v.data(), len);
+        else str = new StringObj(v);
+    }
+    Value(const std::string& v) : Value(std::string_view(v)) {}
+    Value(const char* v) : Value(std::string_view(v)) {}
+    Value(std::string&& v) : type(VAL_STRING), len((uint32_t)v.size()), str(nullptr) {
+        if (isSmall()) std::memcpy(small, v.data(), len);
+        else str = new StringObj(std::move(v));
+    }
+
+    explicit Value(Object* o) : type(VAL_OBJECT), len(0), str(nullptr) {
+        obj = o;
+        o->refs++;
+    }
+    explicit Value(Array* a) : type(VAL_ARRAY), len(0), str(nullptr) {
+        arr = a;
+        a->refs++;
+    }
 
-    int i;
-    float f;
-    bool b;
-    std::string s;
+    Value(const Value& o) : type(o.type), len(o.len), str(o.str) {
+        retain();
+    }
+    Value(Value&& o) noexcept : type(o.type), len(o.len), str(o.str) {
+        o.type = VAL_VOID;
+        o.str = nullptr;
+    }
+    Value& operator=(const Value& o) {
+        //o poate fi un camp al obiectului eliberat aici (n = n.next): se copiaza inainte de release
+        o.retain();
+        ValueType t = o.type;
+        uint32_t l = o.len;
+        StringObj* p = o.str;
+        release();
+        type = t;
+        len = l;
+        str = p;
+        return *this;
+    }
+    Value& operator=(Value&& o) noexcept {
+        if (this != &o) {
+            ValueType t = o.type;
+            uint32_t l = o.len;
+            StringObj* p = o.str;
+            o.type = VAL_VOID;
+            o.str = nullptr;
+            release();
+            type = t;
+            len = l;
+            str = p;
+        }
+        return *this;
+    }
+    ~Value() { release(); }
 
-    bool hasReturn; 
+    std::string_view s() const {
+        if (type != VAL_STRING) return std::string_view();
+        return std::string_view(isSmall() ? small : str->data.data(), len);
+    }
 
-    Value();
-    Value(int v);
-    Value(float v);
-    Value(bool v);
-    Value(const std::string& v);
+    //a + b pentru siruri. Daca a se termina exact la capatul bufferului sau (nimeni n-a adaugat dupa el),
+    //b se adauga in acelasi buffer, cu crestere geometrica: `s = s + "x"` intr-o bucla e liniar amortizat.
+    static Value concat(const Value& a, const Value& b);
 
     std::string toString() const;
+
+    //formatul lui toString pentru valorile scalare, scris direct in buf (minim FORMAT_CHARS octeti),
+    //fara alocari; intoarce lungimea. Pentru siruri nu scrie nimic (se copiaza direct din s()), iar pentru
+    //tablouri nici atat: toString le da ca [e0, e1, ...].
+    static const size_t FORMAT_CHARS = 48;
+    size_t formatScalar(char* buf) const;
+
+private:
+    bool isSmall() const { return len <= SMALL_CHARS; }
+    bool isHeapString() const { return type == VAL_STRING && !isSmall(); }
+
+    void retain() const {
+        if (isHeapString()) str->refs++;
+        else if (type == VAL_OBJECT) obj->refs++;
+        else if (type == VAL_ARRAY) arr->refs++;
+    }
+
+    void release() {
+        if (isHeapString()) {
+            if (--str->refs == 0) delete str;
+        }
+        else if (type == VAL_OBJECT && --obj->refs == 0) releaseObject(obj);
+        else if (type == VAL_ARRAY && --arr->refs == 0) releaseArray(arr);
+    }
 };
 
+static_assert(sizeof(Value) <= 16, "Value trebuie sa ramana compact");
+
 #endif
@@ -0,0 +1,445 @@
+#include "vm.h"
+#include "SymTableStub.h"
+#include "object.h"
+#include "array.h"
+#include <iostream>
+
+//pe GCC/Clang folosim computed goto (un salt indirect per instructiune), altfel un switch clasic
+#if defined(__GNUC__) && !defined(VM_NO_COMPUTED_GOTO)
+#define VM_COMPUTED_GOTO 1
+#endif
+
+bool VM::run(const Chunk& chunk, OutputSink& out) {
+    OutputSink::Scope outScope(&out);
+    globals.assign(chunk.globalCount, Value());
+    stack.assign(chunk.localCount, Value());
+    stack.reserve(chunk.localCount + 256);
+    calls.clear();
+    calls.reserve(MAX_CALL_DEPTH);
+    Value* gp = globals.data();
+    size_t fp = 0;          //baza cadrului curent
+    Value* rp = nullptr;    //campurile obiectului metodei curente
+    int depth = 0;          //apelurile active (fara initializarile de obiecte)
+    const FunctionInfo* functions = chunk.functions.data();
+    const ClassInfo* classes = chunk.classes.data();
+    std::vector<ObjectPool*> pools;
+    for (const ClassInfo& c : chunk.classes) pools.push_back(&ObjectPool::forFields(c.fields));
+
+    const Instruction* code = chunk.code.data();
+    const Instruction* ip = code;
+    const Value* constants = chunk.constants.data();
+
+#define TOP() (stack.back())
+#define POP() (stack.pop_back())
+#define BINARY_PROLOGUE() \
+    Value r = std::move(stack.back()); stack.pop_back(); \
+    Value& l = stack.back();
+//operatiile tipizate lucreaza direct pe union, fara sa construiasca o valoare noua;
+//operanzii de alt tip decat cel static (return-ul nu e verificat) dau void, ca in arbore; un drept void e 0
+#define TYPED_OPERANDS(tag, field) \
+    bool typed = stack.back().type == tag || stack.back().type == VAL_VOID; \
+    auto rv = stack.back().field; stack.pop_back(); \
+    Value& l = stack.back(); \
+    typed = typed && l.type == tag;
+#define TYPED_ARITH(name, tag, field, expr) \
+    CASE(name) { \
+        TYPED_OPERANDS(tag, field) \
+        if (typed) l.field = l.field expr rv; \
+        else l = Value(); \
+        NEXT(); \
+    }
+#define TYPED_COMPARE(name, tag, field, expr) \
+    CASE(name) { \
+        TYPED_OPERANDS(tag, field) \
+        if (typed) { \
+            bool res = l.field expr rv; \
+            l.type = VAL_BOOL; l.b = res; \
+        } \
+        else l = Value(); \
+        NEXT(); \
+    }
+
+#ifdef VM_COMPUTED_GOTO
+    static void* labels[OP_COUNT] = {
+        &&L_OP_CONST, &&L_OP_LOAD_GLOBAL, &&L_OP_STORE_GLOBAL, &&L_OP_LOAD_LOCAL, &&L_OP_STORE_LOCAL,
+        &&L_OP_LOAD_FIELD, &&L_OP_STORE_FIELD, &&L_OP_GET_FIELD, &&L_OP_SET_FIELD, &&L_OP_POP,
+        &&L_OP_ADD, &&L_OP_SUB, &&L_OP_MUL, &&L_OP_DIV,
+        &&L_OP_LT, &&L_OP_GT, &&L_OP_LE, &&L_OP_GE, &&L_OP_EQ, &&L_OP_NE,
+        &&L_OP_ADD_I, &&L_OP_SUB_I, &&L_OP_MUL_I, &&L_OP_DIV_I,
+        &&L_OP_LT_I, &&L_OP_GT_I, &&L_OP_LE_I, &&L_OP_GE_I, &&L_OP_EQ_I, &&L_OP_NE_I,
+        &&L_OP_ADD_F, &&L_OP_SUB_F, &&L_OP_MUL_F, &&L_OP_DIV_F,
+        &&L_OP_LT_F, &&L_OP_GT_F, &&L_OP_LE_F, &&L_OP_GE_F, &&L_OP_EQ_F, &&L_OP_NE_F,
+        &&L_OP_CONCAT, &&L_OP_EQ_S, &&L_OP_NE_S,
+        &&L_OP_EQ_B, &&L_OP_NE_B,
+        &&L_OP_NOT, &&L_OP_AND_JUMP, &&L_OP_OR_JUMP, &&L_OP_TO_BOOL,
+        &&L_OP_JUMP, &&L_OP_JUMP_IF_FALSE, &&L_OP_PRINT,
+        &&L_OP_CALL, &&L_OP_CALL_METHOD, &&L_OP_NEW,
+        &&L_OP_NEW_ARRAY, &&L_OP_ARRAY_LITERAL, &&L_OP_INDEX, &&L_OP_INDEX_UNCHECKED, &&L_OP_SET_INDEX,
+        &&L_OP_SET_INDEX_UNCHECKED, &&L_OP_ARRAY_LEN, &&L_OP_ARRAY_REDUCE, &&L_OP_ARRAY_ARITH,
+        &&L_OP_RETURN, &&L_OP_HALT
+    };
+#define DISPATCH() goto *labels[ip->op]
+#define CASE(name) L_##name:
+    DISPATCH();
+#else
+#define DISPATCH() goto dispatch
+#define CASE(name) case name:
+dispatch:
+    switch (ip->op) {
+#endif
+#define NEXT() do { ++ip; DISPATCH(); } while (0)
+#define JUMP(target) do { ip = code + (target); DISPATCH(); } while (0)
+
+    CASE(OP_CONST) {
+        stack.push_back(constants[ip->arg]);
+        NEXT();
+    }
+    CASE(OP_LOAD_GLOBAL) {
+        stack.push_back(gp[ip->arg]);
+        NEXT();
+    }
+    CASE(OP_STORE_GLOBAL) {
+        gp[ip->arg] = TOP();
+        NEXT();
+    }
+    CASE(OP_LOAD_LOCAL) {
+        stack.push_back(stack[fp + ip->arg]);
+        NEXT();
+    }
+    CASE(OP_STORE_LOCAL) {
+        stack[fp + ip->arg] = TOP();
+        NEXT();
+    }
+    CASE(OP_LOAD_FIELD) {
+        stack.push_back(rp[ip->arg]);
+        NEXT();
+    }
+    CASE(OP_STORE_FIELD) {
+        rp[ip->arg] = TOP();
+        NEXT();
+    }
+    CASE(OP_GET_FIELD) {
+        Value& o = TOP();
+        if (o.type == VAL_OBJECT) o = o.obj->fields()[ip->arg];
+        else o = Value();
+        NEXT();
+    }
+    CASE(OP_SET_FIELD) {
+        Value v = std::move(stack.back());
+        POP();
+        Value& o = TOP();
+        if (o.type == VAL_OBJECT) o.obj->fields()[ip->arg] = v;
+        o = std::move(v);
+        NEXT();
+    }
+    CASE(OP_POP) {
+        POP();
+        NEXT();
+    }
+    CASE(OP_ADD) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i + r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f + r.f);
+        else if (l.type == VAL_STRING) l = Value::concat(l, r);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_SUB) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i - r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f - r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_MUL) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i * r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f * r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_DIV) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT && r.i != 0) l = Value(l.i / r.i);
+        else if (l.type == VAL_FLOAT && r.f != 0.0f) l = Value(l.f / r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_LT) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i < r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f < r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_GT) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i > r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f > r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_LE) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i <= r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f <= r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_GE) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i >= r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f >= r.f);
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_EQ) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i == r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f == r.f);
+        else if (l.type == VAL_BOOL) l = Value(l.b == r.b);
+        else if (l.type == VAL_STRING) l = Value(l.s() == r.s());
+        else l = Value();
+        NEXT();
+    }
+    CASE(OP_NE) {
+        BINARY_PROLOGUE();
+        if (l.type == VAL_INT) l = Value(l.i != r.i);
+        else if (l.type == VAL_FLOAT) l = Value(l.f != r.f);
+        else if (l.type == VAL_BOOL) l = Value(l.b != r.b);
+        else if (l.type == VAL_STRING) l = Value(l.s() != r.s());
+        else l = Value();
+        NEXT();
+    }
+    TYPED_ARITH(OP_ADD_I, VAL_INT, i, +)
+    TYPED_ARITH(OP_SUB_I, VAL_INT, i, -)
+    TYPED_ARITH(OP_MUL_I, VAL_INT, i, *)
+    CASE(OP_DIV_I) {
+        TYPED_OPERANDS(VAL_INT, i)
+        if (rv == 0 || !typed) l = Value();
+        else l.i = l.i / rv;
+        NEXT();
+    }
+    TYPED_COMPARE(OP_LT_I, VAL_INT, i, <)
+    TYPED_COMPARE(OP_GT_I, VAL_INT, i, >)
+    TYPED_COMPARE(OP_LE_I, VAL_INT, i, <=)
+    TYPED_COMPARE(OP_GE_I, VAL_INT, i, >=)
+    TYPED_COMPARE(OP_EQ_I, VAL_INT, i, ==)
+    TYPED_COMPARE(OP_NE_I, VAL_INT, i, !=)
+    TYPED_ARITH(OP_ADD_F, VAL_FLOAT, f, +)
+    TYPED_ARITH(OP_SUB_F, VAL_FLOAT, f, -)
+    TYPED_ARITH(OP_MUL_F, VAL_FLOAT, f, *)
+    CASE(OP_DIV_F) {
+        TYPED_OPERANDS(VAL_FLOAT, f)
+        if (rv == 0.0f || !typed) l = Value();
+        else l.f = l.f / rv;
+        NEXT();
+    }
+    TYPED_COMPARE(OP_LT_F, VAL_FLOAT, f, <)
+    TYPED_COMPARE(OP_GT_F, VAL_FLOAT, f, >)
+    TYPED_COMPARE(OP_LE_F, VAL_FLOAT, f, <=)
+    TYPED_COMPARE(OP_GE_F, VAL_FLOAT, f, >=)
+    TYPED_COMPARE(OP_EQ_F, VAL_FLOAT, f, ==)
+    TYPED_COMPARE(OP_NE_F, VAL_FLOAT, f, !=)
+    CASE(OP_CONCAT) {
+        BINARY_PROLOGUE();
+        l = Value::concat(l, r);
+        NEXT();
+    }
+    CASE(OP_EQ_S) {
+        BINARY_PROLOGUE();
+        l = Value(l.s() == r.s());
+        NEXT();
+    }
+    CASE(OP_NE_S) {
+        BINARY_PROLOGUE();
+        l = Value(l.s() != r.s());
+        NEXT();
+    }
+    TYPED_COMPARE(OP_EQ_B, VAL_BOOL, b, ==)
+    TYPED_COMPARE(OP_NE_B, VAL_BOOL, b, !=)
+    CASE(OP_NOT) {
+        Value& v = TOP();
+        if (v.type == VAL_BOOL) v = Value(!v.b);
+        else v = Value();
+        NEXT();
+    }
+    CASE(OP_AND_JUMP) {
+        Value& l = TOP();
+        if (l.type != VAL_BOOL) { l = Value(); JUMP(ip->arg); }
+        if (!l.b) JUMP(ip->arg);
+        POP();
+        NEXT();
+    }
+    CASE(OP_OR_JUMP) {
+        Value& l = TOP();
+        if (l.type != VAL_BOOL) { l = Value(); JUMP(ip->arg); }
+        if (l.b) JUMP(ip->arg);
+        POP();
+        NEXT();
+    }
+    CASE(OP_TO_BOOL) {
+        Value& v = TOP();
+        v = Value(v.type == VAL_BOOL && v.b);
+        NEXT();
+    }
+    CASE(OP_JUMP) {
+        JUMP(ip->arg);
+    }
+    CASE(OP_JUMP_IF_FALSE) {
+        bool taken = !(TOP().type == VAL_BOOL && TOP().b);
+        POP();
+        if (taken) JUMP(ip->arg);
+        NEXT();
+    }
+    CASE(OP_PRINT) {
+        out.printLine(TOP());
+        POP();
+        NEXT();
+    }
+    CASE(OP_CALL) {
+        const FunctionInfo& f = functions[ip->arg];
+        if (depth >= MAX_CALL_DEPTH) { reportCallDepth(f.name); return false; }
+        depth++;
+        size_t base = stack.size() - f.params;
+        calls.push_back({ ip + 1, fp, rp, base, false });
+        fp = base;
+        stack.resize(fp + f.locals);
+        JUMP(f.entry);
+    }
+    CASE(OP_CALL_METHOD) {
+        const FunctionInfo& f = functions[ip->arg];
+        size_t base = stack.size() - f.params - 1;
+        if (stack[base].type != VAL_OBJECT) {
+            stack.resize(base);
+            stack.emplace_back();
+            NEXT();
+        }
+        if (depth >= MAX_CALL_DEPTH) { reportCallDepth(f.name); return false; }
+        depth++;
+        calls.push_back({ ip + 1, fp, rp, base, false });
+        fp = base + 1;
+        rp = stack[base].obj->fields();
+        stack.resize(fp + f.locals);
+        JUMP(f.entry);
+    }
+    CASE(OP_NEW) {
+        const ClassInfo& c = classes[ip->arg];
+        Object* o = pools[ip->arg]->allocate();
+        stack.emplace_back(o);
+        if (c.init < 0) {
+            Value* fields = o->fields();
+            for (int k = 0; k < c.fields; k++) fields[k] = constants[c.defaults + k];
+            NEXT();
+        }
+        calls.push_back({ ip + 1, fp, rp, stack.size(), true });
+        fp = stack.size();
+        rp = o->fields();
+        JUMP(c.init);
+    }
+    //o eroare a unui tablou e afisata de array.cpp si opreste programul
+    CASE(OP_NEW_ARRAY) {
+        Value a;
+        if (!newArray((ValueType)ip->arg, TOP(), a)) return false;
+        TOP() = std::move(a);
+        NEXT();
+    }
+    CASE(OP_ARRAY_LITERAL) {
+        int count = ip->arg >> 2;
+        Value a = arrayLiteral((ValueType)(ip->arg & 3), stack.data() + stack.size() - count, count);
+        stack.resize(stack.size() - count);
+        stack.push_back(std::move(a));
+        NEXT();
+    }
+    CASE(OP_INDEX) {
+        Value i = std::move(stack.back());
+        POP();
+        Value v;
+        if (!arrayGet(TOP(), i, v)) return false;
+        TOP() = std::move(v);
+        NEXT();
+    }
+    CASE(OP_INDEX_UNCHECKED) {
+        int k = stack.back().i;
+        POP();
+        Value& a = TOP();
+        a = arrayElement(a.arr, k);
+        NEXT();
+    }
+    CASE(OP_SET_INDEX) {
+        Value v = std::move(stack.back());
+        POP();
+        Value i = std::move(stack.back());
+        POP();
+        if (!arraySet(TOP(), i, v)) return false;
+        TOP() = std::move(v);
+        NEXT();
+    }
+    CASE(OP_SET_INDEX_UNCHECKED) {
+        Value v = std::move(stack.back());
+        POP();
+        int k = stack.back().i;
+        POP();
+        setArrayElement(TOP().arr, k, v);
+        TOP() = std::move(v);
+        NEXT();
+    }
+    CASE(OP_ARRAY_LEN) {
+        Value& a = TOP();
+        a = arrayLength(a);
+        NEXT();
+    }
+    CASE(OP_ARRAY_REDUCE) {
+        Value b;
+        if (ip->arg == ARRAY_DOT) {
+            b = std::move(stack.back());
+            POP();
+        }
+        Value v;
+        if (!arrayReduce((ArrayFn)ip->arg, TOP(), b, v)) return false;
+        TOP() = std::move(v);
+        NEXT();
+    }
+    CASE(OP_ARRAY_ARITH) {
+        BINARY_PROLOGUE();
+        Value v;
+        if (!arrayArith((ArrayOp)ip->arg, l, r, v)) return false;
+        l = std::move(v);
+        NEXT();
+    }
+    CASE(OP_RETURN) {
+        const CallFrame& c = calls.back();
+        if (c.construct) stack.resize(c.base);
+        else {
+            Value result = std::move(stack.back());
+            stack.resize(c.base);
+            stack.push_back(std::move(result));
+            depth--;
+        }
+        ip = c.ret;
+        fp = c.fp;
+        rp = c.rp;
+        calls.pop_back();
+        DISPATCH();
+    }
+    CASE(OP_HALT) {
+        return true;
+    }
+
+#ifndef VM_COMPUTED_GOTO
+    default:
+        return false;
+    }
+#endif
+
+#undef TOP
+#undef POP
+#undef BINARY_PROLOGUE
+#undef TYPED_OPERANDS
+#undef TYPED_ARITH
+#undef TYPED_COMPARE
+#undef CASE
+#undef NEXT
+#undef JUMP
+#undef DISPATCH
+}
@@ -0,0 +1,31 @@
+#ifndef VM_H
+#define VM_H
+
+#include <iostream>
+#include <vector>
+#include "value.h"
+#include "bytecode.h"
+#include "output.h"
+
+//interpretorul de bytecode: globalele intr-un vector separat, localele lui main la baza stivei.
+//Un apel isi pune cadrul (obiectul pentru metode, apoi parametrii si localele) in varful aceleiasi stive;
+//campurile obiectului curent sunt in inregistrarea lui (rp), in afara stivei.
+class VM {
+    struct CallFrame {
+        const Instruction* ret;
+        size_t fp;
+        Value* rp;
+        size_t base;     //stiva apelantului revine la aceasta inaltime
+        bool construct;  //initializarea unui obiect nou: obiectul ramane pe stiva, rezultatul nu
+    };
+
+    std::vector<Value> stack;
+    std::vector<Value> globals;
+    std::vector<CallFrame> calls;
+
+public:
+    //false daca programul s-a oprit dintr-o eroare la executie
+    bool run(const Chunk& chunk, OutputSink& out = standardOutput());
+};
+
+#endif